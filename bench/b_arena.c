@@ -0,0 +1,115 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Short-lived strings and buffers: a copy of each one with `malloc()` (released one by
+// one with `free()`) against a copy in an arena (released all at once by resetting it).
+// Then the same "requests" of 1000 strings run by 1 to 16 threads at the same time, with
+// `malloc()` and with the arena of each thread.
+
+#include "valbuf.h"
+#include "bench.h"
+#include "bchval.h"
+#include <pthread.h>
+#include "valarena.h"
+
+#define MAXTHREADS 16
+#define REQUEST    1000
+
+static bchdata_t strs;
+static size_t    nreq;   // Requests for each thread
+
+static void *req_malloc(void *arg) {
+  (void)arg;
+  char *s[REQUEST];
+  for (size_t r = 0; r < nreq; r++) {
+    for (int i = 0; i < REQUEST; i++) {
+      const char *src = valtoptr(strs.v[(r * REQUEST + i) % strs.n]);
+      size_t len = strlen(src);
+      s[i] = malloc(len + 1);
+      memcpy(s[i], src, len + 1);
+    }
+    bchsink((uintptr_t)s[REQUEST - 1]);
+    for (int i = 0; i < REQUEST; i++) free(s[i]);
+  }
+  return NULL;
+}
+
+static void *req_arena(void *arg) {
+  (void)arg;
+  valarena_t a = valarenalocal();
+  for (size_t r = 0; r < nreq; r++) {
+    val_t v = valnil;
+    for (int i = 0; i < REQUEST; i++) v = valarenastr(a, valtoptr(strs.v[(r * REQUEST + i) % strs.n]));
+    bchsink(v.v);
+    valarenareset(a);
+  }
+  valarenalocalfree();
+  return NULL;
+}
+
+static void run(void *(*f)(void *), int nthreads) {
+  pthread_t th[MAXTHREADS];
+  for (int t = 0; t < nthreads; t++)
+    if (pthread_create(&th[t], NULL, f, NULL) != 0) { perror("pthread_create"); exit(1); }
+  for (int t = 0; t < nthreads; t++) pthread_join(th[t], NULL);
+}
+
+bchsuite("Arenas") {
+  size_t n = bch_size;
+  strs = bchdata(n, BCH_STR);
+
+  char **copy = malloc(n * sizeof(char *));
+  valbuf_t *bufs = malloc(n * sizeof(valbuf_t));
+  if (copy == NULL || bufs == NULL) { perror("malloc"); exit(1); }
+
+  bchrun("strings/malloc", n) {
+    for (size_t i = 0; i < n; i++) {
+      const char *src = valtoptr(strs.v[i]);
+      size_t len = strlen(src);
+      copy[i] = malloc(len + 1);
+      memcpy(copy[i], src, len + 1);
+    }
+    for (size_t i = 0; i < n; i++) { bchsink((uintptr_t)copy[i]); free(copy[i]); }
+  }
+
+  valarena_t a = valarenanew(0);
+  bchrun("strings/valarenastr", n) {
+    val_t v = valnil;
+    for (size_t i = 0; i < n; i++) v = valarenastr(a, valtoptr(strs.v[i]));
+    bchsink(v.v);
+    valarenareset(a);
+  }
+
+  bchrun("buffers/valbuffrom", n) {
+    for (size_t i = 0; i < n; i++) {
+      const char *src = valtoptr(strs.v[i]);
+      bufs[i] = valbuffrom(src, strlen(src));
+    }
+    for (size_t i = 0; i < n; i++) { bchsink((uintptr_t)bufs[i]); valbuffree(bufs[i]); }
+  }
+
+  bchrun("buffers/valarenabuf", n) {
+    val_t v = valnil;
+    for (size_t i = 0; i < n; i++) {
+      const char *src = valtoptr(strs.v[i]);
+      v = valarenabuf(a, src, strlen(src));
+    }
+    bchsink(v.v);
+    valarenareset(a);
+  }
+  valarenafree(a);
+
+  char name[64];
+  for (int t = 1; t <= MAXTHREADS; t *= 2) {
+    nreq = n / REQUEST;
+    snprintf(name, sizeof(name), "threads/%d/malloc", t);
+    bchrun(name, nreq * REQUEST * t) run(req_malloc, t);
+
+    snprintf(name, sizeof(name), "threads/%d/valarenalocal", t);
+    bchrun(name, nreq * REQUEST * t) run(req_arena, t);
+  }
+
+  free(bufs);
+  free(copy);
+  bchdatafree(&strs);
+}
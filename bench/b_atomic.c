@@ -0,0 +1,113 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Atomic values under contention, from 1 to 64 threads: `valatomicfetchadd()` (a CAS
+// loop on the number) against a hardware `atomic_fetch_add()` on an integer and against
+// a mutex, on a single shared counter and on one counter per thread (in its own cache
+// line); setting and clearing a mark bit of a shared pointer; swapping a shared cell.
+// Results are for the total number of operations (the time is wall-clock time).
+
+#include "bench.h"
+#include "bchval.h"
+#include <pthread.h>
+#include "valatomic.h"
+
+#define MAXTHREADS 64
+
+typedef struct {
+  valatomic_t v;
+  char pad[64 - sizeof(valatomic_t)];
+} padded_t;
+
+static valatomic_t      shared_val;
+static _Atomic int64_t  shared_int;
+static val_t            locked_val;
+static pthread_mutex_t  lock = PTHREAD_MUTEX_INITIALIZER;
+static padded_t         own[MAXTHREADS];
+static size_t           nops_thread;
+
+static void *add_val(void *arg) {
+  (void)arg;
+  for (size_t i = 0; i < nops_thread; i++) valatomicfetchadd(&shared_val, 1);
+  return NULL;
+}
+
+static void *add_int(void *arg) {
+  (void)arg;
+  for (size_t i = 0; i < nops_thread; i++) atomic_fetch_add_explicit(&shared_int, 1, memory_order_acq_rel);
+  return NULL;
+}
+
+static void *add_mutex(void *arg) {
+  (void)arg;
+  for (size_t i = 0; i < nops_thread; i++) {
+    pthread_mutex_lock(&lock);
+    locked_val = val(valtodouble(locked_val) + 1);
+    pthread_mutex_unlock(&lock);
+  }
+  return NULL;
+}
+
+static void *add_own(void *arg) {
+  valatomic_t *a = &own[(intptr_t)arg].v;
+  for (size_t i = 0; i < nops_thread; i++) valatomicfetchadd(a, 1);
+  return NULL;
+}
+
+static void *mark(void *arg) {
+  (void)arg;
+  for (size_t i = 0; i < nops_thread; i++) {
+    valatomicmark(&shared_val, 1);
+    valatomicunmark(&shared_val, 1);
+  }
+  return NULL;
+}
+
+static void *swap(void *arg) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < nops_thread; i++) sum += valatomicexchange(&shared_val, val((intptr_t)arg)).v;
+  bchsink(sum);
+  return NULL;
+}
+
+static void run(void *(*f)(void *), int nthreads) {
+  pthread_t th[MAXTHREADS];
+  for (intptr_t t = 0; t < nthreads; t++)
+    if (pthread_create(&th[t], NULL, f, (void *)t) != 0) { perror("pthread_create"); exit(1); }
+  for (int t = 0; t < nthreads; t++) pthread_join(th[t], NULL);
+}
+
+static void bench_threads(int nthreads) {
+  char name[64];
+  nops_thread = bch_size;
+  size_t nops = nops_thread * nthreads;
+
+  snprintf(name, sizeof(name), "shared/%d/valatomicfetchadd", nthreads);
+  valatomicinit(&shared_val, 0);
+  bchrun(name, nops) run(add_val, nthreads);
+
+  snprintf(name, sizeof(name), "shared/%d/atomic_fetch_add", nthreads);
+  atomic_init(&shared_int, 0);
+  bchrun(name, nops) run(add_int, nthreads);
+
+  snprintf(name, sizeof(name), "shared/%d/mutex", nthreads);
+  locked_val = val(0);
+  bchrun(name, nops) run(add_mutex, nthreads);
+
+  snprintf(name, sizeof(name), "own/%d/valatomicfetchadd", nthreads);
+  for (int t = 0; t < nthreads; t++) valatomicinit(&own[t].v, 0);
+  bchrun(name, nops) run(add_own, nthreads);
+
+  static char node[64];
+  snprintf(name, sizeof(name), "shared/%d/valatomicmark", nthreads);
+  valatomicinit(&shared_val, (valptr_0_t)(void *)node);
+  bchrun(name, 2 * nops) run(mark, nthreads);
+
+  snprintf(name, sizeof(name), "shared/%d/valatomicexchange", nthreads);
+  bchrun(name, nops) run(swap, nthreads);
+}
+
+bchsuite("Atomic values") {
+  bchnote("%ld cores", sysconf(_SC_NPROCESSORS_ONLN));
+  for (int t = 1; t <= MAXTHREADS; t *= 2) bench_threads(t);
+}
@@ -0,0 +1,113 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "bench.h"
+#include "bchval.h"
+#include "valbatch.h"
+
+bchsuite("Batch operations") {
+  size_t n = bch_size;
+
+  bchdata_t mixed = bchdata(n, BCH_MIXED);
+  bchshuffle(mixed.v, n);
+
+  bchdata_t keys = bchdata(n, BCH_NUMBERS | BCH_SYM | BCH_CONST);
+
+  uint8_t  *types  = malloc(n);
+  uint64_t *bits   = malloc(((n + 63) / 64) * sizeof(uint64_t));
+  uint32_t *hashes = malloc(n * sizeof(uint32_t));
+  if (!types || !bits || !hashes) { perror("malloc"); exit(1); }
+
+  bchnote("SIMD: %d bits", VAL_SIMD);
+
+  // ---- Classification
+
+  bchrun("classify/one-by-one", n) {
+    for (size_t i = 0; i < n; i++) {
+      val_t v = mixed.v[i];
+      types[i] = val_isnumber(v)     ? VALCLASS_NUMBER
+               : val_is_any_ptr(v)   ? (uint8_t)(valptrtype(v) >> 48)
+               : val_is_any_const(v) ? VALCLASS_CONST
+               :                       VALCLASS_EXT;
+    }
+  }
+  bchsink(types[n-1]);
+
+  bchrun("valclassify_n", n) {
+    valclassify_n(mixed.v, n, types);
+  }
+  bchsink(types[n-1]);
+
+  // ---- Bitmasks
+
+  bchrun("numbers/one-by-one", n) {
+    size_t cnt = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (val_isnumber(mixed.v[i])) { bits[i/64] |= (uint64_t)1 << (i%64); cnt++; }
+      else bits[i/64] &= ~((uint64_t)1 << (i%64));
+    }
+    bchsink(cnt);
+  }
+
+  bchrun("valmask_number_n", n) {
+    bchsink(valmask_number_n(mixed.v, n, bits));
+  }
+
+  bchrun("ptr/one-by-one", n) {
+    size_t cnt = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (val_is_any_ptr(mixed.v[i])) { bits[i/64] |= (uint64_t)1 << (i%64); cnt++; }
+      else bits[i/64] &= ~((uint64_t)1 << (i%64));
+    }
+    bchsink(cnt);
+  }
+
+  bchrun("valmask_ptr_n", n) {
+    bchsink(valmask_ptr_n(mixed.v, n, bits));
+  }
+
+  bchrun("sym/one-by-one", n) {
+    size_t cnt = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (val_issymconst_1(mixed.v[i])) { bits[i/64] |= (uint64_t)1 << (i%64); cnt++; }
+      else bits[i/64] &= ~((uint64_t)1 << (i%64));
+    }
+    bchsink(cnt);
+  }
+
+  bchrun("valmask_sym_n", n) {
+    bchsink(valmask_sym_n(mixed.v, n, bits));
+  }
+
+  bchrun("valmask_charptr_n", n) {
+    bchsink(valmask_charptr_n(mixed.v, n, bits));
+  }
+
+  // ---- Hashing
+
+  bchrun("val_hash/non-strings", n) {
+    for (size_t i = 0; i < n; i++) hashes[i] = val_hash(keys.v[i]);
+  }
+  bchsink(hashes[n-1]);
+
+  bchrun("valhash_n/non-strings", n) {
+    valhash_n(keys.v, n, hashes);
+  }
+  bchsink(hashes[n-1]);
+
+  bchrun("val_hash/mixed", n) {
+    for (size_t i = 0; i < n; i++) hashes[i] = val_hash(mixed.v[i]);
+  }
+  bchsink(hashes[n-1]);
+
+  bchrun("valhash_n/mixed", n) {
+    valhash_n(mixed.v, n, hashes);
+  }
+  bchsink(hashes[n-1]);
+
+  free(types);
+  free(bits);
+  free(hashes);
+  bchdatafree(&keys);
+  bchdatafree(&mixed);
+}
@@ -0,0 +1,186 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Ordered maps: the B+tree of `valbtree.h` against an AVL tree with a node allocated
+// for each key and `val_cmp()` as comparison, and against the hash map of `valmap.h`
+// (that has no range scans). Insert, point lookup, range scans of 100 keys and bulk
+// loading, on numbers and on mixed values.
+
+#include "bench.h"
+#include "bchval.h"
+#include "valmap.h"
+#include "valsort.h"
+#include "valbtree.h"
+
+// ==== AVL tree (one malloc per node)
+
+typedef struct avl_s {
+  val_t key, val;
+  struct avl_s *left, *right;
+  int height;
+} avl_t;
+
+static int avl_h(avl_t *n) { return n ? n->height : 0; }
+
+static avl_t *avl_fix(avl_t *n) {
+  int hl = avl_h(n->left), hr = avl_h(n->right);
+  n->height = 1 + (hl > hr ? hl : hr);
+  return n;
+}
+
+static avl_t *avl_rotr(avl_t *n) { avl_t *l = n->left;  n->left  = l->right; l->right = avl_fix(n); return avl_fix(l); }
+static avl_t *avl_rotl(avl_t *n) { avl_t *r = n->right; n->right = r->left;  r->left  = avl_fix(n); return avl_fix(r); }
+
+static avl_t *avl_balance(avl_t *n) {
+  avl_fix(n);
+  int b = avl_h(n->left) - avl_h(n->right);
+  if (b > 1) {
+    if (avl_h(n->left->left) < avl_h(n->left->right)) n->left = avl_rotl(n->left);
+    return avl_rotr(n);
+  }
+  if (b < -1) {
+    if (avl_h(n->right->right) < avl_h(n->right->left)) n->right = avl_rotr(n->right);
+    return avl_rotl(n);
+  }
+  return n;
+}
+
+static avl_t *avl_set(avl_t *n, val_t k, val_t v) {
+  if (n == NULL) {
+    n = malloc(sizeof(avl_t));
+    if (n == NULL) { perror("malloc"); exit(1); }
+    n->key = k; n->val = v; n->left = n->right = NULL; n->height = 1;
+    return n;
+  }
+  int c = val_cmp(k, n->key);
+  if (c == 0) { n->val = v; return n; }
+  if (c < 0) n->left = avl_set(n->left, k, v);
+  else n->right = avl_set(n->right, k, v);
+  return avl_balance(n);
+}
+
+static avl_t *avl_get(avl_t *n, val_t k) {
+  while (n) {
+    int c = val_cmp(k, n->key);
+    if (c == 0) return n;
+    n = (c < 0) ? n->left : n->right;
+  }
+  return NULL;
+}
+
+// Visits up to `cnt` keys from the first one not lower than `k`. Returns the number left.
+static int avl_scan(avl_t *n, val_t k, int cnt, uint64_t *sum) {
+  if (n == NULL || cnt == 0) return cnt;
+  if (val_cmp(n->key, k) >= 0) {
+    cnt = avl_scan(n->left, k, cnt, sum);
+    if (cnt == 0) return 0;
+    *sum += n->val.v;
+    cnt--;
+  }
+  return avl_scan(n->right, k, cnt, sum);
+}
+
+static void avl_free(avl_t *n) {
+  if (n) { avl_free(n->left); avl_free(n->right); free(n); }
+}
+
+// ====
+
+static void bench_maps(const char *set, int types, size_t n) {
+  char name[64];
+
+  bchdata_t data = bchdata(n, types);
+  bchshuffle(data.v, n);
+
+  snprintf(name, sizeof(name), "%s/insert/valbtree", set);
+  valbtree_t t = NULL;
+  bchrun(name, n) {
+    valbtreefree(t);
+    t = valbtreenew();
+    for (size_t i = 0; i < n; i++) valbtree_set(t, data.v[i], val(i));
+  }
+
+  snprintf(name, sizeof(name), "%s/insert/avl", set);
+  avl_t *avl = NULL;
+  bchrun(name, n) {
+    avl_free(avl);
+    avl = NULL;
+    for (size_t i = 0; i < n; i++) avl = avl_set(avl, data.v[i], val(i));
+  }
+
+  snprintf(name, sizeof(name), "%s/insert/valmap", set);
+  valmap_t m = NULL;
+  bchrun(name, n) {
+    valmapfree(m);
+    m = valmapnew(VALMAP_SEMANTIC);
+    for (size_t i = 0; i < n; i++) valmap_set(m, data.v[i], val(i));
+  }
+
+  // Lookups in random order
+  bchshuffle(data.v, n);
+
+  snprintf(name, sizeof(name), "%s/lookup/valbtree", set);
+  bchrun(name, n) {
+    for (size_t i = 0; i < n; i++) bchsink(valbtree_ref(t, data.v[i])->v);
+  }
+
+  snprintf(name, sizeof(name), "%s/lookup/avl", set);
+  bchrun(name, n) {
+    for (size_t i = 0; i < n; i++) bchsink(avl_get(avl, data.v[i])->val.v);
+  }
+
+  snprintf(name, sizeof(name), "%s/lookup/valmap", set);
+  bchrun(name, n) {
+    for (size_t i = 0; i < n; i++) bchsink(valmap_ref(m, data.v[i])->v);
+  }
+
+  // Range scans (100 keys from a random key)
+  size_t nscan = n / 100;
+
+  snprintf(name, sizeof(name), "%s/scan100/valbtree", set);
+  bchrun(name, nscan * 100) {
+    for (size_t i = 0; i < nscan; i++) {
+      valbtree_iter_t it = valbtree_seek(t, data.v[i]);
+      val_t v;
+      for (int j = 0; j < 100 && valbtreenext(&it, NULL, &v); j++) bchsink(v.v);
+    }
+  }
+
+  snprintf(name, sizeof(name), "%s/scan100/avl", set);
+  bchrun(name, nscan * 100) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < nscan; i++) avl_scan(avl, data.v[i], 100, &sum);
+    bchsink(sum);
+  }
+
+  // Bulk loading (sorted keys)
+  val_t *sorted = malloc(n * sizeof(val_t));
+  if (sorted == NULL) { perror("malloc"); exit(1); }
+  memcpy(sorted, data.v, n * sizeof(val_t));
+  valsort(sorted, n);
+
+  snprintf(name, sizeof(name), "%s/load/valbtreeload", set);
+  bchrun(name, n) {
+    valbtreefree(t);
+    t = valbtreenew();
+    valbtreeload(t, sorted, NULL, n);
+  }
+
+  snprintf(name, sizeof(name), "%s/load/valbtreeset", set);
+  bchrun(name, n) {
+    valbtreefree(t);
+    t = valbtreenew();
+    for (size_t i = 0; i < n; i++) valbtree_set(t, sorted[i], valnil);
+  }
+
+  free(sorted);
+  valbtreefree(t);
+  avl_free(avl);
+  valmapfree(m);
+  bchdatafree(&data);
+}
+
+bchsuite("Ordered maps") {
+  bench_maps("numbers", BCH_NUMBERS, bch_size);
+  bench_maps("mixed", BCH_MIXED, bch_size);
+}
@@ -0,0 +1,122 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Concurrent maps: the map of `valcmap.h` against the hash map of `valmap.h`
+// behind a mutex, from 1 to 64 threads. Each thread adds its share of the keys (the
+// map grows while the threads are running), then does lookups mixed with 10% updates.
+// Results are for the total number of operations (the time is wall-clock time).
+
+#include "bench.h"
+#include "bchval.h"
+#include <pthread.h>
+#include "valmap.h"
+#include "valcmap.h"
+
+#define MAXTHREADS 64
+
+typedef struct {
+  val_t    *keys;
+  size_t    n;       // Keys for each thread
+  int       id;
+  int       nthreads;
+  valcmap_t cm;
+  valmap_t  m;
+} job_t;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void *cmap_insert(void *arg) {
+  job_t *j = arg;
+  val_t *k = j->keys + j->id * j->n;
+  for (size_t i = 0; i < j->n; i++) valcmap_set(j->cm, k[i], val(i));
+  return NULL;
+}
+
+static void *mutex_insert(void *arg) {
+  job_t *j = arg;
+  val_t *k = j->keys + j->id * j->n;
+  for (size_t i = 0; i < j->n; i++) {
+    pthread_mutex_lock(&lock);
+    valmap_set(j->m, k[i], val(i));
+    pthread_mutex_unlock(&lock);
+  }
+  return NULL;
+}
+
+// Lookups of all the keys (starting from a different one in each thread), one in ten is an update
+static void *cmap_mixed(void *arg) {
+  job_t *j = arg;
+  size_t total = j->n * j->nthreads;
+  uint64_t sum = 0;
+  for (size_t i = 0, p = j->id * j->n; i < j->n; i++, p = (p + 7919) % total) {
+    if (i % 10 == 0) valcmap_set(j->cm, j->keys[p], val(i));
+    else sum += valcmap_get(j->cm, j->keys[p], valnil).v;
+  }
+  bchsink(sum);
+  return NULL;
+}
+
+static void *mutex_mixed(void *arg) {
+  job_t *j = arg;
+  size_t total = j->n * j->nthreads;
+  uint64_t sum = 0;
+  for (size_t i = 0, p = j->id * j->n; i < j->n; i++, p = (p + 7919) % total) {
+    pthread_mutex_lock(&lock);
+    if (i % 10 == 0) valmap_set(j->m, j->keys[p], val(i));
+    else sum += valmap_get(j->m, j->keys[p], valnil).v;
+    pthread_mutex_unlock(&lock);
+  }
+  bchsink(sum);
+  return NULL;
+}
+
+static void run(void *(*f)(void *), job_t *proto, int nthreads) {
+  pthread_t th[MAXTHREADS];
+  job_t job[MAXTHREADS];
+  for (int t = 0; t < nthreads; t++) {
+    job[t] = *proto;
+    job[t].id = t;
+    job[t].nthreads = nthreads;
+    if (pthread_create(&th[t], NULL, f, &job[t]) != 0) { perror("pthread_create"); exit(1); }
+  }
+  for (int t = 0; t < nthreads; t++) pthread_join(th[t], NULL);
+}
+
+static void bench_threads(const char *set, int types, int nthreads) {
+  char name[64];
+  size_t n = bch_size;
+
+  bchdata_t data = bchdata(n, types);
+  job_t job = {data.v, n / nthreads, 0, nthreads, NULL, NULL};
+  size_t nops = job.n * nthreads;
+
+  snprintf(name, sizeof(name), "%s/insert/%d/valcmap", set, nthreads);
+  bchrun(name, nops) {
+    valcmapfree(job.cm);
+    job.cm = valcmapnew(VALMAP_SEMANTIC);
+    run(cmap_insert, &job, nthreads);
+  }
+
+  snprintf(name, sizeof(name), "%s/insert/%d/mutex", set, nthreads);
+  bchrun(name, nops) {
+    valmapfree(job.m);
+    job.m = valmapnew(VALMAP_SEMANTIC);
+    run(mutex_insert, &job, nthreads);
+  }
+
+  snprintf(name, sizeof(name), "%s/mixed/%d/valcmap", set, nthreads);
+  bchrun(name, nops) run(cmap_mixed, &job, nthreads);
+
+  snprintf(name, sizeof(name), "%s/mixed/%d/mutex", set, nthreads);
+  bchrun(name, nops) run(mutex_mixed, &job, nthreads);
+
+  valcmapfree(job.cm);
+  valmapfree(job.m);
+  bchdatafree(&data);
+}
+
+bchsuite("Concurrent maps") {
+  bchnote("%ld cores", sysconf(_SC_NPROCESSORS_ONLN));
+  for (int t = 1; t <= MAXTHREADS; t *= 2) bench_threads("numbers", BCH_NUMBERS, t);
+  for (int t = 1; t <= MAXTHREADS; t *= 2) bench_threads("mixed", BCH_MIXED, t);
+}
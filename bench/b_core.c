@@ -0,0 +1,133 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "bench.h"
+#include "bchval.h"
+
+bchsuite("Core primitives") {
+  size_t n = bch_size;
+
+  bchdata_t mixed   = bchdata(n, BCH_MIXED);
+  bchdata_t numbers = bchdata(n, BCH_NUMBERS);
+  bchdata_t strings = bchdata(n, BCH_STRINGS);
+  bchdata_t syms    = bchdata(n, BCH_SYM);
+
+  char  *heap;
+  char **tokens = bchstrings(n, 8, &heap);
+
+  int64_t *ints = malloc(n * sizeof(int64_t));
+  double  *dbls = malloc(n * sizeof(double));
+  val_t   *out  = malloc(n * sizeof(val_t));
+  if (!ints || !dbls || !out) { perror("malloc"); exit(1); }
+
+  for (size_t i = 0; i < n; i++) {
+    ints[i] = (int64_t)(bchrand() >> 33);
+    dbls[i] = (double)ints[i] / 7.0;
+  }
+
+  // ---- Constructors
+
+  bchrun("val(int)", n) {
+    for (size_t i = 0; i < n; i++) out[i] = val(ints[i]);
+  }
+  bchsink(out[n-1].v);
+
+  bchrun("val(double)", n) {
+    for (size_t i = 0; i < n; i++) out[i] = val(dbls[i]);
+  }
+  bchsink(out[n-1].v);
+
+  bchrun("val(char*)", n) {
+    for (size_t i = 0; i < n; i++) out[i] = val(tokens[i]);
+  }
+  bchsink(out[n-1].v);
+
+  // ---- Type checks
+
+  bchrun("val_isint/numbers", n) {
+    size_t cnt = 0;
+    for (size_t i = 0; i < n; i++) cnt += val_isint(numbers.v[i]);
+    bchsink(cnt);
+  }
+
+  bchrun("val_isint/mixed", n) {
+    size_t cnt = 0;
+    for (size_t i = 0; i < n; i++) cnt += val_isint(mixed.v[i]);
+    bchsink(cnt);
+  }
+
+  // ---- Comparison (each element against a "random" other one)
+
+  bchrun("val_cmp/numbers", n) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += val_cmp(numbers.v[i], numbers.v[(i * 7919) % n]);
+    bchsink(acc);
+  }
+
+  bchrun("val_cmp/strings", n) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += val_cmp(strings.v[i], strings.v[(i * 7919) % n]);
+    bchsink(acc);
+  }
+
+  bchrun("val_cmp/mixed", n) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += val_cmp(mixed.v[i], mixed.v[(i * 7919) % n]);
+    bchsink(acc);
+  }
+
+  // ---- Hashing
+
+  bchrun("val_hash/numbers", n) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < n; i++) h ^= val_hash(numbers.v[i]);
+    bchsink(h);
+  }
+
+  bchrun("val_hash/strings", n) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < n; i++) h ^= val_hash(strings.v[i]);
+    bchsink(h);
+  }
+
+  bchrun("val_hash/mixed", n) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < n; i++) h ^= val_hash(mixed.v[i]);
+    bchsink(h);
+  }
+
+  // ---- Symbols
+
+  bchrun("valsymconst", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc ^= valsymconst(tokens[i]).v;
+    bchsink(acc);
+  }
+
+  bchrun("valsymtostr", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += (uint8_t)valsymtostr(syms.v[i]).str[1];
+    bchsink(acc);
+  }
+
+  // ---- String conversion
+
+  bchrun("val_tostr_2/numbers", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += (uint8_t)val_tostr_2(numbers.v[i], NULL).str[0];
+    bchsink(acc);
+  }
+
+  bchrun("val_tostr_2/mixed", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += (uint8_t)val_tostr_2(mixed.v[i], NULL).str[0];
+    bchsink(acc);
+  }
+
+  free(ints); free(dbls); free(out);
+  free(tokens); free(heap);
+  bchdatafree(&mixed);
+  bchdatafree(&numbers);
+  bchdatafree(&strings);
+  bchdatafree(&syms);
+}
@@ -0,0 +1,66 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Garbage collection pauses against the size of the heap: a full collection with
+// `valgccollect()` (the pause is the time per op, as each op is a collection) and
+// the steps of an incremental collection with `valgcstep()` and a budget of 1000
+// objects (the pause is the time per step). The heap is a graph of nodes with two
+// links each, all reachable from a single root, so that every collection traces and
+// sweeps the whole heap and frees nothing.
+
+#include "bench.h"
+#include "bchval.h"
+#include "valgc.h"
+
+typedef struct valptr_2_s { val_t link[2]; } *node_t;
+
+static void node_trace(valgc_t gc, void *p) {
+  node_t nd = p;
+  valgcmark(gc, nd->link[0]);
+  valgcmark(gc, nd->link[1]);
+}
+
+static void bench_heap(size_t n) {
+  char name[64];
+
+  valgc_t gc = valgcnew();
+  if (gc == NULL) { perror("valgcnew"); exit(1); }
+  valgctype(gc, VALPTR_2, node_trace, free);
+
+  // Node i is linked from node (i-1)/2 (a tree, so all are reachable) and from a random node
+  node_t *nodes = malloc(n * sizeof(node_t));
+  if (nodes == NULL) { perror("malloc"); exit(1); }
+  for (size_t i = 0; i < n; i++) {
+    nodes[i] = malloc(sizeof(struct valptr_2_s));
+    if (nodes[i] == NULL || valisnil(valgcadd(gc, nodes[i]))) { perror("valgcadd"); exit(1); }
+    nodes[i]->link[0] = nodes[i]->link[1] = valnil;
+  }
+  for (size_t i = 1; i < n; i++) {
+    nodes[(i - 1) / 2]->link[(i - 1) % 2] = val(nodes[i]);
+    if (i % 2) nodes[i]->link[1] = val(nodes[bchrand() % n]);
+  }
+  val_t root = val(nodes[0]);
+  valgcroot(gc, &root);
+  free(nodes);
+
+  snprintf(name, sizeof(name), "collect/%zu", n);
+  bchrun(name, 1) bchsink(valgccollect(gc));
+
+  size_t steps = 1;
+  while (!valgcstep(gc, 1000)) steps++;
+
+  snprintf(name, sizeof(name), "step1000/%zu", n);
+  bchrun(name, steps) {
+    while (!valgcstep(gc, 1000)) ;
+  }
+
+  if (valgccount(gc) != n) { fprintf(stderr, "Objects released: %zu\n", n - valgccount(gc)); exit(1); }
+  valgcfree(gc);
+}
+
+bchsuite("Garbage collection") {
+  bench_heap(bch_size / 64);
+  bench_heap(bch_size / 8);
+  bench_heap(bch_size);
+  bench_heap(bch_size * 8);
+}
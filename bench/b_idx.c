@@ -0,0 +1,82 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Lookups in sorted arrays: binary search with `val_cmp()`, `valbsearch()` and the
+// Eytzinger index of `validx.h` (one query at a time and interleaved), on arrays that
+// fit in the cache and on arrays that don't.
+
+#include "bench.h"
+#include "bchval.h"
+#include "valsort.h"
+#include "validx.h"
+
+static size_t lower_valcmp(const val_t *a, size_t n, val_t x) {
+  size_t lo = 0, hi = n;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (val_cmp(a[mid], x) < 0) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+static void bench_lookup(const char *set, int types, size_t n, size_t nq) {
+  char name[64];
+
+  bchdata_t data = bchdata(n, types);
+  valsort(data.v, n);
+
+  // Queries: values in the array, in random order
+  val_t  *q   = malloc(nq * sizeof(val_t));
+  size_t *pos = malloc(nq * sizeof(size_t));
+  if (q == NULL || pos == NULL) { perror("malloc"); exit(1); }
+  for (size_t i = 0; i < nq; i++) q[i] = data.v[bchrand() % n];
+
+  validx_t ix = validxnew(data.v, n);
+  if (ix == NULL) { perror("validxnew"); exit(1); }
+
+  snprintf(name, sizeof(name), "%s/%zu/valcmp", set, n);
+  bchrun(name, nq) {
+    for (size_t i = 0; i < nq; i++) bchsink(lower_valcmp(data.v, n, q[i]));
+  }
+
+  snprintf(name, sizeof(name), "%s/%zu/valbsearch", set, n);
+  bchrun(name, nq) {
+    for (size_t i = 0; i < nq; i++) bchsink(valbsearch(data.v, n, q[i]));
+  }
+
+  snprintf(name, sizeof(name), "%s/%zu/validxlower", set, n);
+  bchrun(name, nq) {
+    for (size_t i = 0; i < nq; i++) bchsink(validxlower(ix, q[i]));
+  }
+
+  snprintf(name, sizeof(name), "%s/%zu/validxlower_n", set, n);
+  bchrun(name, nq) {
+    validxlower_n(ix, q, nq, pos);
+    bchsink(pos[nq - 1]);
+  }
+
+  validxfree(ix);
+  free(pos);
+  free(q);
+  bchdatafree(&data);
+}
+
+bchsuite("Search index") {
+  size_t n  = bch_size;
+  size_t nq = bch_size;
+
+  bchdata_t data = bchdata(n, BCH_NUMBERS);
+  valsort(data.v, n);
+  bchrun("validxnew", n) {
+    validx_t ix = validxnew(data.v, n);
+    bchsink(ix->keys[1]);
+    validxfree(ix);
+  }
+  bchdatafree(&data);
+
+  bench_lookup("numbers", BCH_NUMBERS, n, nq);
+  bench_lookup("numbers", BCH_NUMBERS, n * 64, nq);
+  bench_lookup("mixed", BCH_MIXED, n, nq);
+  bench_lookup("mixed", BCH_MIXED, n * 64, nq);
+}
@@ -0,0 +1,80 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Integer-heavy workloads. Build with XFLAGS=-DVALNATIVEINT to compare
+// integers boxed as doubles with the native 32-bit integers.
+
+#include "bench.h"
+#include "bchval.h"
+
+bchsuite("Integers") {
+  size_t n = bch_size;
+
+  int32_t *ints = malloc(n * sizeof(int32_t));
+  val_t   *vals = malloc(n * sizeof(val_t));
+  val_t   *dbls = malloc(n * sizeof(val_t));
+  if (!ints || !vals || !dbls) { perror("malloc"); exit(1); }
+
+  for (size_t i = 0; i < n; i++) {
+    ints[i] = (int32_t)(bchrand() >> 40) - (1 << 23);
+    vals[i] = val(ints[i]);
+    dbls[i] = val((double)ints[i]);
+  }
+
+#ifdef VALNATIVEINT
+  bchnote("Native 32-bit integers");
+#else
+  bchnote("Integers as doubles");
+#endif
+
+  bchrun("box", n) {
+    for (size_t i = 0; i < n; i++) vals[i] = val(ints[i]);
+  }
+  bchsink(vals[n-1].v);
+
+  bchrun("unbox", n) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += valtoint(vals[i]);
+    bchsink(acc);
+  }
+
+  // A boxed loop counter
+  bchrun("counter", n) {
+    val_t c = val(0);
+    for (size_t i = 0; i < n; i++) c = val(valtoint(c) + 1);
+    bchsink(c.v);
+  }
+
+  // Indexing an array with boxed indexes
+  bchrun("index", n) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += ints[valtoint(vals[i]) & (int64_t)(n - 1)];
+    bchsink(acc);
+  }
+
+  bchrun("valisint", n) {
+    size_t cnt = 0;
+    for (size_t i = 0; i < n; i++) cnt += valisint(vals[i]);
+    bchsink(cnt);
+  }
+
+  bchrun("valcmp/int-int", n) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += valcmp(vals[i], vals[(i * 7919) % n]);
+    bchsink(acc);
+  }
+
+  bchrun("valcmp/int-double", n) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += valcmp(vals[i], dbls[(i * 7919) % n]);
+    bchsink(acc);
+  }
+
+  bchrun("valhash", n) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < n; i++) h ^= valhash(vals[i]);
+    bchsink(h);
+  }
+
+  free(ints); free(vals); free(dbls);
+}
@@ -0,0 +1,85 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Repeated keys (like field names) as `char *` and as interned strings.
+
+#include "valintern.h"
+#include "bench.h"
+#include "bchval.h"
+
+bchsuite("Interned strings") {
+  size_t n = bch_size;
+
+  // A few distinct keys, each one appearing many times as a different copy
+  static const char *fields[] = {"identifier", "name", "description", "created_at", "updated_at",
+                                 "owner", "permissions", "size", "parent_identifier", "type"};
+  size_t nf = sizeof(fields) / sizeof(fields[0]);
+
+  char   *heap  = malloc(n * 32);
+  val_t  *strs  = malloc(n * sizeof(val_t));
+  val_t  *ints  = malloc(n * sizeof(val_t));
+  if (!heap || !strs || !ints) { perror("malloc"); exit(1); }
+
+  valpool_t pool = valpoolnew();
+  for (size_t i = 0; i < n; i++) {
+    char *s = heap + i * 32;
+    strcpy(s, fields[bchrand() % nf]);
+    strs[i] = val(s);
+    ints[i] = valintern(pool, s);
+  }
+
+  bchrun("valcmp/char*", n) {
+    int64_t acc = 0;
+    for (size_t i = 0, j = 0; i < n; i++) {
+      acc += (valcmp(strs[i], strs[j]) == 0);
+      for (j += 7919; j >= n; j -= n) ;
+    }
+    bchsink(acc);
+  }
+
+  bchrun("valcmp/interned", n) {
+    int64_t acc = 0;
+    for (size_t i = 0, j = 0; i < n; i++) {
+      acc += (valcmp(ints[i], ints[j]) == 0);
+      for (j += 7919; j >= n; j -= n) ;
+    }
+    bchsink(acc);
+  }
+
+  bchrun("valhash/char*", n) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < n; i++) h ^= valhash(strs[i]);
+    bchsink(h);
+  }
+
+  bchrun("valhash/interned", n) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < n; i++) h ^= valhash(ints[i]);
+    bchsink(h);
+  }
+
+  valmap_t m = valmapnew(VALMAP_SEMANTIC);
+  for (size_t k = 0; k < nf; k++) valmapset(m, valintern(pool, fields[k]), k);
+
+  bchrun("valmap/char*", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += valmapref(m, strs[i])->v;
+    bchsink(acc);
+  }
+
+  bchrun("valmap/interned", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += valmapref(m, ints[i])->v;
+    bchsink(acc);
+  }
+
+  bchrun("valintern", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc ^= valintern(pool, heap + i * 32).v;
+    bchsink(acc);
+  }
+
+  valmapfree(m);
+  valpoolfree(pool);
+  free(heap); free(strs); free(ints);
+}
@@ -0,0 +1,75 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "bench.h"
+#include "bchval.h"
+#include "valbatch.h"
+
+// The previous implementation of val_isint(), kept for comparison
+static inline int old_isint(val_t v) {
+  int      exp_bits  = (int)((v.v >> 52) & 0x7FF);
+  uint64_t frac_bits = v.v & ((((uint64_t)1) << 52) - 1);
+  if (exp_bits == 0)     return (frac_bits == 0);
+  if (exp_bits == 0x7FF) return 0;
+  int e = exp_bits - 1023;
+  if (e < 0)   return 0;
+  if (e >= 52) return 1;
+  return ((frac_bits & ((((uint64_t)1) << (52 - e)) - 1)) == 0);
+}
+
+bchsuite("Integer checks") {
+  size_t n = bch_size;
+
+  // Random doubles of all magnitudes are mostly integers (|v| ≥ 2^52) or tiny fractions:
+  // mixing integers and fractions of similar magnitude makes the branches unpredictable.
+  val_t *sets[3];
+  const char *names[3] = {"random", "ints", "fracs"};
+  for (int k = 0; k < 3; k++) {
+    sets[k] = malloc(n * sizeof(val_t));
+    if (!sets[k]) { perror("malloc"); exit(1); }
+  }
+  for (size_t i = 0; i < n; i++) {
+    uint64_t r = bchrand();
+    double   d = (double)(int64_t)(r >> 24) / ((r & 0x10) ? 1.0 : 8.0);
+    switch ((r >> 5) % 4) {
+      case 0:  sets[0][i].v = r | 1; break;                     // Any bit pattern
+      case 1:  sets[0][i] = val(d); break;                      // Integer or not
+      case 2:  sets[0][i] = val((double)(r >> 40) / 1e9); break; // |v| < 1 and subnormals
+      default: sets[0][i] = val((double)(int64_t)r); break;     // Large integers
+    }
+    sets[1][i] = val((double)(int64_t)(r >> 20) - (double)(1 << 20));
+    sets[2][i] = val((double)(int64_t)(r >> 20) + 0.25);
+  }
+
+  uint64_t *bits = malloc(((n + 63) / 64) * sizeof(uint64_t));
+  if (!bits) { perror("malloc"); exit(1); }
+
+  bchnote("SIMD: %d bits", VAL_SIMD);
+
+  for (int k = 0; k < 3; k++) {
+    val_t *v = sets[k];
+    char name[64];
+
+    snprintf(name, sizeof(name), "old_isint/%s", names[k]);
+    bchrun(name, n) {
+      size_t cnt = 0;
+      for (size_t i = 0; i < n; i++) cnt += old_isint(v[i]);
+      bchsink(cnt);
+    }
+
+    snprintf(name, sizeof(name), "val_isint/%s", names[k]);
+    bchrun(name, n) {
+      size_t cnt = 0;
+      for (size_t i = 0; i < n; i++) cnt += val_isint(v[i]);
+      bchsink(cnt);
+    }
+
+    snprintf(name, sizeof(name), "valisint_n/%s", names[k]);
+    bchrun(name, n) {
+      bchsink(valisint_n(v, n, bits));
+    }
+  }
+
+  free(bits);
+  for (int k = 0; k < 3; k++) free(sets[k]);
+}
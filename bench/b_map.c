@@ -0,0 +1,200 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// valmap_t against a naive chained hash table built on valhash() and valcmp().
+//
+// The maps are measured with 1K and 1M keys. Use `-n` with more than 1M elements
+// to add a run of that size (e.g. `-n 100000000`, which needs about 6GB of memory).
+
+#include "bench.h"
+#include "bchval.h"
+#include "valmap.h"
+
+// ==== Chained table (one malloc'd node per key)
+
+typedef struct chain_node_s {
+  val_t key;
+  val_t val;
+  struct chain_node_s *next;
+} chain_node_t;
+
+typedef struct {
+  chain_node_t **bucket;
+  size_t nbuckets;
+  size_t count;
+} chain_t;
+
+static chain_t chain_new(void) {
+  chain_t t = {calloc(16, sizeof(chain_node_t *)), 16, 0};
+  if (t.bucket == NULL) { perror("chain"); exit(1); }
+  return t;
+}
+
+static void chain_free(chain_t *t) {
+  for (size_t b = 0; b < t->nbuckets; b++)
+    for (chain_node_t *n = t->bucket[b], *next; n; n = next) { next = n->next; free(n); }
+  free(t->bucket);
+}
+
+static chain_node_t *chain_find(chain_t *t, val_t k) {
+  for (chain_node_t *n = t->bucket[valhash(k) & (t->nbuckets - 1)]; n; n = n->next)
+    if (valcmp(n->key, k) == 0) return n;
+  return NULL;
+}
+
+static void chain_set(chain_t *t, val_t k, val_t v) {
+  chain_node_t *n = chain_find(t, k);
+  if (n) { n->val = v; return; }
+
+  if (t->count >= t->nbuckets) {
+    size_t nb = t->nbuckets * 2;
+    chain_node_t **bucket = calloc(nb, sizeof(chain_node_t *));
+    if (bucket == NULL) { perror("chain"); exit(1); }
+    for (size_t b = 0; b < t->nbuckets; b++)
+      for (chain_node_t *p = t->bucket[b], *next; p; p = next) {
+        next = p->next;
+        size_t h = valhash(p->key) & (nb - 1);
+        p->next = bucket[h];
+        bucket[h] = p;
+      }
+    free(t->bucket);
+    t->bucket = bucket;
+    t->nbuckets = nb;
+  }
+
+  n = malloc(sizeof(chain_node_t));
+  if (n == NULL) { perror("chain"); exit(1); }
+  size_t h = valhash(k) & (t->nbuckets - 1);
+  n->key = k;
+  n->val = v;
+  n->next = t->bucket[h];
+  t->bucket[h] = n;
+  t->count++;
+}
+
+// ====
+
+static void bench_size(size_t n) {
+  char name[64];
+  const char *sz = (n >= 1000000) ? "M" : "K";
+  size_t      sn = (n >= 1000000) ? n / 1000000 : n / 1000;
+
+  // Small tables are looked up many times to have measurable times
+  size_t rounds = (n < 1000000) ? 1000000 / n : 1;
+
+  // Distinct integer keys (multiplying by an odd number is a bijection on 32 bits)
+  val_t *keys   = malloc(n * sizeof(val_t));
+  val_t *misses = malloc(n * sizeof(val_t));
+  if (!keys || !misses) { perror("malloc"); exit(1); }
+  for (size_t i = 0; i < n; i++) {
+    keys[i]   = val((uint32_t)(i * 0x9E3779B1u));
+    misses[i] = val((uint32_t)((i + n) * 0x9E3779B1u));
+  }
+
+  bchnote("%zu%s keys", sn, sz);
+
+  // ---- Integer keys
+
+  snprintf(name, sizeof(name), "chained/insert/%zu%s", sn, sz);
+  bchrun(name, n) {
+    chain_t t = chain_new();
+    for (size_t i = 0; i < n; i++) chain_set(&t, keys[i], val(i));
+    bchsink(t.count);
+    chain_free(&t);
+  }
+
+  snprintf(name, sizeof(name), "valmap/insert/%zu%s", sn, sz);
+  bchrun(name, n) {
+    valmap_t m = valmapnew(VALMAP_IDENTITY);
+    for (size_t i = 0; i < n; i++) valmapset(m, keys[i], i);
+    bchsink(valmapcount(m));
+    valmapfree(m);
+  }
+
+  chain_t  t = chain_new();
+  valmap_t m = valmapnew(VALMAP_IDENTITY);
+  for (size_t i = 0; i < n; i++) { chain_set(&t, keys[i], val(i)); valmapset(m, keys[i], i); }
+  bchshuffle(keys, n);
+
+  snprintf(name, sizeof(name), "chained/hit/%zu%s", sn, sz);
+  bchrun(name, n * rounds) {
+    uint64_t acc = 0;
+    for (size_t r = 0; r < rounds; r++)
+      for (size_t i = 0; i < n; i++) acc += chain_find(&t, keys[i])->val.v;
+    bchsink(acc);
+  }
+
+  snprintf(name, sizeof(name), "valmap/hit/%zu%s", sn, sz);
+  bchrun(name, n * rounds) {
+    uint64_t acc = 0;
+    for (size_t r = 0; r < rounds; r++)
+      for (size_t i = 0; i < n; i++) acc += valmapref(m, keys[i])->v;
+    bchsink(acc);
+  }
+
+  snprintf(name, sizeof(name), "chained/miss/%zu%s", sn, sz);
+  bchrun(name, n * rounds) {
+    size_t cnt = 0;
+    for (size_t r = 0; r < rounds; r++)
+      for (size_t i = 0; i < n; i++) cnt += (chain_find(&t, misses[i]) != NULL);
+    bchsink(cnt);
+  }
+
+  snprintf(name, sizeof(name), "valmap/miss/%zu%s", sn, sz);
+  bchrun(name, n * rounds) {
+    size_t cnt = 0;
+    for (size_t r = 0; r < rounds; r++)
+      for (size_t i = 0; i < n; i++) cnt += valmaphas(m, misses[i]);
+    bchsink(cnt);
+  }
+
+  chain_free(&t);
+  valmapfree(m);
+  free(misses);
+  free(keys);
+
+  // ---- String keys (semantic mode: a copy of the string finds the key)
+
+  if (n > 1000000) return;
+
+  char *heap, *heap2;
+  char **strs   = bchstrings(n, 12, &heap);
+  char **copies = malloc(n * sizeof(char *));
+  heap2 = malloc(n * 13);
+  if (!copies || !heap2) { perror("malloc"); exit(1); }
+  for (size_t i = 0; i < n; i++) {
+    copies[i] = heap2 + i * 13;
+    strcpy(copies[i], strs[i]);
+  }
+
+  t = chain_new();
+  m = valmapnew(VALMAP_SEMANTIC);
+  for (size_t i = 0; i < n; i++) { chain_set(&t, val(strs[i]), val(i)); valmapset(m, strs[i], i); }
+
+  snprintf(name, sizeof(name), "chained/str-hit/%zu%s", sn, sz);
+  bchrun(name, n * rounds) {
+    uint64_t acc = 0;
+    for (size_t r = 0; r < rounds; r++)
+      for (size_t i = 0; i < n; i++) acc += chain_find(&t, val(copies[i]))->val.v;
+    bchsink(acc);
+  }
+
+  snprintf(name, sizeof(name), "valmap/str-hit/%zu%s", sn, sz);
+  bchrun(name, n * rounds) {
+    uint64_t acc = 0;
+    for (size_t r = 0; r < rounds; r++)
+      for (size_t i = 0; i < n; i++) acc += valmapref(m, copies[i])->v;
+    bchsink(acc);
+  }
+
+  chain_free(&t);
+  valmapfree(m);
+  free(copies); free(heap2);
+  free(strs); free(heap);
+}
+
+bchsuite("Hash maps") {
+  bench_size(1000);
+  bench_size(1000000);
+  if (bch_size > 1000000) bench_size(bch_size);
+}
@@ -0,0 +1,99 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Parsing numbers from text: `strtod()` (or `strtoll()` for integers) followed by `val()`
+// against `valfromstr()`, on integers, on doubles written with all their digits ("%.17g")
+// and on doubles with a few decimals. Then a whole buffer of space separated numbers and
+// constants: `strtod()` on each token (and `strcmp()` for nil, true, false) against
+// `valfromstr_n()`.
+
+#include "bench.h"
+#include "bchval.h"
+#include "valparse.h"
+
+#define TOKLEN 32
+
+static val_t strtod_val(const char *s, char **end) {
+  char *e;
+  double d = strtod(s, &e);
+  if (e != s) { *end = e; return val(d); }
+  while (*e && *e != ' ') e++;
+  *end = e;
+  size_t len = (size_t)(e - s);
+  if (len == 3 && memcmp(s, "nil", 3) == 0)   return valnil;
+  if (len == 4 && memcmp(s, "true", 4) == 0)  return valtrue;
+  if (len == 5 && memcmp(s, "false", 5) == 0) return valfalse;
+  return valnil;
+}
+
+static void bench_tokens(const char *name, char (*tok)[TOKLEN], size_t n, int isint) {
+  char bname[64];
+  snprintf(bname, sizeof(bname), "%s/%s", name, isint ? "strtoll" : "strtod");
+  if (isint) {
+    bchrun(bname, n) {
+      for (size_t i = 0; i < n; i++) bchsink(val((int64_t)strtoll(tok[i], NULL, 10)).v);
+    }
+  }
+  else {
+    bchrun(bname, n) {
+      for (size_t i = 0; i < n; i++) bchsink(val(strtod(tok[i], NULL)).v);
+    }
+  }
+  snprintf(bname, sizeof(bname), "%s/valfromstr", name);
+  bchrun(bname, n) {
+    for (size_t i = 0; i < n; i++) bchsink(valfromstr(tok[i]).v);
+  }
+}
+
+bchsuite("Parsing") {
+  size_t n = bch_size;
+  char (*tok)[TOKLEN] = malloc(n * TOKLEN);
+  char *txt = malloc(n * TOKLEN);
+  val_t *v = malloc(n * sizeof(val_t));
+  if (tok == NULL || txt == NULL || v == NULL) { perror("malloc"); exit(1); }
+
+  for (size_t i = 0; i < n; i++) snprintf(tok[i], TOKLEN, "%d", (int)(bchrand() % 2000000) - 1000000);
+  bench_tokens("int", tok, n, 1);
+
+  for (size_t i = 0; i < n; i++) {
+    double d = (double)(int64_t)bchrand() / (double)(bchrand() | 1);
+    snprintf(tok[i], TOKLEN, "%.17g", d);
+  }
+  bench_tokens("double17", tok, n, 0);
+
+  for (size_t i = 0; i < n; i++) snprintf(tok[i], TOKLEN, "%.2f", (double)(bchrand() % 10000000) / 100.0);
+  bench_tokens("double2", tok, n, 0);
+
+  // Mixed text
+  size_t len = 0;
+  for (size_t i = 0; i < n; i++) {
+    uint64_t r = bchrand();
+    switch (r % 8) {
+      case 0:  len += (size_t)sprintf(txt + len, "nil "); break;
+      case 1:  len += (size_t)sprintf(txt + len, "%s ", (r & 8) ? "true" : "false"); break;
+      case 2:
+      case 3:  len += (size_t)sprintf(txt + len, "%d ", (int)(r >> 40) - (1 << 23)); break;
+      default: len += (size_t)sprintf(txt + len, "%.6g ", (double)(int64_t)(r >> 20) / 1024.0); break;
+    }
+  }
+
+  bchrun("text/strtod", n) {
+    char *p = txt, *end;
+    size_t m = 0;
+    while (m < n && *p) {
+      v[m++] = strtod_val(p, &end);
+      p = end;
+      while (*p == ' ') p++;
+    }
+    bchsink(v[m - 1].v);
+  }
+
+  bchrun("text/valfromstr_n", n) {
+    size_t m = valfromstr_n(txt, len, 0, v, n, NULL);
+    bchsink(v[m - 1].v);
+  }
+
+  free(v);
+  free(txt);
+  free(tok);
+}
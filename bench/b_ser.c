@@ -0,0 +1,71 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Loading an array of numbers and strings saved in a file: parsing a text file (one value
+// per line, numbers with `strtod()`, strings copied with `malloc()`) against loading the
+// binary file written by `valsersave()`, with the offsets of the strings turned into
+// pointers by `valservals()` (or not turned at all, reading the values with `valserget()`).
+// The time per op is the time to load a value: the files are in the page cache.
+
+#include "bench.h"
+#include "bchval.h"
+#include "valser.h"
+
+#define TXTFILE "b_ser.txt"
+#define BINFILE "b_ser.bin"
+
+bchsuite("Serialization") {
+  size_t n = bch_size * 4;
+  bchdata_t d = bchdata(n, BCH_NUMBERS | BCH_STR);
+
+  FILE *f = fopen(TXTFILE, "w");
+  if (f == NULL) { perror(TXTFILE); exit(1); }
+  for (size_t i = 0; i < n; i++) {
+    if (valisnumber(d.v[i])) fprintf(f, "%.17g\n", valtodouble(d.v[i]));
+    else fprintf(f, "%s\n", (char *)valtoptr(d.v[i]));
+  }
+  fclose(f);
+  if (valsersave(BINFILE, d.v, n) != 0) { perror(BINFILE); exit(1); }
+
+  val_t *v = malloc(n * sizeof(val_t));
+  if (v == NULL) { perror("malloc"); exit(1); }
+
+  bchrun("text/strtod", n) {
+    char line[256];
+    size_t m = 0;
+    f = fopen(TXTFILE, "r");
+    while (m < n && fgets(line, sizeof(line), f)) {
+      size_t len = strcspn(line, "\n");
+      line[len] = '\0';
+      char *end;
+      double x = strtod(line, &end);
+      if (len > 0 && *end == '\0') v[m++] = val(x);
+      else {
+        char *s = malloc(len + 1);
+        memcpy(s, line, len + 1);
+        v[m++] = val(s);
+      }
+    }
+    fclose(f);
+    bchsink(v[m - 1].v);
+    for (size_t i = 0; i < m; i++) if (valischarptr(v[i])) free(valtoptr(v[i]));
+  }
+
+  bchrun("binary/valservals", n) {
+    valser_t s = valserload(BINFILE);
+    val_t *a = valservals(s);
+    bchsink(a[n - 1].v);
+    valserfree(s);
+  }
+
+  bchrun("binary/valserload", n) {
+    valser_t s = valserload(BINFILE);
+    bchsink(valserget(s, n - 1).v);
+    valserfree(s);
+  }
+
+  free(v);
+  remove(TXTFILE);
+  remove(BINFILE);
+  bchdatafree(&d);
+}
@@ -0,0 +1,104 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Tiny strings (like currency codes) as malloc'd `char *` and as short strings.
+
+#include "bench.h"
+#include "bchval.h"
+#include "valmap.h"
+
+bchsuite("Short strings") {
+  size_t n = bch_size;
+
+  static const char *codes[] = {"USD", "EUR", "JPY", "GBP", "CHF", "CAD", "AUD", "CNY",
+                                "SEK", "NZD", "MXN", "SGD", "HKD", "NOK", "KRW", "TRY"};
+  size_t nc = sizeof(codes) / sizeof(codes[0]);
+
+  val_t *strs  = malloc(n * sizeof(val_t));
+  val_t *sstrs = malloc(n * sizeof(val_t));
+  if (!strs || !sstrs) { perror("malloc"); exit(1); }
+
+  for (size_t i = 0; i < n; i++) {
+    const char *c = codes[bchrand() % nc];
+    char *s = malloc(strlen(c) + 1);
+    if (s == NULL) { perror("malloc"); exit(1); }
+    strs[i]  = val(strcpy(s, c));
+    sstrs[i] = valshortstr(c);
+  }
+
+  bchrun("box/char*", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) {
+      char *s = malloc(4);
+      memcpy(s, codes[i & 15], 4);
+      acc ^= val(s).v;
+      free(s);
+    }
+    bchsink(acc);
+  }
+
+  bchrun("box/short", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc ^= valshortstr(codes[i & 15]).v;
+    bchsink(acc);
+  }
+
+  bchrun("valcmp/char*", n) {
+    int64_t acc = 0;
+    for (size_t i = 0, j = 0; i < n; i++) {
+      acc += valcmp(strs[i], strs[j]);
+      for (j += 7919; j >= n; j -= n) ;
+    }
+    bchsink(acc);
+  }
+
+  bchrun("valcmp/short", n) {
+    int64_t acc = 0;
+    for (size_t i = 0, j = 0; i < n; i++) {
+      acc += valcmp(sstrs[i], sstrs[j]);
+      for (j += 7919; j >= n; j -= n) ;
+    }
+    bchsink(acc);
+  }
+
+  bchrun("valcmp/short-char*", n) {
+    int64_t acc = 0;
+    for (size_t i = 0, j = 0; i < n; i++) {
+      acc += valcmp(sstrs[i], strs[j]);
+      for (j += 7919; j >= n; j -= n) ;
+    }
+    bchsink(acc);
+  }
+
+  bchrun("valhash/char*", n) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < n; i++) h ^= valhash(strs[i]);
+    bchsink(h);
+  }
+
+  bchrun("valhash/short", n) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < n; i++) h ^= valhash(sstrs[i]);
+    bchsink(h);
+  }
+
+  valmap_t m = valmapnew(VALMAP_SEMANTIC);
+  for (size_t k = 0; k < nc; k++) valmapset(m, valshortstr(codes[k]), k);
+
+  bchrun("valmap/char*", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += valmapref(m, strs[i])->v;
+    bchsink(acc);
+  }
+
+  bchrun("valmap/short", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += valmapref(m, sstrs[i])->v;
+    bchsink(acc);
+  }
+
+  valmapfree(m);
+  for (size_t i = 0; i < n; i++) free(valtoptr(strs[i]));
+  free(sstrs);
+  free(strs);
+}
@@ -0,0 +1,171 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Sorting with `qsort()` and `val_cmp()` against `valsort()` at different sizes,
+// on the same mix of `t_sort.c` (integers from 0 to 99 and lowercase strings up to
+// 8 characters) and on other data sets. Then the specialized comparisons on arrays
+// of only numbers or only strings and `valsort_mt()` from one thread to one for each
+// online CPU.
+
+#include "bench.h"
+#include "bchval.h"
+#include "valsort.h"
+#include <unistd.h>
+
+static int cmp_val(const void *a, const void *b) {
+  return val_cmp(*(const val_t *)a, *(const val_t *)b);
+}
+
+static int cmp_num(const void *a, const void *b) {
+  return val_cmp_num(*(const val_t *)a, *(const val_t *)b);
+}
+
+static int cmp_str(const void *a, const void *b) {
+  return val_cmp_str(*(const val_t *)a, *(const val_t *)b);
+}
+
+// Half integers (0..99), half random lowercase strings (1..8 characters)
+static val_t *sortmix(size_t n, char **heap) {
+  val_t *v = malloc(n * sizeof(val_t));
+  *heap = malloc(n * 9);
+  if (v == NULL || *heap == NULL) { perror("malloc"); exit(1); }
+  for (size_t i = 0; i < n; i++) {
+    if (bchrand() % 2) { v[i] = val((int)(bchrand() % 100)); continue; }
+    char *s = *heap + i * 9;
+    size_t len = 1 + bchrand() % 8;
+    for (size_t k = 0; k < len; k++) s[k] = (char)('a' + bchrand() % 26);
+    s[len] = '\0';
+    v[i] = val(s);
+  }
+  return v;
+}
+
+static void bench_sort(const char *set, val_t *src, size_t n, val_t *tmp) {
+  char name[64];
+
+  snprintf(name, sizeof(name), "%s/%zu/qsort", set, n);
+  bchrun(name, n) {
+    memcpy(tmp, src, n * sizeof(val_t));
+    qsort(tmp, n, sizeof(val_t), cmp_val);
+    bchsink(tmp[n/2].v);
+  }
+
+  snprintf(name, sizeof(name), "%s/%zu/valsort", set, n);
+  bchrun(name, n) {
+    memcpy(tmp, src, n * sizeof(val_t));
+    valsort(tmp, n);
+    bchsink(tmp[n/2].v);
+  }
+}
+
+bchsuite("Sorting") {
+  size_t n = bch_size;
+  size_t sizes[] = {n / 64, n / 8, n, n * 8};
+
+  val_t *tmp = malloc(n * 8 * sizeof(val_t));
+  if (tmp == NULL) { perror("malloc"); exit(1); }
+
+  for (int k = 0; k < 4; k++) {
+    char *heap;
+    val_t *mix = sortmix(sizes[k], &heap);
+    bench_sort("mix", mix, sizes[k], tmp);
+    free(heap);
+    free(mix);
+  }
+
+  bchdata_t numbers = bchdata(n, BCH_NUMBERS);
+  bench_sort("numbers", numbers.v, n, tmp);
+  bchdatafree(&numbers);
+
+  bchdata_t strings = bchdata(n, BCH_STR);
+  bench_sort("strings", strings.v, n, tmp);
+  bchdatafree(&strings);
+
+  bchdata_t mixed = bchdata(n, BCH_MIXED);
+  bench_sort("mixed", mixed.v, n, tmp);
+  bchdatafree(&mixed);
+
+  // Specialized comparisons and homogeneous arrays
+  bchdata_t nums = bchdata(n, BCH_NUMBERS);
+  bchdata_t strs = bchdata(n, BCH_STR);
+  bchshuffle(nums.v, n);
+  bchshuffle(strs.v, n);
+
+  bchrun("valcmpkind_n/numbers", n) bchsink((uint64_t)valcmpkind_n(nums.v, n));
+
+  bchrun("qsort/numbers/valcmp", n) {
+    memcpy(tmp, nums.v, n * sizeof(val_t));
+    qsort(tmp, n, sizeof(val_t), cmp_val);
+    bchsink(tmp[n/2].v);
+  }
+  bchrun("qsort/numbers/valcmp_num", n) {
+    memcpy(tmp, nums.v, n * sizeof(val_t));
+    qsort(tmp, n, sizeof(val_t), cmp_num);
+    bchsink(tmp[n/2].v);
+  }
+  bchrun("qsort/strings/valcmp", n) {
+    memcpy(tmp, strs.v, n * sizeof(val_t));
+    qsort(tmp, n, sizeof(val_t), cmp_val);
+    bchsink(tmp[n/2].v);
+  }
+  bchrun("qsort/strings/valcmp_str", n) {
+    memcpy(tmp, strs.v, n * sizeof(val_t));
+    qsort(tmp, n, sizeof(val_t), cmp_str);
+    bchsink(tmp[n/2].v);
+  }
+
+  bchrun("min/numbers/valcmp", n) {
+    size_t m = 0;
+    for (size_t i = 1; i < n; i++) if (val_cmp(nums.v[i], nums.v[m]) < 0) m = i;
+    bchsink(m);
+  }
+  bchrun("min/numbers/valmin_n", n) bchsink(valmin_n(nums.v, n));
+  bchrun("min/strings/valcmp", n) {
+    size_t m = 0;
+    for (size_t i = 1; i < n; i++) if (val_cmp(strs.v[i], strs.v[m]) < 0) m = i;
+    bchsink(m);
+  }
+  bchrun("min/strings/valmin_n", n) bchsink(valmin_n(strs.v, n));
+
+  // Lookups on sorted arrays
+  memcpy(tmp, nums.v, n * sizeof(val_t));
+  valsort(tmp, n);
+  bchrun("bsearch/numbers/valcmp", n) {
+    size_t s = 0;
+    for (size_t i = 0; i < n; i++) {
+      size_t lo = 0, hi = n;
+      while (lo < hi) { size_t mid = lo + (hi - lo) / 2; if (val_cmp(tmp[mid], nums.v[i]) < 0) lo = mid + 1; else hi = mid; }
+      s += lo;
+    }
+    bchsink(s);
+  }
+  bchrun("bsearch/numbers/valbsearch", n) {
+    size_t s = 0;
+    for (size_t i = 0; i < n; i++) s += valbsearch(tmp, n, nums.v[i]);
+    bchsink(s);
+  }
+
+  bchdatafree(&strs);
+  bchdatafree(&nums);
+
+  // Scaling (on the largest mix)
+  char *heap;
+  size_t big = n * 8;
+  val_t *mix = sortmix(big, &heap);
+  int ncpu = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  bchnote("Online CPUs: %d", ncpu);
+  for (int t = 1; ; t = (t * 2 < ncpu) ? t * 2 : ncpu) {
+    char name[64];
+    snprintf(name, sizeof(name), "mix/%zu/valsort_mt/%d", big, t);
+    bchrun(name, big) {
+      memcpy(tmp, mix, big * sizeof(val_t));
+      valsort_mt(tmp, big, t);
+      bchsink(tmp[big/2].v);
+    }
+    if (t >= ncpu) break;
+  }
+  free(heap);
+  free(mix);
+
+  free(tmp);
+}
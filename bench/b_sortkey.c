@@ -0,0 +1,95 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Sort keys: computing them and using them in place of `val_cmp()` to sort and
+// to find the minimum of mixed values.
+
+#include "bench.h"
+#include "bchval.h"
+#include "valbatch.h"
+
+static int cmp_val(const void *a, const void *b) {
+  return val_cmp(*(const val_t *)a, *(const val_t *)b);
+}
+
+static int cmp_key(const void *a, const void *b) {
+  val_t va = *(const val_t *)a, vb = *(const val_t *)b;
+  uint64_t ka = valsortkey(va), kb = valsortkey(vb);
+  if (ka != kb) return (ka > kb) - (ka < kb);
+  return valsortkeytie(ka) ? val_cmp(va, vb) : 0;
+}
+
+// Keys paired with the index of their value
+typedef struct { uint64_t key; size_t idx; } keyidx_t;
+
+static val_t *cmp_src;
+
+static int cmp_keyidx(const void *a, const void *b) {
+  const keyidx_t *ka = a, *kb = b;
+  if (ka->key != kb->key) return (ka->key > kb->key) - (ka->key < kb->key);
+  return valsortkeytie(ka->key) ? val_cmp(cmp_src[ka->idx], cmp_src[kb->idx]) : 0;
+}
+
+bchsuite("Sort keys") {
+  size_t n = bch_size;
+
+  bchdata_t mixed = bchdata(n, BCH_MIXED);
+  bchshuffle(mixed.v, n);
+
+  val_t    *tmp  = malloc(n * sizeof(val_t));
+  uint64_t *keys = malloc(n * sizeof(uint64_t));
+  keyidx_t *ki   = malloc(n * sizeof(keyidx_t));
+  if (!tmp || !keys || !ki) { perror("malloc"); exit(1); }
+
+  bchnote("SIMD: %d bits", VAL_SIMD);
+
+  bchrun("valsortkey/one-by-one", n) {
+    for (size_t i = 0; i < n; i++) keys[i] = valsortkey(mixed.v[i]);
+  }
+  bchsink(keys[n-1]);
+
+  bchrun("valsortkey_n", n) {
+    valsortkey_n(mixed.v, n, keys);
+  }
+  bchsink(keys[n-1]);
+
+  bchrun("min/valcmp", n) {
+    val_t m = mixed.v[0];
+    for (size_t i = 1; i < n; i++) if (val_cmp(mixed.v[i], m) < 0) m = mixed.v[i];
+    bchsink(m.v);
+  }
+
+  bchrun("min/valsortkey_n", n) {
+    valsortkey_n(mixed.v, n, keys);
+    size_t m = 0;
+    for (size_t i = 1; i < n; i++) if (keys[i] < keys[m]) m = i;
+    bchsink(mixed.v[m].v);
+  }
+
+  bchrun("qsort/valcmp", n) {
+    memcpy(tmp, mixed.v, n * sizeof(val_t));
+    qsort(tmp, n, sizeof(val_t), cmp_val);
+    bchsink(tmp[n/2].v);
+  }
+
+  bchrun("qsort/valsortkey", n) {
+    memcpy(tmp, mixed.v, n * sizeof(val_t));
+    qsort(tmp, n, sizeof(val_t), cmp_key);
+    bchsink(tmp[n/2].v);
+  }
+
+  // Keys computed once
+  bchrun("qsort/valsortkey_n", n) {
+    valsortkey_n(mixed.v, n, keys);
+    for (size_t i = 0; i < n; i++) { ki[i].key = keys[i]; ki[i].idx = i; }
+    cmp_src = mixed.v;
+    qsort(ki, n, sizeof(keyidx_t), cmp_keyidx);
+    for (size_t i = 0; i < n; i++) tmp[i] = mixed.v[ki[i].idx];
+    bchsink(tmp[n/2].v);
+  }
+
+  free(ki);
+  free(keys);
+  free(tmp);
+  bchdatafree(&mixed);
+}
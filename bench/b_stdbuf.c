@@ -0,0 +1,100 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Buffer keys (64 bytes long) as `char *` (what any buffer costs without VALSTDBUF)
+// and as standard buffers that know their length and hash.
+
+#include "valbuf.h"
+#include "bench.h"
+#include "bchval.h"
+#include "valmap.h"
+
+#define KEYLEN 64
+#define NKEYS  1024
+
+bchsuite("Standard buffers") {
+  size_t n = bch_size;
+
+  // Keys share a long prefix and differ in the last bytes
+  char     *heap  = malloc(NKEYS * (KEYLEN + 1));
+  valbuf_t *bufs  = malloc(NKEYS * sizeof(valbuf_t));
+  val_t    *strs  = malloc(n * sizeof(val_t));
+  val_t    *bvals = malloc(n * sizeof(val_t));
+  if (!heap || !bufs || !strs || !bvals) { perror("malloc"); exit(1); }
+
+  for (size_t k = 0; k < NKEYS; k++) {
+    char *s = heap + k * (KEYLEN + 1);
+    memset(s, 'x', KEYLEN);
+    snprintf(s + KEYLEN - 8, 9, "%08zu", k);
+    bufs[k] = valbuffrom(s, KEYLEN);
+  }
+  for (size_t i = 0; i < n; i++) {
+    size_t k = bchrand() % NKEYS;
+    strs[i]  = val(heap + k * (KEYLEN + 1));
+    bvals[i] = val(bufs[k]);
+  }
+
+  bchrun("valhash/char*", n) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < n; i++) h ^= valhash(strs[i]);
+    bchsink(h);
+  }
+
+  bchrun("valhash/stdbuf", n) {
+    uint32_t h = 0;
+    for (size_t i = 0; i < n; i++) h ^= valhash(bvals[i]);
+    bchsink(h);
+  }
+
+  bchrun("valcmp/char*", n) {
+    int64_t acc = 0;
+    for (size_t i = 0, j = 0; i < n; i++) {
+      acc += valcmp(strs[i], strs[j]);
+      for (j += 7919; j >= n; j -= n) ;
+    }
+    bchsink(acc);
+  }
+
+  bchrun("valcmp/stdbuf", n) {
+    int64_t acc = 0;
+    for (size_t i = 0, j = 0; i < n; i++) {
+      acc += valcmp(bvals[i], bvals[j]);
+      for (j += 7919; j >= n; j -= n) ;
+    }
+    bchsink(acc);
+  }
+
+  // Maps with a different copy of the keys (so that the keys must be compared)
+  valmap_t ms = valmapnew(VALMAP_SEMANTIC);
+  valmap_t mb = valmapnew(VALMAP_SEMANTIC);
+  char *heap2 = malloc(NKEYS * (KEYLEN + 1));
+  if (!heap2) { perror("malloc"); exit(1); }
+  memcpy(heap2, heap, NKEYS * (KEYLEN + 1));
+  for (size_t k = 0; k < NKEYS; k++) {
+    valmapset(ms, heap2 + k * (KEYLEN + 1), k);
+    valmapset(mb, valbuffrom(heap2 + k * (KEYLEN + 1), KEYLEN), k);
+  }
+
+  bchrun("valmap/char*", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += valmapref(ms, strs[i])->v;
+    bchsink(acc);
+  }
+
+  bchrun("valmap/stdbuf", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += valmapref(mb, bvals[i])->v;
+    bchsink(acc);
+  }
+
+  val_t k, v;
+  for (size_t i = 0; (i = valmapnext(mb, i, &k, &v)); ) valbuffree(valtoptr(k));
+  valmapfree(mb);
+  valmapfree(ms);
+  for (size_t k = 0; k < NKEYS; k++) valbuffree(bufs[k]);
+  free(heap2);
+  free(bvals);
+  free(strs);
+  free(bufs);
+  free(heap);
+}
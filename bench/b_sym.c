@@ -0,0 +1,124 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Symbol encoding and decoding: the original loops (one character at a time, with
+// an early exit) against the current functions and their batch versions.
+
+#include "bench.h"
+#include "bchval.h"
+#include "valbatch.h"
+
+static val_t loop_symconst(char *sym_str) {
+  val_t sym_val = {0};
+  if (sym_str == NULL || *sym_str == '\0') { sym_val.v = VAL_SYM_NULL; return sym_val; }
+
+  int shift = 0;
+  uint8_t c = 0;
+  uint64_t sym_64 = 0;
+  for (int i = 0; i < 8; i++, shift += 6) {
+    if ((c = val_ascii_to_sym[*sym_str++ & 0x7F]) == 0x3F) break;
+    sym_64 |= (((uint64_t)c) << shift);
+  }
+  sym_64 |= (VAL_SYM_NULL << shift);
+  sym_val.v = VAL_SYM_0 | (sym_64 & VAL_PAYLOAD_MASK);
+  return sym_val;
+}
+
+static valstr_t loop_symtostr(val_t v) {
+  valstr_t sym_vstr;
+  char *s_ptr = sym_vstr.str;
+  if ((((v).v & VAL_TYPE_MASK) == VAL_SYM_0)) {
+    uint64_t sym_64 = ((v).v & VAL_PAYLOAD_MASK);
+    for (int i = 0; i < 8; i++, s_ptr++) {
+      if ((*s_ptr = val_sym_to_ascii[sym_64 & 0x3F]) == '\0') break;
+      sym_64 >>= 6;
+    }
+  }
+  *s_ptr = '\0';
+  return sym_vstr;
+}
+
+// Dispatch on keywords with the symbols computed at each call or known at compile time
+static int kw_runtime(val_t v) {
+  if (valeq(v, valsymconst("if")))     return 1;
+  if (valeq(v, valsymconst("else")))   return 2;
+  if (valeq(v, valsymconst("while")))  return 3;
+  if (valeq(v, valsymconst("for")))    return 4;
+  if (valeq(v, valsymconst("return"))) return 5;
+  if (valeq(v, valsymconst("break")))  return 6;
+  return 0;
+}
+
+static int kw_switch(val_t v) {
+  switch (v.v) {
+    case VALSYM('i','f'):                 return 1;
+    case VALSYM('e','l','s','e'):         return 2;
+    case VALSYM('w','h','i','l','e'):     return 3;
+    case VALSYM('f','o','r'):             return 4;
+    case VALSYM('r','e','t','u','r','n'): return 5;
+    case VALSYM('b','r','e','a','k'):     return 6;
+    default:                              return 0;
+  }
+}
+
+bchsuite("Symbols") {
+  size_t n = bch_size;
+  char *heap;
+  char **tokens = bchstrings(n, 8, &heap);   // Identifiers of random length (1 to 8)
+  val_t *syms = malloc(n * sizeof(val_t));
+  valstr_t *strs = malloc(n * sizeof(valstr_t));
+  if (!syms || !strs) { perror("malloc"); exit(1); }
+
+  bchrun("symconst/loop", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc ^= loop_symconst(tokens[i]).v;
+    bchsink(acc);
+  }
+
+  bchrun("symconst/valsymconst", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc ^= valsymconst(tokens[i]).v;
+    bchsink(acc);
+  }
+
+  bchrun("symconst/valsymconst_n", n) {
+    valsymconst_n(tokens, n, syms);
+    bchsink(syms[n - 1].v);
+  }
+
+  bchrun("symtostr/loop", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += (uint8_t)loop_symtostr(syms[i]).str[1];
+    bchsink(acc);
+  }
+
+  bchrun("symtostr/valsymtostr", n) {
+    uint64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += (uint8_t)valsymtostr(syms[i]).str[1];
+    bchsink(acc);
+  }
+
+  bchrun("symtostr/valsymtostr_n", n) {
+    valsymtostr_n(syms, n, strs);
+    bchsink(strs[n - 1].str[0]);
+  }
+
+  static char *kw[] = {"if", "else", "while", "for", "return", "break", "x", "y"};
+  for (size_t i = 0; i < n; i++) syms[i] = valsymconst(kw[bchrand() % 8]);
+
+  bchrun("dispatch/valsymconst", n) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += kw_runtime(syms[i]);
+    bchsink(acc);
+  }
+
+  bchrun("dispatch/VALSYM", n) {
+    int64_t acc = 0;
+    for (size_t i = 0; i < n; i++) acc += kw_switch(syms[i]);
+    bchsink(acc);
+  }
+
+  free(strs);
+  free(syms);
+  free(tokens); free(heap);
+}
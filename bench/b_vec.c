@@ -0,0 +1,89 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Vectors: appending C arrays of integers, doubles and strings at once against pushing
+// the values one by one with `valvecpush()`; then summing and sorting the numbers with
+// the kind remembered by the vector against scanning the values to find it.
+
+#include "bench.h"
+#include "bchval.h"
+#include "valvec.h"
+
+bchsuite("Vectors") {
+  size_t n = bch_size;
+
+  int    *ints = malloc(n * sizeof(int));
+  double *dbls = malloc(n * sizeof(double));
+  char  **strs = malloc(n * sizeof(char *));
+  val_t  *tmp  = malloc(n * sizeof(val_t));
+  if (ints == NULL || dbls == NULL || strs == NULL || tmp == NULL) { perror("malloc"); exit(1); }
+  for (size_t i = 0; i < n; i++) {
+    ints[i] = (int)(bchrand() % 2000000) - 1000000;
+    dbls[i] = ints[i] / 8.0;
+    strs[i] = "abc";
+  }
+
+  valvec_t vec = valvecnew(n);
+  if (vec == NULL) { perror("valvecnew"); exit(1); }
+
+  bchrun("int/valvecpush", n) {
+    valvecclear(vec);
+    for (size_t i = 0; i < n; i++) valvecpush(vec, ints[i]);
+    bchsink(vec->v[n - 1].v);
+  }
+  bchrun("int/valvecappendint", n) {
+    valvecclear(vec);
+    valvecappendint(vec, ints, n);
+    bchsink(vec->v[n - 1].v);
+  }
+
+  bchrun("double/valvecpush", n) {
+    valvecclear(vec);
+    for (size_t i = 0; i < n; i++) valvecpush(vec, dbls[i]);
+    bchsink(vec->v[n - 1].v);
+  }
+  bchrun("double/valvecappenddouble", n) {
+    valvecclear(vec);
+    valvecappenddouble(vec, dbls, n);
+    bchsink(vec->v[n - 1].v);
+  }
+
+  bchrun("str/valvecpush", n) {
+    valvecclear(vec);
+    for (size_t i = 0; i < n; i++) valvecpush(vec, strs[i]);
+    bchsink(vec->v[n - 1].v);
+  }
+  bchrun("str/valvecappendstr", n) {
+    valvecclear(vec);
+    valvecappendstr(vec, strs, n);
+    bchsink(vec->v[n - 1].v);
+  }
+
+  valvecclear(vec);
+  valvecappenddouble(vec, dbls, n);
+
+  bchrun("sum/scan", n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++)
+      if (valisnumber(vec->v[i])) sum += valtodouble(vec->v[i]);
+    bchsink((uint64_t)sum);
+  }
+  bchrun("sum/valvecsum", n) bchsink((uint64_t)valvecsum(vec));
+
+  bchrun("sort/valsort", n) {
+    memcpy(tmp, vec->v, n * sizeof(val_t));
+    valsort(tmp, n);
+    bchsink(tmp[0].v);
+  }
+  bchrun("sort/valsort_kind", n) {
+    memcpy(tmp, vec->v, n * sizeof(val_t));
+    valsort_kind(tmp, n, valveckind(vec));
+    bchsink(tmp[0].v);
+  }
+
+  valvecfree(vec);
+  free(tmp);
+  free(strs);
+  free(dbls);
+  free(ints);
+}
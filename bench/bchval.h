@@ -0,0 +1,145 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Data sets of `val_t` values for the benchmarks.
+// A fixed seed PRNG is used so that different builds run on the very same data.
+
+#ifndef BCHVAL_VERSION
+#define BCHVAL_VERSION 0x0001000C
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifndef BCHVAL_NOBUF
+#ifdef VALSTDBUF
+#include "valbuf.h"
+typedef valbuf_t bchbuf_t;
+#else
+typedef struct valptr_buf_s { char *buf; size_t len; } *bchbuf_t;
+#endif
+#endif
+
+#include "val.h"
+
+// Kinds of values in a data set
+#define BCH_INT      0x01  // Integers (as doubles)
+#define BCH_DBL      0x02  // Doubles with a fractional part
+#define BCH_STR      0x04  // char *
+#define BCH_BUF      0x08  // Buffers
+#define BCH_SYM      0x10  // Symbolic constants
+#define BCH_CONST    0x20  // valtrue, valfalse, valnil and numeric constants
+#define BCH_NUMBERS  (BCH_INT | BCH_DBL)
+#define BCH_STRINGS  (BCH_STR | BCH_BUF)
+#define BCH_MIXED    (BCH_NUMBERS | BCH_STRINGS | BCH_SYM | BCH_CONST)
+
+static uint64_t bch_seed = 0x9E3779B97F4A7C15;
+
+static inline void bchsrand(uint64_t seed) { bch_seed = seed ? seed : 0x9E3779B97F4A7C15; }
+
+// xorshift64*
+static inline uint64_t bchrand(void) {
+  bch_seed ^= bch_seed >> 12;
+  bch_seed ^= bch_seed << 25;
+  bch_seed ^= bch_seed >> 27;
+  return bch_seed * (uint64_t)0x2545F4914F6CDD1D;
+}
+
+static const char bch_symchars[] = "abcdefghijklmnopqrstuvwxyz0123456789_";
+
+// Fills `s` with a random identifier-like string of length between 1 and `maxlen`
+static inline size_t bch_randstr(char *s, int maxlen) {
+  size_t len = 1 + bchrand() % (uint64_t)maxlen;
+  s[0] = (char)('a' + bchrand() % 26);
+  for (size_t k = 1; k < len; k++) s[k] = bch_symchars[bchrand() % (sizeof(bch_symchars)-1)];
+  s[len] = '\0';
+  return len;
+}
+
+// A data set owns the memory of its strings and buffers.
+typedef struct {
+  val_t  *v;
+  size_t  n;
+  char   *heap;
+  struct valptr_buf_s *bufs;
+} bchdata_t;
+
+#define BCH_STRMAX 16
+
+static inline bchdata_t bchdata(size_t n, int kinds) {
+  bchdata_t d;
+  int kind[8];
+  int nkinds = 0;
+
+  for (int k = 0; k < 6; k++) if (kinds & (1 << k)) kind[nkinds++] = 1 << k;
+  if (nkinds == 0) kind[nkinds++] = BCH_INT;
+
+  d.n    = n;
+  d.v    = malloc(n * sizeof(val_t));
+  d.heap = malloc(n * (BCH_STRMAX + 1));
+#ifndef BCHVAL_NOBUF
+  d.bufs = malloc(n * sizeof(struct valptr_buf_s));
+#else
+  d.bufs = NULL;
+#endif
+  if (d.v == NULL || d.heap == NULL) { perror("bchdata"); exit(1); }
+
+  for (size_t i = 0; i < n; i++) {
+    char *s = d.heap + i * (BCH_STRMAX + 1);
+    uint64_t r = bchrand();
+
+    switch (kind[r % (uint64_t)nkinds]) {
+      case BCH_INT:   d.v[i] = val((int64_t)(r >> 40) - (1 << 23)); break;
+      case BCH_DBL:   d.v[i] = val((double)(int64_t)(r >> 20) / 1024.0 + 0.5); break;
+      case BCH_STR:   bch_randstr(s, BCH_STRMAX); d.v[i] = val(s); break;
+#ifndef BCHVAL_NOBUF
+      case BCH_BUF:   d.bufs[i].len = bch_randstr(s, BCH_STRMAX);
+                      d.bufs[i].buf = s;
+#ifdef VALSTDBUF
+                      d.bufs[i].cap  = 0;
+                      d.bufs[i].hash = 0;
+#endif
+                      d.v[i] = val(&d.bufs[i]); break;
+#endif
+      case BCH_SYM:   bch_randstr(s, 8); d.v[i] = valconst(s); break;
+      case BCH_CONST: switch ((r >> 8) % 4) {
+                        case 0:  d.v[i] = valtrue;  break;
+                        case 1:  d.v[i] = valfalse; break;
+                        case 2:  d.v[i] = valnil;   break;
+                        default: d.v[i] = valconst((uint32_t)(r >> 32)); break;
+                      }
+                      break;
+      default:        d.v[i] = val((int64_t)i); break;
+    }
+  }
+  return d;
+}
+
+// Random strings (not boxed) to be used as input for constructors and symbol encoding
+static inline char **bchstrings(size_t n, int maxlen, char **heap) {
+  char **s = malloc(n * sizeof(char *));
+  *heap = malloc(n * (size_t)(maxlen + 1));
+  if (s == NULL || *heap == NULL) { perror("bchstrings"); exit(1); }
+  for (size_t i = 0; i < n; i++) {
+    s[i] = *heap + i * (size_t)(maxlen + 1);
+    bch_randstr(s[i], maxlen);
+  }
+  return s;
+}
+
+static inline void bchdatafree(bchdata_t *d) {
+  free(d->v);    d->v = NULL;
+  free(d->heap); d->heap = NULL;
+  free(d->bufs); d->bufs = NULL;
+  d->n = 0;
+}
+
+// Shuffles an array of values (Fisher-Yates)
+static inline void bchshuffle(val_t *v, size_t n) {
+  for (size_t i = n; i > 1; i--) {
+    size_t j = bchrand() % i;
+    val_t t = v[i-1]; v[i-1] = v[j]; v[j] = t;
+  }
+}
+
+#endif // BCHVAL_VERSION
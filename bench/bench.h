@@ -0,0 +1,269 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// A minimal micro-benchmark harness.
+//
+//   bchsuite("title") {
+//     bchrun("name", nops) {
+//       for (size_t i = 0; i < nops; i++) bchsink(f(x[i]));
+//     }
+//   }
+//
+// The body of `bchrun` is executed once for warm-up and then `bch_reps` times;
+// the fastest run is reported as ns/op and ops/s on stdout and appended, as a
+// tab separated line, to the results file (`bench.tsv` by default) so that
+// different builds (compiler, -O level, ARCH=-m32, ...) can be compared.
+//
+// On Linux, the `-p` option also collects the hardware counters (cycles,
+// instructions, branch misses, L1D and LLC misses) of the fastest run through
+// perf_event_open(2). Counters that are not available (e.g. in a VM or with a
+// restrictive `perf_event_paranoid`) are reported as `-` and the benchmark
+// falls back to the wall-clock measure alone.
+
+#ifndef BCH_VERSION
+#define BCH_VERSION 0x0001000C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+// The build flags are passed by the makefile to be recorded in the results file
+#ifndef BCH_CFLAGS
+#define BCH_CFLAGS ""
+#endif
+
+#if defined(__clang__)
+  #define BCH_CC "clang " __clang_version__
+#elif defined(__GNUC__)
+  #define BCH_CC "gcc " __VERSION__
+#elif defined(_MSC_VER)
+  #define BCH_CC "cl"
+#else
+  #define BCH_CC "cc"
+#endif
+
+static size_t      bch_size    = 1 << 16;   // Number of elements in the data sets (-n)
+static int         bch_reps    = 5;         // Timed repetitions (-r)
+static const char *bch_outfile = "bench.tsv";  // Results file (-o), "-" for none
+static const char *bch_filter  = NULL;      // Only run benchmarks containing this string (-f)
+static const char *bch_title   = "";
+static int         bch_perf    = 0;         // Collect hardware counters (-p)
+
+static volatile uint64_t bch_sink = 0;      // Prevents the compiler from discarding results
+#define bchsink(x) (bch_sink += (uint64_t)(x))
+
+static struct {
+  const char *name;
+  size_t      nops;
+  uint64_t    t0;
+  uint64_t    best;
+  int         rep;
+  int         skip;
+} bch_cur;
+
+// ==== Hardware counters
+
+#define BCH_NCOUNTERS 5
+
+static const char *bch_counter_name[BCH_NCOUNTERS] = {
+  "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses"
+};
+
+static int     bch_counter_fd[BCH_NCOUNTERS]   = {-1, -1, -1, -1, -1};
+static int64_t bch_counter_cur[BCH_NCOUNTERS]  = {0};  // Values for the current run
+static int64_t bch_counter_best[BCH_NCOUNTERS] = {0};  // Values for the fastest run
+
+#ifdef __linux__
+static int bch_perf_open(uint32_t type, uint64_t config) {
+  struct perf_event_attr pe;
+  memset(&pe, 0, sizeof(pe));
+  pe.type           = type;
+  pe.size           = sizeof(pe);
+  pe.config         = config;
+  pe.disabled       = 1;
+  pe.exclude_kernel = 1;
+  pe.exclude_hv     = 1;
+  return (int)syscall(SYS_perf_event_open, &pe, 0, -1, -1, 0);
+}
+
+static void bch_perf_init(void) {
+  static const struct { uint32_t type; uint64_t config; } ev[BCH_NCOUNTERS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                                 | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}
+  };
+  int available = 0;
+
+  for (int k = 0; k < BCH_NCOUNTERS; k++) {
+    bch_counter_fd[k] = bch_perf_open(ev[k].type, ev[k].config);
+    available += (bch_counter_fd[k] >= 0);
+  }
+  if (available == 0) {
+    printf("# hardware counters not available, reporting wall-clock only\n");
+    bch_perf = 0;
+  }
+}
+
+static inline void bch_perf_start(void) {
+  for (int k = 0; k < BCH_NCOUNTERS; k++) {
+    if (bch_counter_fd[k] < 0) continue;
+    ioctl(bch_counter_fd[k], PERF_EVENT_IOC_RESET, 0);
+    ioctl(bch_counter_fd[k], PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+static inline void bch_perf_stop(void) {
+  for (int k = 0; k < BCH_NCOUNTERS; k++) {
+    int64_t count = -1;
+    if (bch_counter_fd[k] >= 0) {
+      ioctl(bch_counter_fd[k], PERF_EVENT_IOC_DISABLE, 0);
+      if (read(bch_counter_fd[k], &count, sizeof(count)) != (ssize_t)sizeof(count)) count = -1;
+    }
+    bch_counter_cur[k] = count;
+  }
+}
+#else
+static void bch_perf_init(void) {
+  printf("# hardware counters are only supported on Linux, reporting wall-clock only\n");
+  bch_perf = 0;
+}
+static inline void bch_perf_start(void) {}
+static inline void bch_perf_stop(void)  {}
+#endif
+
+// Formats the counter `k` per operation (or `-` if not available)
+static const char *bch_counter_str(int k, char *buf) {
+  if (!bch_perf || bch_counter_best[k] < 0) return "-";
+  sprintf(buf, "%.3f", (double)bch_counter_best[k] / (double)(bch_cur.nops ? bch_cur.nops : 1));
+  return buf;
+}
+
+static inline uint64_t bch_nsec(void) {
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+#endif
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bch_report(void) {
+  double ns_op = (double)bch_cur.best / (double)(bch_cur.nops ? bch_cur.nops : 1);
+  double ops_s = ns_op > 0.0 ? 1e9 / ns_op : 0.0;
+
+  char cnt[BCH_NCOUNTERS][32];
+
+  printf("%-32s %10zu ops %10.2f ns/op %14.0f ops/s", bch_cur.name, bch_cur.nops, ns_op, ops_s);
+  if (bch_perf) {
+    printf("  cyc %s  ins %s  br-miss %s  L1D-miss %s  LLC-miss %s (per op)",
+              bch_counter_str(0, cnt[0]), bch_counter_str(1, cnt[1]), bch_counter_str(2, cnt[2]),
+              bch_counter_str(3, cnt[3]), bch_counter_str(4, cnt[4]));
+  }
+  putchar('\n');
+  fflush(stdout);
+
+  if (bch_outfile == NULL || strcmp(bch_outfile, "-") == 0) return;
+
+  FILE *f = fopen(bch_outfile, "a+");
+  if (f == NULL) { perror(bch_outfile); return; }
+
+  fseek(f, 0, SEEK_END);
+  if (ftell(f) == 0) {
+    fputs("suite\tbench\tops\treps\tbest_ns\tns_op\tops_s\tbits\tcc\tcflags", f);
+    for (int k = 0; k < BCH_NCOUNTERS; k++) fprintf(f, "\t%s_op", bch_counter_name[k]);
+    fputc('\n', f);
+  }
+
+  fprintf(f, "%s\t%s\t%zu\t%d\t%" PRIu64 "\t%.3f\t%.0f\t%d\t%s\t%s",
+             bch_title, bch_cur.name, bch_cur.nops, bch_reps, bch_cur.best, ns_op, ops_s,
+             (int)(sizeof(void *) * 8), BCH_CC, BCH_CFLAGS);
+  for (int k = 0; k < BCH_NCOUNTERS; k++) fprintf(f, "\t%s", bch_counter_str(k, cnt[k]));
+  fputc('\n', f);
+  fclose(f);
+}
+
+static inline void bch_begin(const char *name, size_t nops) {
+  bch_cur.name = name;
+  bch_cur.nops = nops;
+  bch_cur.best = UINT64_MAX;
+  bch_cur.rep  = -1;   // The first run is a warm-up
+  bch_cur.skip = (bch_filter != NULL && strstr(name, bch_filter) == NULL);
+}
+
+static inline int bch_next(void) {
+  uint64_t elapsed = bch_nsec() - bch_cur.t0;
+
+  if (bch_cur.skip) return 0;
+
+  if (bch_perf) bch_perf_stop();
+
+  if (bch_cur.rep >= 0 && elapsed < bch_cur.best) {
+    bch_cur.best = elapsed;
+    memcpy(bch_counter_best, bch_counter_cur, sizeof(bch_counter_best));
+  }
+
+  if (++bch_cur.rep > bch_reps) {
+    bch_report();
+    return 0;
+  }
+
+  if (bch_perf) bch_perf_start();
+  bch_cur.t0 = bch_nsec();
+  return 1;
+}
+
+// Runs the body (which is expected to perform `nops_` operations) and reports its timing.
+#define bchrun(name_, nops_) for (bch_begin(name_, nops_); bch_next(); )
+
+// Prints a note in the output (not recorded in the results file).
+#define bchnote(...) (printf("# " __VA_ARGS__), putchar('\n'))
+
+static void bch_usage(const char *prg) {
+  fprintf(stderr, "Usage: %s [-p] [-n size] [-r reps] [-f filter] [-o results.tsv | -o -]\n", prg);
+  exit(1);
+}
+
+static void bch_parseargs(int argc, char **argv) {
+  for (int k = 1; k < argc; k++) {
+    if (argv[k][0] != '-' || argv[k][1] == '\0' || argv[k][2] != '\0') bch_usage(argv[0]);
+    if (argv[k][1] == 'p') { bch_perf = 1; continue; }
+    if (k+1 >= argc) bch_usage(argv[0]);
+    switch (argv[k][1]) {
+      case 'n': bch_size    = (size_t)strtoull(argv[++k], NULL, 0); break;
+      case 'r': bch_reps    = atoi(argv[++k]); break;
+      case 'f': bch_filter  = argv[++k]; break;
+      case 'o': bch_outfile = argv[++k]; break;
+      default : bch_usage(argv[0]);
+    }
+  }
+  if (bch_size < 1) bch_size = 1;
+  if (bch_reps < 1) bch_reps = 1;
+}
+
+#define bchsuite(title_) \
+  void bch__run(void); \
+  int main(int argc, char **argv) { \
+    bch_title = title_; \
+    bch_parseargs(argc, argv); \
+    if (bch_perf) bch_perf_init(); \
+    printf("----- %s (n=%zu, reps=%d, %s %s)\n", bch_title, bch_size, bch_reps, BCH_CC, BCH_CFLAGS); \
+    bch__run(); \
+    return (int)(bch_sink & 0); \
+  } void bch__run(void)
+
+#endif // BCH_VERSION
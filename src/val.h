@@ -76,6 +76,30 @@
 //   7FF9 B3F0 Nil              1011 0011 1111 0000  
 //   7FF9 C3F0 User defined     1100 0011 1111 0000
 //   7FF9 xxxx Symbolic
+//
+//   Extensions:
+//
+//   FFF9 0000 Native 32-bit integers (only if VALNATIVEINT is defined)
+//   FFF9 00xx Internal sentinels (xx is never 0), e.g. the empty slots of `valcmap.h`
+//   FFF9 xxxx Short strings (xx is the first byte, never 0)
+//
+//   By default, integers are stored as doubles and each boxing/unboxing requires a conversion.
+//   Defining VALNATIVEINT, integers that fit in 32 bits are stored in the lower 32 bits of the
+//   payload instead. They are still numbers: `valisnumber()`, `valisint()`, `valtodouble()`,
+//   `valcmp()` and `valhash()` treat `val(3)` and `val(3.0)` as the same number (but `valeq()`
+//   will tell them apart since it checks for identity).
+//
+//   Strings of 1 to 6 bytes can be stored directly in the payload, one byte after the other
+//   starting from bits 40-47 and padded with 0. They are strings: `valcmp()` and `valhash()`
+//   treat them as the `char *` with the same text, without accessing memory.
+//
+//   Interned strings:
+//
+//   If VALINTERN is defined, the pointers of type 7FFC (valptr_7_t) are interned strings (see `valintern.h`).
+//
+//   Standard buffers:
+//
+//   If VALSTDBUF is defined, `valptr_buf_t` points to a buffer with length and hash (see `valbuf.h`).
 
 //                                      |   |   |   |   |
 #define VAL_NAN_MASK       ((uint64_t)0x7FF8000000000000)
@@ -116,6 +140,14 @@
 #define VAL_SYM_MASK       ((uint64_t)0x00000FF000000000)
 #define VAL_SYM_NOT        ((uint64_t)0x000003F000000000)
 //                                      |   |   |   |   |
+#define VAL_INT32_MASK     ((uint64_t)0xFFFFFFFF00000000)
+#define VAL_INT32          ((uint64_t)0xFFF9000000000000)
+//                                      |   |   |   |   |
+#define VAL_SSTR           ((uint64_t)0xFFF9000000000000)
+#define VAL_SSTR_MIN       ((uint64_t)0xFFF9010000000000)
+#define VAL_SSTR_RANGE     ((uint64_t)0x0000FF0000000000)
+#define VAL_SSTR_LEN       6
+//                                      |   |   |   |   |
 
 // =========
 
@@ -133,31 +165,45 @@ static_assert(sizeof(val_t) == 8, "Wrong size for uint64_t");
 #define VAL_vrg(f, ...)  VAL_cat(f, VAL_n(__VA_ARGS__))(__VA_ARGS__)
 
 // ==== Numbers
-// All numbers are stored as a double floating point.
+// All numbers are stored as a double floating point (or as native 32-bit integers if VALNATIVEINT is defined).
+
+#define val_is_int32(x) (((x).v & VAL_INT32_MASK) == VAL_INT32)
 
 // All non-NaN numbers are doubles except VAL_DBLNAN_NEG and VAL_DBLNAN_POS
 #define valisnumber(x) val_isnumber(val(x)) 
 static inline int val_isnumber(val_t v) {
   return (((v).v & VAL_NAN_MASK) != VAL_NAN_MASK)
-      || (((v).v & VAL_DBLNAN_MASK) == VAL_DBLNAN_POS); // The result of expressions like 0.0/0.0
+      || (((v).v & VAL_DBLNAN_MASK) == VAL_DBLNAN_POS)  // The result of expressions like 0.0/0.0
+#ifdef VALNATIVEINT
+      || val_is_int32(v)
+#endif
+      ;
 }
 
 // By effect of the IEEE 754 standard, only integers up to 52 bits are representable.
 // We'll check directly on the bit represantation of doubles. See IEEE754.md in the docs direcotory
+//
+// The check is branch-free: a number is an integer iff all the bits of the significand (including
+// the implicit leading 1) that are below the binary point are 0. There are `1075 - exp` such bits
+// (`1074` for subnormals), clamped to [0,63]:
+//   - zero and subnormals: all the bits are checked, only ±0 are integers;
+//   - |v| < 1: the implicit 1 is among the checked bits, never an integer;
+//   - |v| ≥ 2^52: no bit is checked, always an integer (unless it is a NaN or ±inf).
 #define valisint(x) val_isint(val(x))
 static inline int val_isint(val_t v) {
-  int      exp_bits  = (int)(((v).v >> 52) & 0x7FF);          // Extract the exponent (11 bits)
-  uint64_t frac_bits = (v).v & ((((uint64_t)1) << 52) - 1);   // Extract the fraction field (52 bits)
-
-  if (exp_bits == 0)     return (frac_bits == 0);           // If exponent is 0 and the fractional part is 0 then it's an integer.
-  if (exp_bits == 0x7FF) return 0;                          // If exponent is all 1, then it's a NaN, hence not an integer
+  int      exp_bits  = (int)(((v).v >> 52) & 0x7FF);                 // Extract the exponent (11 bits)
+  uint64_t frac_bits = ((v).v & ((((uint64_t)1) << 52) - 1))         // Extract the fraction field (52 bits)
+                     | ((uint64_t)(exp_bits != 0) << 52);            // and add the implicit leading 1
+  int      frac_len  = 1075 - exp_bits - (exp_bits == 0);            // Number of bits below the binary point
 
-  int e = exp_bits - 1023;                                  // Compute unbiased exponent e = exp_bits − bias (bias = 1023)
-  if (e < 0)   return 0;                                    //  If exponent < 0 cannot be an integer
-  if (e >= 52) return 1;                                    // If exponet ≥ 52, all bits represent values ≥ 2^0, so no fractional part remains
+  frac_len = (frac_len < 0) ? 0 : (frac_len > 63) ? 63 : frac_len;   // Compiles to conditional moves
 
-  uint64_t frac_mask = (((uint64_t)1) << (52 - e)) - 1;     // Get the actual fractional part
-  return ( (frac_bits & frac_mask) == 0 );                  // Iff it is 0, it's an integer.
+  uint64_t frac_mask = (((uint64_t)1) << frac_len) - 1;
+  return (((frac_bits & frac_mask) == 0) & (exp_bits != 0x7FF))      // NaNs and infinities are not integers
+#ifdef VALNATIVEINT
+       | val_is_int32(v)
+#endif
+       ;
 }
 
 // ==== POINTERS
@@ -165,7 +211,37 @@ static inline int val_isint(val_t v) {
 // Buffers are structures whose first field is a char *
 typedef struct valptr_buf_s *valptr_buf_t; 
 
+// If VALSTDBUF is defined, buffers are the standard ones below (see `valbuf.h`).
+// They know their length, so they are compared with `memcmp()` and can contain
+// NUL bytes, and they keep their hash once computed.
+#ifdef VALSTDBUF
+struct valptr_buf_s {
+  char     *buf;   // Always NUL terminated (buf[len] == '\0')
+  size_t    len;   // Bytes in the buffer (excluding the final NUL)
+  size_t    cap;   // Allocated bytes (0 if the memory is not owned by the buffer)
+  uint32_t  hash;  // The value of `valhash()` (0 if not computed yet)
+};
+#endif
+
 // These can be user defined.
+// If VALINTERN is defined, valptr_7_t is used by the library for interned strings (see `valintern.h`)
+
+#ifdef VALINTERN
+#ifdef valptr_7_t
+#error "valptr_7_t is reserved for interned strings when VALINTERN is defined"
+#endif
+// Interned strings are unique: two interned strings (from the same pool) are equal iff they are identical.
+// Like buffers, the first field is a char * so that they can be used where a string is expected.
+struct valptr_7_s {
+  char     *str;
+  uint32_t  hash;    // The same value `valhash()` would compute on `str`
+  uint32_t  len;
+  uint64_t  prefix;  // The first 8 bytes (NUL padded) as a big endian number: same order of `strcmp()`
+};
+#define VALPTR_INTERN VALPTR_7
+#define val_is_interned(x) (((x).v & VAL_TYPE_MASK) == VALPTR_INTERN)
+#define valisinterned(x) val_is_interned(val(x))
+#endif
 
 #ifndef valptr_7_t
 typedef struct valptr_7_s *valptr_7_t; 
@@ -192,7 +268,7 @@ typedef struct valptr_1_s *valptr_1_t;
 typedef struct valptr_0_s *valptr_0_t; 
 #endif
 
-#define val_is_any_ptr(v) (((v).v & VAL_F7_TYPE_MASK) >= VALPTR_VOID)
+#define val_is_any_ptr(x) (((x).v & VAL_F7_TYPE_MASK) >= VALPTR_VOID)
 
 #define valisptr(...) VAL_vrg(val_isptr_v,__VA_ARGS__)
 
@@ -256,7 +332,8 @@ static inline int val_check_taggable_ptr(val_t v) {
   #endif
   
   // It's either a char or void pointer can't be tagged
-  if (((v).v & VAL_TYPE_MASK) <= VALPTR_CHAR)  return 0;
+  uint64_t type = (v).v & VAL_TYPE_MASK;
+  if (type == VALPTR_VOID || type == VALPTR_CHAR)  return 0;
 
   // Any other pointer is taggable
   return 1;
@@ -287,8 +364,19 @@ static char *val_emptystr = "\0\0\0"; // FOUR nul bytes
                                                 // memcpy will (most probably) optimized by the compiler
 static inline val_t val_fromdouble(double v)    {val_t ret; memcpy(&ret,&v,sizeof(val_t)); return ret;}
 static inline val_t val_fromfloat(float f)      {return val_fromdouble((double)f);}
+#ifdef VALNATIVEINT
+static inline val_t val_fromint(int64_t v)      {
+  if (INT32_MIN <= v && v <= INT32_MAX) return ((val_t){VAL_INT32 | (uint32_t)v});
+  return val_fromdouble((double)v);
+}
+static inline val_t val_fromuint(uint64_t v)    {
+  if (v <= INT32_MAX) return ((val_t){VAL_INT32 | (uint32_t)v});
+  return val_fromdouble((double)v);
+}
+#else
 static inline val_t val_fromint(int64_t v)      {return val_fromdouble((double)v);}
 static inline val_t val_fromuint(uint64_t v)    {return val_fromdouble((double)v);}
+#endif
 
 // POINTERS
 
@@ -361,10 +449,10 @@ static const val_t    valnil = {VAL_NIL};
 static inline val_t valnumconst(uint32_t x)  { return ((val_t){ VAL_CONST_0 | x }); }
 
 // This checks if val is any numeric or symbolic const, including valnil, valtrue and valfalse
-#define val_is_any_const(x) ((x.v & VAL_TYPE_MASK) == VAL_CONST_ANY)
+#define val_is_any_const(x) (((x).v & VAL_TYPE_MASK) == VAL_CONST_ANY)
 
 // This checks if val is a numeric const or any of valnil, valtrue and valfalse
-#define val_is_any_NV_const(x) (((v).v & VAL_CONST_NV_MASK) == VAL_CONST_NV)
+#define val_is_any_NV_const(x) (((x).v & VAL_CONST_NV_MASK) == VAL_CONST_NV)
 
 // Booleans and valnil
 static inline val_t val_valconst(val_t v) { return val_is_any_const(v) ? v : valnil;}
@@ -382,7 +470,7 @@ static inline int val_isconst_1(val_t v) {return val_is_any_const(v); }
 
 // Numeric constants
 
-#define val_is_num_const(v) (((v).v & VAL_CONSTTYPE_MASK) == VAL_CONST_0)
+#define val_is_num_const(x) (((x).v & VAL_CONSTTYPE_MASK) == VAL_CONST_0)
 
 #define valisnumconst(...) VAL_vrg(val_isnumconst_,__VA_ARGS__)
 static inline int val_isnumconst_1(val_t v) { 
@@ -420,66 +508,203 @@ typedef struct { char str[VAL_STR_MAX_LEN]; } valstr_t;
   //  "!#$*+-./0123456789:<=>?@ABCDEFXYZ[]_abcdefghijklmnopqrstuvwxyz~"
   // Note that character `\0` is mapped to 63 (0x3F)
 
-static inline val_t valsymconst(char * restrict sym_str) {
-  val_t sym_val = {0};
-
-  static const uint8_t ascii_to_sym[128] = {
-    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
-    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
-    0x3F, 0x00, 0x3F, 0x01, 0x02, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x03, 0x04, 0x3F, 0x05, 0x06, 0x07,
-    0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x3F, 0x13, 0x14, 0x15, 0x16,
-    0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32,
-    0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x1E, 0x1F, 0x20, 0x21, 0x3F, 0x22, 0x3F, 0x23,
-    0x3F, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32,
-    0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3F, 0x3F, 0x3F, 0x3E, 0x3F
-  };
-
-  if (sym_str == NULL || *sym_str == '\0') {
-    sym_val.v = VAL_SYM_NULL;
-    return sym_val;
-  }
+static const uint8_t val_ascii_to_sym[128] = {
+  0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+  0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+  0x3F, 0x00, 0x3F, 0x01, 0x02, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x03, 0x04, 0x3F, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x3F, 0x13, 0x14, 0x15, 0x16,
+  0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32,
+  0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x1E, 0x1F, 0x20, 0x21, 0x3F, 0x22, 0x3F, 0x23,
+  0x3F, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32,
+  0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3F, 0x3F, 0x3F, 0x3E, 0x3F
+};
+
+                                                   //           1         2         3     33  4         5         6  6
+                                                   // 0         0         0         0     67  0         0         0  3
+static const char val_sym_to_ascii[64]            = "!#$*+-./0123456789:<=>?@ABCDEFXYZ[]_abcdefghijklmnopqrstuvwxyz~";
+
+// Symbols are encoded and decoded eight characters at once (with no data dependent branch):
+//   - the (up to) 8 bytes of the string are loaded in a 64-bit word;
+//   - each byte is mapped to its 6-bit code (0x3F is the terminator);
+//   - the bytes after the first terminator are set to 0x3F;
+//   - the eight 6-bit codes are packed in the 48 bits of the payload.
+// With BMI2, packing and unpacking are a single PEXT/PDEP instruction.
+
+#define VAL_SYM_BYTES   ((uint64_t)0x3F3F3F3F3F3F3F3F)
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_MSC_VER)
+  #define VAL_LITTLE_ENDIAN 1
+#else
+  #define VAL_LITTLE_ENDIAN 0
+#endif
 
-  int      shift = 0;
-  uint8_t  c = 0;
-  uint64_t sym_64 = 0;
+#ifdef __BMI2__
+  #include <immintrin.h>
+#endif
 
-  for (int i = 0; i<8 ; i++, shift += 6) {
-    if ((c = ascii_to_sym[*sym_str++ & 0x7F]) == 0x3F) break;
-    sym_64 |= (((uint64_t)c) << shift);
+// Loads the first 8 bytes of `s` (byte `i` in bits 8i..8i+7). No byte past the end of the
+// string is read: once at the NUL, the pointer doesn't advance and the next bytes are 0
+// (without a branch on each character).
+static inline uint64_t val_sym_load(const char *s) {
+  uint64_t x = 0;
+  for (int i = 0; i < 8; i++) {
+    uint64_t c = (uint8_t)*s;
+    x |= c << (8 * i);
+    s += (c != 0);
   }
+  return x;
+}
+
+// Same as `val_sym_load()` when the 8 bytes of `s` can all be read (e.g. the string is
+// in a buffer padded to 8 bytes): they are loaded at once, the bytes after the NUL included.
+static inline uint64_t val_sym_load8(const char *s) {
+#if VAL_LITTLE_ENDIAN
+  uint64_t x;
+  memcpy(&x, s, sizeof(x));
+  return x;
+#else
+  return val_sym_load(s);
+#endif
+}
+
+// Packs the eight 6-bit codes in `c` (one per byte) into the 48-bit payload
+static inline uint64_t val_sym_pack(uint64_t c) {
+  // A byte is 0x3F iff adding 1 sets its bit 6 (codes are below 0x40: no carry)
+  uint64_t t = (c + (uint64_t)0x0101010101010101) & (uint64_t)0x4040404040404040;
+
+  // Set all the bits above the first terminator (none if there is no terminator)
+  c |= (0 - (t & (0 - t))) & VAL_SYM_BYTES;
 
-  // Fill with FF. This is essential for discriminating the other constant sub-types
-  sym_64 |= (VAL_SYM_NULL << shift); 
+#ifdef __BMI2__
+  return _pext_u64(c, VAL_SYM_BYTES);
+#else
+  c = (c & (uint64_t)0x003F003F003F003F) | ((c >> 2) & (uint64_t)0x0FC00FC00FC00FC0);
+  c = (c & (uint64_t)0x00000FFF00000FFF) | ((c >> 4) & (uint64_t)0x00FFF00000FFF000);
+  c = (c & (uint64_t)0x0000000000FFFFFF) | ((c >> 8) & (uint64_t)0x0000FFFFFF000000);
+  return c;
+#endif
+}
+
+// Spreads the 48-bit payload into eight 6-bit codes (one per byte)
+static inline uint64_t val_sym_unpack(uint64_t p) {
+#ifdef __BMI2__
+  return _pdep_u64(p, VAL_SYM_BYTES);
+#else
+  p = (p & (uint64_t)0x0000000000FFFFFF) | ((p << 8) & (uint64_t)0x00FFFFFF00000000);
+  p = (p & (uint64_t)0x00000FFF00000FFF) | ((p << 4) & (uint64_t)0x0FFF00000FFF0000);
+  p = (p & (uint64_t)0x003F003F003F003F) | ((p << 2) & (uint64_t)0x3F003F003F003F00);
+  return p;
+#endif
+}
+
+// The symbol of the 8 bytes in `x` (as loaded by `val_sym_load()`)
+static inline val_t val_sym_encode(uint64_t x) {
+  val_t sym_val;
+  uint64_t c = 0;
+
+  for (int i = 0; i < 64; i += 8)
+    c |= (uint64_t)val_ascii_to_sym[(x >> i) & 0x7F] << i;
 
-  sym_val.v = VAL_SYM_0 | (sym_64 & VAL_PAYLOAD_MASK);
+  // An empty string has only terminators: VAL_SYM_NULL
+  sym_val.v = VAL_SYM_0 | val_sym_pack(c);
   return sym_val;
 }
 
+static inline val_t valsymconst(char * restrict sym_str) {
+  val_t sym_val = {VAL_SYM_NULL};
+
+  if (sym_str == NULL) return sym_val;
+  return val_sym_encode(val_sym_load(sym_str));
+}
+
 static inline valstr_t valsymtostr(val_t v) {
   valstr_t sym_vstr;
-  uint64_t sym_64;
-  char *s_ptr = sym_vstr.str;
 
   if ((((v).v & VAL_TYPE_MASK) == VAL_SYM_0)) {
-                                    //           1         2         3     33  4         5         6  6
-                                    // 0         0         0         0     67  0         0         0  3
-    static const char *sym_to_ascii = "!#$*+-./0123456789:<=>?@ABCDEFXYZ[]_abcdefghijklmnopqrstuvwxyz~";
-    
-    sym_64 = ((v).v & VAL_PAYLOAD_MASK);
-    
-    for (int i=0; i<8; i++, s_ptr++) {
-      if ((*s_ptr = sym_to_ascii[sym_64 & 0x3F]) == '\0') break;
-      sym_64 >>= 6;
-    }
+    uint64_t c = val_sym_unpack((v).v & VAL_PAYLOAD_MASK);
+    for (int i = 0; i < 8; i++) sym_vstr.str[i] = val_sym_to_ascii[(c >> (8 * i)) & 0x3F];
+    sym_vstr.str[8] = '\0';
   }
-  *s_ptr = '\0';
+  else sym_vstr.str[0] = '\0';
   return sym_vstr;
 }
 
+// Symbols as constant expressions.
+// `VALSYM('n','a','m','e')` is the same 64-bit value of `valsymconst("name").v` but it is an integer
+// constant expression: it can be used as a `case` label or to statically initialize a `val_t`:
+//
+//   static const val_t sym_name = {VALSYM('n','a','m','e')};
+//   switch (v.v) { case VALSYM('i','f'): ...  }
+//
+// Characters are the same of `valsymconst()` (with the same upper to lower case mapping) and the
+// symbol ends at the first character that can't be encoded. At most 8 characters are considered.
+
+#define VAL_SYM_ONES ((uint64_t)0x0000FFFFFFFFFFFF)
+
+// Same as `val_ascii_to_sym[(c) & 0x7F]`
+#define VAL_SYM_CODE(c) VAL_SYM_CODE_((c) & 0x7F)
+#define VAL_SYM_CODE_(c) ((uint64_t)(                   \
+     ((c) == '!')               ? 0x00                  \
+   : ((c) == '#')               ? 0x01                  \
+   : ((c) == '$')               ? 0x02                  \
+   : ((c) == '*')               ? 0x03                  \
+   : ((c) == '+')               ? 0x04                  \
+   : ((c) >= '-' && (c) <= ':') ? (c) - '-' + 0x05      \
+   : ((c) >= '<' && (c) <= 'F') ? (c) - '<' + 0x13      \
+   : ((c) >= 'G' && (c) <= 'W') ? (c) - 'G' + 0x2A      \
+   : ((c) >= 'X' && (c) <= '[') ? (c) - 'X' + 0x1E      \
+   : ((c) == ']')               ? 0x22                  \
+   : ((c) == '_')               ? 0x23                  \
+   : ((c) >= 'a' && (c) <= 'z') ? (c) - 'a' + 0x24      \
+   : ((c) == '~')               ? 0x3E                  \
+   :                              0x3F                  ))
+
+// The payload of the symbol starting with `c` followed by the payload `rest` of the next characters
+#define VAL_SYM_NEXT(c, rest) ((VAL_SYM_CODE(c) == 0x3F) ? VAL_SYM_ONES \
+                                                         : ((VAL_SYM_CODE(c) | ((rest) << 6)) & VAL_SYM_ONES))
+
+#define VALSYM(...) VAL_SYM_8(__VA_ARGS__, 0, 0, 0, 0, 0, 0, 0, 0)
+#define VAL_SYM_8(c0, c1, c2, c3, c4, c5, c6, c7, ...)                                             \
+  (VAL_SYM_0 | VAL_SYM_NEXT(c0, VAL_SYM_NEXT(c1, VAL_SYM_NEXT(c2, VAL_SYM_NEXT(c3,                \
+               VAL_SYM_NEXT(c4, VAL_SYM_NEXT(c5, VAL_SYM_NEXT(c6, VAL_SYM_NEXT(c7, VAL_SYM_ONES)))))))))
+
+// Short strings (up to 6 bytes)
+// The bytes are stored from the most significant one, so that two short strings
+// compare as numbers in the same order of `strcmp()`.
+
+// A short string is in FFF9 0100 0000 0000 .. FFF9 FFFF FFFF FFFF
+#define val_is_sstr(x) (((x).v - VAL_SSTR_MIN) < VAL_SSTR_RANGE)
+#define valisshortstr(x) val_is_sstr(val(x))
+
+// Returns the short string with the text of `s`, or `valnil` (and errno set to EINVAL)
+// if `s` is NULL, empty or longer than 6 bytes.
+static inline val_t valshortstr(const char *s) {
+  uint64_t sstr_64 = 0;
+  int i = 0;
+
+  if (s == NULL || *s == '\0') { errno = EINVAL; return valnil; }
+
+  for (; i < VAL_SSTR_LEN && s[i]; i++)
+    sstr_64 |= (uint64_t)(uint8_t)s[i] << (40 - 8 * i);
+
+  if (s[i]) { errno = EINVAL; return valnil; }
+  return ((val_t){VAL_SSTR | sstr_64});
+}
+
+// Copies the text of the short string `v` to `buf` (which must have room for 7 bytes)
+static inline char *val_sstr_get(val_t v, char *buf) {
+  for (int i = 0; i < VAL_SSTR_LEN; i++) buf[i] = (char)((v).v >> (40 - 8 * i));
+  buf[VAL_SSTR_LEN] = '\0';
+  return buf;
+}
+
 // ====== Retrieve values from a val_t variable
 #define valtodouble(v) val_todouble(val(v))
 static inline double val_todouble(val_t v) {
   double d = 0.0; 
+#ifdef VALNATIVEINT
+  if (val_is_int32(v)) return (double)(int32_t)((v).v & VAL_32BIT_MASK);
+#endif
   if (val_isnumber(v)) memcpy(&d,&v,sizeof(double));
   else errno = EINVAL;
   return d;
@@ -487,6 +712,9 @@ static inline double val_todouble(val_t v) {
 
 #define valtoint(v)  val_toint(val(v))
 static inline int64_t val_toint(val_t v) {
+#ifdef VALNATIVEINT
+  if (val_is_int32(v)) return (int32_t)((v).v & VAL_32BIT_MASK);
+#endif
   if (val_isnumber(v)) {
     double d;
     memcpy(&d,&v,sizeof(double));
@@ -534,6 +762,10 @@ static inline valstr_t val_tostr_2(val_t v, char *fmt) {
          ret = valsymtostr(v);
   else if (val_is_num_const(v))
          snprintf(ret.str, VAL_STR_MAX_LEN, fmt? fmt : "<%" PRIX32 ">", (uint32_t)valtoint(v));
+  else if (val_is_sstr(v)) {
+         char sstr_buf[VAL_SSTR_LEN + 1];
+         snprintf(ret.str, VAL_STR_MAX_LEN, fmt? fmt : "%s", val_sstr_get(v, sstr_buf));
+  }
   else if (val_is_any_ptr(v))
          snprintf(ret.str, VAL_STR_MAX_LEN, fmt? fmt : "%p", valtoptr(v));
   else if (valisbool(v))
@@ -555,24 +787,99 @@ static inline valstr_t val_tostr_2(val_t v, char *fmt) {
 static inline char *val_get_charptr(val_t v) {
   char *ret = val_emptystr;
   if (valischarptr(v)) ret = valtoptr(v);
-  else if (valisbufptr(v)) {
+  else if (valisbufptr(v)
+#ifdef VALINTERN
+           || val_is_interned(v)
+#endif
+          ) {
     char **v_ptr = valtoptr(v);
     ret = v_ptr ? *v_ptr : NULL;
   }
   return ret;
 }
 
+// Same as `val_get_charptr()` but short strings are copied to `buf` (with room for 7 bytes)
+static inline char *val_get_strptr(val_t v, char *buf) {
+  return val_is_sstr(v) ? val_sstr_get(v, buf) : val_get_charptr(v);
+}
+
+#ifdef VALSTDBUF
+// Same as `val_get_strptr()`, also returning in `len` the length of the string (0 for NULL)
+static inline char *val_get_strlen(val_t v, char *buf, size_t *len) {
+  char *s;
+  if (valisbufptr(v)) {
+    valptr_buf_t b = valtoptr(v);
+    s    = b ? b->buf : NULL;
+    *len = s ? b->len : 0;
+    return s;
+  }
+  s    = val_get_strptr(v, buf);
+  *len = (s && s != val_emptystr) ? strlen(s) : 0;
+  return s;
+}
+
+// FNV1a on the `len` bytes of the buffer (the same of `char *` if there's no NUL byte).
+// The hash is not stored in the buffer: `val_hash()` does it.
+static inline uint32_t val_buf_hash(valptr_buf_t b) {
+  uint32_t hash = (uint32_t)0X811C9DC5;
+  for (size_t i = 0; i < b->len; i++) {
+    hash ^= (uint32_t)(b->buf[i]);
+    hash *= (uint32_t)0x01000193;
+  }
+  return hash;
+}
+#endif
+
 // This compares two val_t values. Like the hash function below, it is provide just for convenience 
 // since your criteria for comparison and hashing might be different.
 #define valcmp(a,b) val_cmp(val(a),val(b))
 static inline int val_cmp(val_t a, val_t b) {
   char *sa = val_emptystr;
   char *sb = val_emptystr;
+  char  buf_a[VAL_SSTR_LEN + 1];
+  char  buf_b[VAL_SSTR_LEN + 1];
+
+  // Short strings are in the same order of their text
+  if (val_is_sstr(a) && val_is_sstr(b)) return (a.v > b.v) - (a.v < b.v);
+
+#ifdef VALINTERN
+  // Interned strings are equal iff they are the same string (regardless of the tag)
+  if (val_is_interned(a) && val_is_interned(b)) {
+    valptr_7_t pa = valtoptr(a);
+    valptr_7_t pb = valtoptr(b);
+    if (pa == pb) return 0;
+    if (pa && pb) {
+      if (pa->prefix != pb->prefix) return (pa->prefix > pb->prefix) - (pa->prefix < pb->prefix);
+      return strcmp(pa->str, pb->str);
+    }
+  }
+#endif
+
+#ifdef VALSTDBUF
+  // Standard buffers are compared on their length (embedded NULs included)
+  if (valisbufptr(a) || valisbufptr(b)) {
+    size_t la, lb;
+    sa = val_get_strlen(a, buf_a, &la);
+    sb = val_get_strlen(b, buf_b, &lb);
+    if (sa != val_emptystr && sb != val_emptystr) {
+      int c = (la && lb) ? memcmp(sa, sb, la < lb ? la : lb) : 0;
+      return c ? (c > 0) - (c < 0) : (la > lb) - (la < lb);
+    }
+  }
+#endif
 
-  sa = val_get_charptr(a);
+#ifdef VALNATIVEINT
+  if (val_is_int32(a) && val_is_int32(b)) {
+    int32_t ia = (int32_t)((a).v & VAL_32BIT_MASK);
+    int32_t ib = (int32_t)((b).v & VAL_32BIT_MASK);
+    return (ia > ib) - (ia < ib);
+  }
+#endif
+
+  sa = val_get_strptr(a, buf_a);
   
   if (sa != val_emptystr) {
-    sb = val_get_charptr(b);
+    sb = val_get_strptr(b, buf_b);
 
     if (sb != val_emptystr) {
       if (sa == NULL) sa = val_emptystr; // / To avoid calling strcmp
@@ -591,15 +898,220 @@ static inline int val_cmp(val_t a, val_t b) {
   if (valisnumber(a)) return -1; // / Numbers are lower than
   if (valisnumber(b)) return  1; // \ any other type
 
+  // Short (and interned) strings are ordered as `char *` against the other types
+  if (val_is_sstr(a)) a.v = VALPTR_CHAR | (a.v & VAL_PAYLOAD_MASK);
+  if (val_is_sstr(b)) b.v = VALPTR_CHAR | (b.v & VAL_PAYLOAD_MASK);
+#ifdef VALINTERN
+  if (val_is_interned(a)) a.v = VALPTR_CHAR | (a.v & VAL_PAYLOAD_MASK);
+  if (val_is_interned(b)) b.v = VALPTR_CHAR | (b.v & VAL_PAYLOAD_MASK);
+#endif
+
   return (a.v > b.v)? 1 : (a.v < b.v) ? -1 : 0 ;
 }
 
+// ==== Specialized comparisons
+// Same result of `val_cmp()` on two values of the same kind, without checking for the other types:
+//
+//   valcmp_num(a,b)  Numbers (including native integers)
+//   valcmp_str(a,b)  Strings: char *, buffers, short strings and interned strings
+//   valcmp_sym(a,b)  Constants: symbols, booleans, nil and numeric constants (ordered by their bits)
+//
+// The result is undefined for values of other kinds. To check a whole array at once,
+// see `valcmpkind_n()` in `valbatch.h`.
+
+#define valcmp_num(a,b) val_cmp_num(val(a),val(b))
+static inline int val_cmp_num(val_t a, val_t b) {
+  double da, db;
+#ifdef VALNATIVEINT
+  if (val_is_int32(a) || val_is_int32(b)) {
+    if (val_is_int32(a) && val_is_int32(b)) {
+      int32_t ia = (int32_t)((a).v & VAL_32BIT_MASK);
+      int32_t ib = (int32_t)((b).v & VAL_32BIT_MASK);
+      return (ia > ib) - (ia < ib);
+    }
+    da = val_todouble(a);
+    db = val_todouble(b);
+    return (da > db) - (da < db);
+  }
+#endif
+  memcpy(&da, &a, sizeof(double));
+  memcpy(&db, &b, sizeof(double));
+  return (da > db) - (da < db);
+}
+
+#define valcmp_str(a,b) val_cmp_str(val(a),val(b))
+static inline int val_cmp_str(val_t a, val_t b) {
+  char  buf_a[VAL_SSTR_LEN + 1];
+  char  buf_b[VAL_SSTR_LEN + 1];
+
+  if (val_is_sstr(a) && val_is_sstr(b)) return (a.v > b.v) - (a.v < b.v);
+
+#ifdef VALINTERN
+  if (val_is_interned(a) && val_is_interned(b)) return val_cmp(a, b);
+#endif
+#ifdef VALSTDBUF
+  if (valisbufptr(a) || valisbufptr(b)) return val_cmp(a, b);
+#endif
+
+  char *sa = val_get_strptr(a, buf_a);
+  char *sb = val_get_strptr(b, buf_b);
+  if (sa == NULL) sa = val_emptystr;
+  if (sb == NULL) sb = val_emptystr;
+  return strcmp(sa, sb);
+}
+
+#define valcmp_sym(a,b) val_cmp_sym(val(a),val(b))
+static inline int val_cmp_sym(val_t a, val_t b) {
+  return (a.v > b.v) - (a.v < b.v);
+}
+
+// ==== Sort keys
+// `valsortkey()` maps a value to a 64-bit unsigned integer in the same order of `val_cmp()`:
+//
+//   0000 ..           FFF0 0000 0000 0000  Numbers (-inf .. +inf): the bits of the double with the
+//                                          sign flipped (and the other bits as well if negative).
+//                                          -0.0 has the same key of 0.0
+//   FFF0 0000 0000 0001                    NaN (for `val_cmp()` it is equal to any number)
+//   FFF1 ..           FFF8 FFFF FFFF FFFF  Other values with prefix 7FF9 .. 7FFF, FFF9
+//   FFF9 ..           FFFA FFFF FFFF FFFF  Strings: the first 6 bytes (as a big endian number) followed
+//                                          by one bit set if they are not the whole string
+//   FFFB ..           FFFE FFFF FFFF FFFF  Other values with prefix FFFC .. FFFF
+//
+// The strings are char *, buffers, short strings and interned strings (that `val_cmp()` orders
+// by their text among them, and as char * against the other values).
+//
+// If the keys of two values are different, the values are in the same order of their keys.
+// If they are the same, the values are equal unless `valsortkeytie()` is true on the key:
+// the two strings start with the same 6 bytes and only `val_cmp()` can tell their order.
+//
+// For example, a comparator for `qsort()`:
+//
+//   uint64_t ka = valsortkey(a), kb = valsortkey(b);
+//   if (ka != kb) return (ka > kb) - (ka < kb);
+//   return valsortkeytie(ka) ? valcmp(a, b) : 0;
+
+#define VAL_SORTKEY_NAN       ((uint64_t)0xFFF0000000000001)
+#define VAL_SORTKEY_STR       ((uint64_t)0xFFF9000000000000)
+#define VAL_SORTKEY_STR_RANGE ((uint64_t)0x0002000000000000)
+#define VAL_SORTKEY_LEN       6
+
+static inline uint64_t val_bswap64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_bswap64(x);
+#else
+  x = ((x & (uint64_t)0x00FF00FF00FF00FF) << 8)  | ((x >> 8)  & (uint64_t)0x00FF00FF00FF00FF);
+  x = ((x & (uint64_t)0x0000FFFF0000FFFF) << 16) | ((x >> 16) & (uint64_t)0x0000FFFF0000FFFF);
+  return (x << 32) | (x >> 32);
+#endif
+}
+
+// The key of a number (as a double)
+static inline uint64_t val_sortkey_num(uint64_t x) {
+  if ((x & ~(uint64_t)0x8000000000000000) > (uint64_t)0x7FF0000000000000) return VAL_SORTKEY_NAN;
+  if ((x << 1) == 0) x = 0;  // -0.0
+  return x ^ ((uint64_t)((int64_t)x >> 63) | (uint64_t)0x8000000000000000);
+}
+
+// The key of the string `s` (as returned by `val_get_charptr()`) of the value `v`
+static inline uint64_t val_sortkey_str(val_t v, const char *s) {
+  uint64_t p   = 0;  // The first 6 bytes (big endian)
+  uint64_t tie = 0;  // There are more bytes after them
+
+#ifdef VALINTERN
+  if (val_is_interned(v) && s) {
+    valptr_7_t i = valtoptr(v);
+    return VAL_SORTKEY_STR + ((i->prefix >> 16) << 1) + (i->len > VAL_SORTKEY_LEN);
+  }
+#endif
+
+#ifdef VALSTDBUF
+  // Buffers can contain NUL bytes: a NUL in the first 6 bytes is not the end of the buffer
+  if (valisbufptr(v) && s) {
+    valptr_buf_t b = valtoptr(v);
+    size_t len = b->len < VAL_SORTKEY_LEN ? b->len : VAL_SORTKEY_LEN;
+    for (size_t i = 0; i < len; i++) p |= (uint64_t)(uint8_t)s[i] << (40 - 8 * i);
+    tie = (b->len > VAL_SORTKEY_LEN) || (len && memchr(s, 0, len) != NULL);
+    return VAL_SORTKEY_STR + (p << 1) + tie;
+  }
+#endif
+
+  if (s) {
+    uint64_t x = val_sym_load(s);  // Bytes 0-7 (byte `i` in bits 8i..8i+7)
+    uint64_t z = (x - (uint64_t)0x0101010101010101) & ~x & (uint64_t)0x8080808080808080;
+    z  &= 0 - z;                    // The first NUL byte (the others might not be exact)
+    tie = ((z & (uint64_t)0x0080808080808080) == 0);
+    x  &= (z >> 7) - 1;             // Clear the NUL and the bytes after it
+    p   = val_bswap64(x) >> 16;
+  }
+  return VAL_SORTKEY_STR + (p << 1) + tie;
+}
+
+#define valsortkey(x) val_sortkey(val(x))
+static inline uint64_t val_sortkey(val_t v) {
+  if (val_is_sstr(v)) return VAL_SORTKEY_STR + (((v).v & VAL_PAYLOAD_MASK) << 1);
+
+#ifdef VALNATIVEINT
+  if (val_is_int32(v)) return val_sortkey_num(val_fromdouble((double)(int32_t)((v).v & VAL_32BIT_MASK)).v);
+#endif
+
+  if (val_isnumber(v)) return val_sortkey_num((v).v);
+
+  char *s = val_get_charptr(v);
+  if (s != val_emptystr) return val_sortkey_str(v, s);
+
+  // Prefixes 7FF9..7FFF and FFF9..FFFF are mapped to 1..14 (in the top 16 bits after FFF0)
+  uint64_t sign = (v).v >> 63;
+  return (VAL_SORTKEY_NAN - 1) + ((v).v & (uint64_t)0x0007FFFFFFFFFFFF) + (sign << 51) - (sign << 48);
+}
+
+// True if the values with the key `k` must be compared with `val_cmp()` to be ordered
+static inline int valsortkeytie(uint64_t k) {
+  return ((k - VAL_SORTKEY_STR) < VAL_SORTKEY_STR_RANGE) & (int)(k & 1);
+}
+
+// 64→64-bit MurmurHash3 “fmix” finalizer (upper 32 bits)
+static inline uint32_t val_fmix(uint64_t h) {
+  h ^= h >> 33;
+  h *= (uint64_t)0XFF51AFD7ED558CCD;
+  h ^= h >> 33;
+  h *= (uint64_t)0XC4CEB9FE1A85EC53;
+  h ^= h >> 33;
+  return (uint32_t)(h >> 32);
+}
+
 #define valhash(a) val_hash(val(a))
 static inline uint32_t val_hash(val_t v) {
   uint32_t hash = (uint32_t)0X811C9DC5; // FNV1a INIT
 
   char *s = val_emptystr;
 
+  // Same hash of the `char *` with the same text (computed on the payload)
+  if (val_is_sstr(v)) {
+    for (uint64_t b = (v).v << 16; b; b <<= 8) {  // The bytes after the last one are 0
+      hash ^= (uint32_t)(char)(b >> 56);
+      hash *= (uint32_t)0x01000193;
+    }
+    return hash;
+  }
+
+#ifdef VALINTERN
+  if (val_is_interned(v)) {
+    valptr_7_t p = valtoptr(v);
+    if (p) return p->hash;
+  }
+#endif
+
+#ifdef VALSTDBUF
+  // The hash is computed once (and is reset by the functions in `valbuf.h` when the buffer changes)
+  if (valisbufptr(v)) {
+    valptr_buf_t b = valtoptr(v);
+    if (b && b->buf) {
+      if (b->hash == 0) b->hash = val_buf_hash(b);
+      return b->hash;
+    }
+  }
+#endif
+
   s = val_get_charptr(v);
 
   if (s != val_emptystr && s != NULL) {
@@ -609,17 +1121,12 @@ static inline uint32_t val_hash(val_t v) {
       hash *= (uint32_t)0x01000193; // FNV1a PRIME
     }
   }
-  else {
-    uint64_t h = (v).v;
-    /* 64→64-bit MurmurHash3 “fmix” finalizer */
-    h ^= h >> 33;
-    h *= (uint64_t)0XFF51AFD7ED558CCD;
-    h ^= h >> 33;
-    h *= (uint64_t)0XC4CEB9FE1A85EC53;
-    h ^= h >> 33;
-
-    hash = (uint32_t)(h >> 32);
-  }
+#ifdef VALNATIVEINT
+  // Same hash of the equivalent double so that `valhash(3) == valhash(3.0)`
+  else if (val_is_int32(v)) hash = val_fmix(val_fromdouble((double)(int32_t)((v).v & VAL_32BIT_MASK)).v);
+#endif
+  else hash = val_fmix((v).v);
+
   return hash;
 }
 
@@ -0,0 +1,215 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Region allocator for short-lived values.
+//
+// An arena hands out memory from large chunks by moving a pointer forward: there is
+// no `free()` for the single allocations, the whole arena is reset (and its memory
+// reused) or released at once. Strings and buffers can be allocated directly in the
+// arena and returned as `val_t`.
+//
+// Chunks start at the size given to `valarenanew()` and double (up to 64 times that
+// size) as more are needed. They are kept when the arena is reset, so that resetting
+// takes constant time and a reused arena doesn't allocate anything. Allocations larger
+// than a quarter of a chunk get a block of their own, which is released on reset.
+//
+// An arena must not be used by more than one thread at the same time: `valarenalocal()`
+// returns an arena for the calling thread.
+
+#ifndef VALARENA_VERSION
+#define VALARENA_VERSION 0x0004009C
+
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "val.h"
+
+#define VALARENA_CHUNK  65536   // Default size of the first chunk
+#define VALARENA_GROWTH 64      // Chunks grow up to this many times the first one
+#define VALARENA_ALIGN  (alignof(val_align_t))
+
+typedef struct valarena_chunk_s {
+  struct valarena_chunk_s *next;
+  size_t                   size;   // Bytes in `data`
+  val_align_t              data[];
+} valarena_chunk_t;
+
+typedef struct valarena_s {
+  char             *pos;        // Next free byte of the current chunk
+  char             *end;        // End of the current chunk
+  valarena_chunk_t *cur;        // Current chunk
+  valarena_chunk_t *first;      // All the chunks (in order of use)
+  valarena_chunk_t *large;      // Blocks for the large allocations
+  size_t            chunk;      // Size of the first chunk
+} *valarena_t;
+
+// ==== Arenas
+
+// Returns a new arena whose first chunk has `chunk` bytes (VALARENA_CHUNK if 0). The
+// chunk is allocated on the first allocation. Returns NULL (with errno set to ENOMEM)
+// if there's no memory.
+static inline valarena_t valarenanew(size_t chunk) {
+  valarena_t a = malloc(sizeof(struct valarena_s));
+  if (a == NULL) { errno = ENOMEM; return NULL; }
+  a->pos = a->end = NULL;
+  a->cur = a->first = a->large = NULL;
+  a->chunk = chunk ? chunk : VALARENA_CHUNK;
+  return a;
+}
+
+static inline void valarena_freelist(valarena_chunk_t *c) {
+  while (c) { valarena_chunk_t *next = c->next; free(c); c = next; }
+}
+
+// Releases the arena and everything allocated in it. Returns NULL.
+static inline valarena_t valarenafree(valarena_t a) {
+  if (a) {
+    valarena_freelist(a->first);
+    valarena_freelist(a->large);
+    free(a);
+  }
+  return NULL;
+}
+
+// Releases everything allocated in the arena, keeping the chunks to be reused.
+static inline void valarenareset(valarena_t a) {
+  valarena_freelist(a->large);
+  a->large = NULL;
+  a->cur = a->first;
+  a->pos = a->first ? (char *)a->first->data : NULL;
+  a->end = a->first ? a->pos + a->first->size : NULL;
+}
+
+// Total bytes held by the arena (chunks and large blocks)
+static inline size_t valarenasize(valarena_t a) {
+  size_t n = 0;
+  for (valarena_chunk_t *c = a->first; c; c = c->next) n += c->size;
+  for (valarena_chunk_t *c = a->large; c; c = c->next) n += c->size;
+  return n;
+}
+
+// ==== Allocations
+
+// Moves to the next chunk (or gets a large block) for `size` bytes. Chunks and blocks
+// are aligned to VALARENA_ALIGN.
+static inline void *valarena_slow(valarena_t a, size_t size) {
+  if (size > a->chunk / 4) {
+    valarena_chunk_t *c = malloc(sizeof(valarena_chunk_t) + size);
+    if (c == NULL) { errno = ENOMEM; return NULL; }
+    c->size = size;
+    c->next = a->large;
+    a->large = c;
+    return c->data;
+  }
+
+  // The chunks kept from before the last reset come first
+  valarena_chunk_t *c = a->cur ? a->cur->next : a->first;
+  if (c == NULL) {
+    size_t sz = a->cur ? 2 * a->cur->size : a->chunk;
+    if (sz > a->chunk * VALARENA_GROWTH) sz = a->chunk * VALARENA_GROWTH;
+    c = malloc(sizeof(valarena_chunk_t) + sz);
+    if (c == NULL) { errno = ENOMEM; return NULL; }
+    c->size = sz;
+    c->next = NULL;
+    if (a->cur) a->cur->next = c;
+    else a->first = c;
+  }
+  a->cur = c;
+  a->pos = (char *)c->data;
+  a->end = a->pos + c->size;
+
+  char *p = a->pos;
+  a->pos = p + size;
+  return p;
+}
+
+static inline void *valarena_alloc(valarena_t a, size_t size, size_t align) {
+  char *p = (char *)(((uintptr_t)a->pos + (align - 1)) & ~(uintptr_t)(align - 1));
+  if (a->pos == NULL || p > a->end || size > (size_t)(a->end - p)) return valarena_slow(a, size);
+  a->pos = p + size;
+  return p;
+}
+
+// Returns `size` bytes aligned as for `malloc()`, or NULL (with errno set to ENOMEM) if
+// there's no memory.
+#define valarenaalloc(a, size) valarena_alloc(a, size, VALARENA_ALIGN)
+
+// ==== Strings and buffers
+
+// Returns a copy of the first `len` bytes of `s` (plus a NUL) as a string, or `valnil`
+// with errno set to ENOMEM.
+static inline val_t valarenastrn(valarena_t a, const char *s, size_t len) {
+  char *p = valarena_alloc(a, len + 1, 1);
+  if (p == NULL) return valnil;
+  if (len) memcpy(p, s, len);
+  p[len] = '\0';
+  return val(p);
+}
+
+// Returns a copy of the string `s` (NULL is the same as "")
+#define valarenastr(a, s) valarena_str(a, s)
+static inline val_t valarena_str(valarena_t a, const char *s) {
+  return valarenastrn(a, s ? s : "", s ? strlen(s) : 0);
+}
+
+// Returns the formatted string (as `sprintf()`), or `valnil` with errno set to ENOMEM
+// (or to EINVAL if the format is not valid).
+static inline val_t valarenafmt(valarena_t a, const char *fmt, ...) {
+  va_list args;
+  char buf[128];
+  va_start(args, fmt);
+  int len = vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  if (len < 0) { errno = EINVAL; return valnil; }
+  if ((size_t)len < sizeof(buf)) return valarenastrn(a, buf, (size_t)len);
+
+  char *p = valarena_alloc(a, (size_t)len + 1, 1);
+  if (p == NULL) return valnil;
+  va_start(args, fmt);
+  vsnprintf(p, (size_t)len + 1, fmt, args);
+  va_end(args);
+  return val(p);
+}
+
+#ifdef VALBUF_VERSION
+// Returns a buffer with a copy of `len` bytes from `data`, or `valnil` with errno set to
+// ENOMEM. The buffer doesn't own its memory: it must not be released with `valbuffree()`
+// and appending to it moves its content to memory out of the arena (that is not released).
+static inline val_t valarenabuf(valarena_t a, const void *data, size_t len) {
+  valbuf_t b = valarena_alloc(a, sizeof(struct valptr_buf_s), VALARENA_ALIGN);
+  char *p = b ? valarena_alloc(a, len + 1, 1) : NULL;
+  if (p == NULL) return valnil;
+  if (len) memcpy(p, data, len);
+  p[len] = '\0';
+  b->buf  = p;
+  b->len  = len;
+  b->cap  = 0;
+  b->hash = 0;
+  return val(b);
+}
+#endif
+
+// ==== Arenas for threads
+
+#if defined(_MSC_VER)
+  #define VALARENA_TLS __declspec(thread)
+#else
+  #define VALARENA_TLS _Thread_local
+#endif
+
+static VALARENA_TLS valarena_t valarena_local;
+
+// Returns the arena of the calling thread, creating it if needed (NULL with errno set to
+// ENOMEM if there's no memory). Each thread must release its own with `valarenalocalfree()`.
+// Note that each source file that includes this header has its own thread arenas.
+static inline valarena_t valarenalocal(void) {
+  if (valarena_local == NULL) valarena_local = valarenanew(0);
+  return valarena_local;
+}
+
+static inline void valarenalocalfree(void) {
+  valarena_local = valarenafree(valarena_local);
+}
+
+#endif // VALARENA_VERSION
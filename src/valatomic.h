@@ -0,0 +1,134 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Atomic val_t slots.
+//
+// A val_t is a single 64-bit word, so it can be shared between threads in a C11
+// `_Atomic uint64_t`: `valatomic_t` wraps one so that it can't be read or written
+// by mistake without these functions.
+//
+// Loads are acquire, stores are release and read-modify-write operations (exchange,
+// compare and swap, add) are acquire-release: a thread that loads a value sees all
+// the writes done by the thread that stored it before storing it. Loads and stores
+// take the memory order as an optional last argument, e.g. `memory_order_relaxed`
+// for statistics counters that don't publish anything.
+//
+// There is no atomic add for doubles in C11: `valatomicfetchadd()` is a CAS loop on
+// the representation of the number. The tag of pointers (see `valtagptr()`) is in
+// the low bits of the value and can be used as a set of mark bits, e.g. to flag the
+// nodes of a lock-free list as deleted: `valatomicmark()` sets them atomically and
+// `valatomiccastag()` changes them only if the slot still points to the same object.
+
+#ifndef VALATOMIC_VERSION
+#define VALATOMIC_VERSION 0x0004009C
+
+#include <stdatomic.h>
+#include "val.h"
+
+typedef struct { _Atomic uint64_t v; } valatomic_t;
+
+// For static (or automatic) slots: valatomic_t a = VALATOMIC_INIT(valnil);
+#define VALATOMIC_INIT(x) {(x).v}
+
+#define valatomicinit(a, x) atomic_init(&(a)->v, val(x).v)
+
+#define valatomiclockfree(a) atomic_is_lock_free(&(a)->v)
+
+// ==== Loads and stores
+
+#define valatomicload(...) VAL_vrg(valatomic_load_,__VA_ARGS__)
+#define valatomic_load_1(a)    valatomic_load(a, memory_order_acquire)
+#define valatomic_load_2(a, o) valatomic_load(a, o)
+static inline val_t valatomic_load(valatomic_t *a, memory_order o) {
+  return (val_t){atomic_load_explicit(&a->v, o)};
+}
+
+#define valatomicstore(...) VAL_vrg(valatomic_store_,__VA_ARGS__)
+#define valatomic_store_2(a, x)    valatomic_store(a, val(x), memory_order_release)
+#define valatomic_store_3(a, x, o) valatomic_store(a, val(x), o)
+static inline void valatomic_store(valatomic_t *a, val_t x, memory_order o) {
+  atomic_store_explicit(&a->v, x.v, o);
+}
+
+// Stores `x` and returns the previous value
+#define valatomicexchange(a, x) valatomic_exchange(a, val(x))
+static inline val_t valatomic_exchange(valatomic_t *a, val_t x) {
+  return (val_t){atomic_exchange_explicit(&a->v, x.v, memory_order_acq_rel)};
+}
+
+// ==== Compare and swap
+
+// Stores `desired` if the value is (identical to) `*expected` and returns 1. Otherwise
+// returns 0 and stores the current value in `*expected`. The weak version can fail even
+// if the value is `*expected` but is faster in loops on some architectures.
+#define valatomiccas(a, e, d)     valatomic_cas(a, e, val(d))
+#define valatomiccasweak(a, e, d) valatomic_casweak(a, e, val(d))
+
+static inline int valatomic_cas(valatomic_t *a, val_t *expected, val_t desired) {
+  return atomic_compare_exchange_strong_explicit(&a->v, &expected->v, desired.v,
+                                                 memory_order_acq_rel, memory_order_acquire);
+}
+
+static inline int valatomic_casweak(valatomic_t *a, val_t *expected, val_t desired) {
+  return atomic_compare_exchange_weak_explicit(&a->v, &expected->v, desired.v,
+                                               memory_order_acq_rel, memory_order_acquire);
+}
+
+// ==== Numbers
+
+// The sum of the number `v` and `n`. Native integers stay integers as long as the
+// result fits in 32 bits (as for `val()`).
+static inline val_t valatomic_sum(val_t v, double n) {
+#ifdef VALNATIVEINT
+  if (val_is_int32(v) && -2147483648.0 <= n && n <= 2147483647.0 && n == (double)(int32_t)n)
+    return val_fromint((int64_t)(int32_t)((v).v & VAL_32BIT_MASK) + (int32_t)n);
+#endif
+  return val_fromdouble(val_todouble(v) + n);
+}
+
+// Adds `n` to the number in the slot and returns the previous value. If the slot doesn't
+// hold a number, it is left unchanged and errno is set to EINVAL.
+#define valatomicfetchadd(a, n) valatomic_fetchadd(a, (double)(n))
+static inline val_t valatomic_fetchadd(valatomic_t *a, double n) {
+  uint64_t cur = atomic_load_explicit(&a->v, memory_order_relaxed);
+  for (;;) {
+    if (!val_isnumber((val_t){cur})) { errno = EINVAL; return (val_t){cur}; }
+    val_t sum = valatomic_sum((val_t){cur}, n);
+    if (atomic_compare_exchange_weak_explicit(&a->v, &cur, sum.v,
+                                              memory_order_acq_rel, memory_order_relaxed))
+      return (val_t){cur};
+  }
+}
+
+// ==== Pointer tags
+
+// Sets the bits of `tag` in the tag of the pointer in the slot (leaving the others as they
+// are) and returns the previous tag. Returns -1 and sets errno to EINVAL if the slot doesn't
+// hold a taggable pointer.
+#define valatomicmark(a, tag)   valatomic_marktag(a, tag, 1)
+#define valatomicunmark(a, tag) valatomic_marktag(a, tag, 0)
+static inline int valatomic_marktag(valatomic_t *a, int tag, int set) {
+  uint64_t cur = atomic_load_explicit(&a->v, memory_order_relaxed);
+  for (;;) {
+    if (val_check_taggable_ptr((val_t){cur}) <= 0) { errno = EINVAL; return -1; }
+    uint64_t bits = (uint64_t)tag & VAL_TAG_MASK;
+    uint64_t nv = set ? (cur | bits) : (cur & ~bits);
+    if (nv == cur) return (int)(cur & VAL_TAG_MASK);
+    if (atomic_compare_exchange_weak_explicit(&a->v, &cur, nv,
+                                              memory_order_acq_rel, memory_order_relaxed))
+      return (int)(cur & VAL_TAG_MASK);
+  }
+}
+
+// Changes the tag of the pointer in the slot from `expected` to `desired` if the slot still
+// holds the pointer `p` (whatever the tag of `p` itself). Returns 1 if the tag was changed,
+// 0 otherwise (the pointer is a different one or its tag is not `expected`).
+#define valatomiccastag(a, p, e, d) valatomic_castag(a, val(p), e, d)
+static inline int valatomic_castag(valatomic_t *a, val_t p, int expected, int desired) {
+  if (val_check_taggable_ptr(p) <= 0) return 0;
+  uint64_t e = val_tagptr_2(p, expected).v;
+  return atomic_compare_exchange_strong_explicit(&a->v, &e, val_tagptr_2(p, desired).v,
+                                                 memory_order_acq_rel, memory_order_acquire);
+}
+
+#endif // VALATOMIC_VERSION
@@ -0,0 +1,860 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Batch operations over arrays of val_t.
+//
+// The functions in this header apply the same tests of `val.h` to a whole
+// array at once. Depending on the target, they use AVX-512, AVX2 or SSE2
+// instructions with a portable scalar code for the remaining elements (or
+// for other architectures). Define VALNOSIMD to only use the scalar code.
+//
+// Results of the `valmask_*` functions are bitmasks: bit `i%64` of the
+// word `bits[i/64]` refers to `src[i]`. The `bits` array must have room
+// for `(n+63)/64` words and the unused bits of the last word are set to 0.
+
+#ifndef VALBATCH_VERSION
+#define VALBATCH_VERSION 0x0004009C
+
+#include "val.h"
+
+#ifndef VALNOSIMD
+  #if defined(__AVX512F__)
+    #define VAL_SIMD 512
+  #elif defined(__AVX2__)
+    #define VAL_SIMD 256
+  #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define VAL_SIMD 128
+  #endif
+#endif
+
+#ifndef VAL_SIMD
+  #define VAL_SIMD 0
+#else
+  #include <immintrin.h>
+#endif
+
+// ==== Type classes
+// The class is determined by the 16-bit type prefix (bit 63 and bits 48-50) of the value.
+
+#define VALCLASS_NUMBER   0   // Any number (including the FPU NaN and native integers)
+#define VALCLASS_CONST    1   // 7FF9 Constants (booleans, nil, numeric and symbolic constants)
+#define VALCLASS_EXT      2   // FFF9 Extensions (short strings) except native integers
+#define VALCLASS_VOIDPTR  3   // 7FFA
+#define VALCLASS_CHARPTR  4   // FFFA
+#define VALCLASS_FILEPTR  5   // 7FFB
+#define VALCLASS_BUFPTR   6   // FFFB
+#define VALCLASS_PTR_7    7   // 7FFC
+#define VALCLASS_PTR_6    8   // FFFC
+#define VALCLASS_PTR_5    9   // 7FFD
+#define VALCLASS_PTR_4   10   // FFFD
+#define VALCLASS_PTR_3   11   // 7FFE
+#define VALCLASS_PTR_2   12   // FFFE
+#define VALCLASS_PTR_1   13   // 7FFF
+#define VALCLASS_PTR_0   14   // FFFF
+
+#define VAL_PREFIX(m) ((uint32_t)((m) >> 48))
+
+// A value is a number if the prefix (without the sign) is below the first constant prefix.
+// This is the same test of `val_isnumber()` as 7FF8/FFF8 (the FPU NaN) are numbers.
+// With VALNATIVEINT, the native integers (FFF9 0000) are numbers as well.
+// For the other values, the three type bits and the sign give the class.
+#define valclassify(x) val_classify(val(x))
+static inline uint8_t val_classify(val_t v) {
+  uint32_t t = (uint32_t)((v).v >> 48);
+  uint32_t c = (((t & 7) << 1) | (t >> 15)) - 1;
+  int  isnum = ((t & 0x7FFF) < VAL_PREFIX(VAL_CONST_ANY))
+#ifdef VALNATIVEINT
+             | val_is_int32(v)
+#endif
+             ;
+  return (uint8_t)(isnum ? VALCLASS_NUMBER : c);
+}
+
+static inline void valclassify_n(const val_t *src, size_t n, uint8_t *types) {
+  size_t i = 0;
+
+#if VAL_SIMD == 512
+  const __m512i m7FFF = _mm512_set1_epi64(0x7FFF);
+  const __m512i mnum  = _mm512_set1_epi64(VAL_PREFIX(VAL_CONST_ANY));
+  const __m512i m7    = _mm512_set1_epi64(7);
+  const __m512i m1    = _mm512_set1_epi64(1);
+#ifdef VALNATIVEINT
+  const __m512i i32m  = _mm512_set1_epi64((long long)VAL_INT32_MASK);
+  const __m512i i32v  = _mm512_set1_epi64((long long)VAL_INT32);
+#endif
+  for (; i < (n & ~(size_t)7); i += 8) {
+    __m512i x = _mm512_loadu_si512((const void *)(src + i));
+    __m512i t = _mm512_srli_epi64(x, 48);
+    __mmask8 isnum = _mm512_cmplt_epu64_mask(_mm512_and_si512(t, m7FFF), mnum);
+#ifdef VALNATIVEINT
+    isnum |= _mm512_cmpeq_epi64_mask(_mm512_and_si512(x, i32m), i32v);
+#endif
+    __m512i c = _mm512_or_si512(_mm512_slli_epi64(_mm512_and_si512(t, m7), 1), _mm512_srli_epi64(t, 15));
+    c = _mm512_maskz_sub_epi64((__mmask8)~isnum, c, m1);
+    _mm_storel_epi64((__m128i *)(types + i), _mm512_cvtepi64_epi8(c));
+  }
+#elif VAL_SIMD == 256
+  const __m256i m7FFF = _mm256_set1_epi64x(0x7FFF);
+  const __m256i mnum  = _mm256_set1_epi64x(VAL_PREFIX(VAL_CONST_ANY));
+  const __m256i m7    = _mm256_set1_epi64x(7);
+  const __m256i m1    = _mm256_set1_epi64x(1);
+  // Move the lowest byte of each 64-bit lane to the first two bytes of each 128-bit half
+  const __m256i pack  = _mm256_setr_epi8(0, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                         0, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+#ifdef VALNATIVEINT
+  const __m256i i32m  = _mm256_set1_epi64x((long long)VAL_INT32_MASK);
+  const __m256i i32v  = _mm256_set1_epi64x((long long)VAL_INT32);
+#endif
+  for (; i < (n & ~(size_t)3); i += 4) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(src + i));
+    __m256i t = _mm256_srli_epi64(x, 48);
+    __m256i isnum = _mm256_cmpgt_epi64(mnum, _mm256_and_si256(t, m7FFF));
+#ifdef VALNATIVEINT
+    isnum = _mm256_or_si256(isnum, _mm256_cmpeq_epi64(_mm256_and_si256(x, i32m), i32v));
+#endif
+    __m256i c = _mm256_or_si256(_mm256_slli_epi64(_mm256_and_si256(t, m7), 1), _mm256_srli_epi64(t, 15));
+    c = _mm256_andnot_si256(isnum, _mm256_sub_epi64(c, m1));
+    c = _mm256_shuffle_epi8(c, pack);
+    uint32_t b = ((uint32_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(c)) & 0xFFFF)
+               | ((uint32_t)_mm_cvtsi128_si32(_mm256_extracti128_si256(c, 1)) << 16);
+    memcpy(types + i, &b, sizeof(b));
+  }
+#elif VAL_SIMD == 128
+  // The prefix fits in the low 32 bits of each lane after the shift, 32-bit compares are enough.
+  const __m128i m7FFF = _mm_set1_epi32(0x7FFF);
+  const __m128i mnum  = _mm_set1_epi32((int)VAL_PREFIX(VAL_CONST_ANY));
+  const __m128i m7    = _mm_set1_epi32(7);
+  const __m128i m1    = _mm_set1_epi32(1);
+#ifdef VALNATIVEINT
+  const __m128i i32v  = _mm_set1_epi32((int)(VAL_INT32 >> 32));
+#endif
+  for (; i + 2 <= n; i += 2) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(src + i));
+    __m128i t = _mm_srli_epi64(x, 48);
+    __m128i isnum = _mm_cmplt_epi32(_mm_and_si128(t, m7FFF), mnum);
+#ifdef VALNATIVEINT
+    // The upper halves are compared, the result is moved to the lower halves
+    isnum = _mm_or_si128(isnum, _mm_shuffle_epi32(_mm_cmpeq_epi32(x, i32v), _MM_SHUFFLE(3, 3, 1, 1)));
+#endif
+    __m128i c = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(t, m7), 1), _mm_srli_epi32(t, 15));
+    c = _mm_andnot_si128(isnum, _mm_sub_epi32(c, m1));
+    types[i]   = (uint8_t)_mm_cvtsi128_si32(c);
+    types[i+1] = (uint8_t)_mm_cvtsi128_si32(_mm_srli_si128(c, 8));
+  }
+#endif
+
+  for (; i < n; i++) types[i] = val_classify(src[i]);
+}
+
+// ==== Bitmasks
+
+static inline int val_popcount64(uint64_t x) {
+  x = x - ((x >> 1) & (uint64_t)0x5555555555555555);
+  x = (x & (uint64_t)0x3333333333333333) + ((x >> 2) & (uint64_t)0x3333333333333333);
+  x = (x + (x >> 4)) & (uint64_t)0x0F0F0F0F0F0F0F0F;
+  return (int)((x * (uint64_t)0x0101010101010101) >> 56);
+}
+
+// This is the kernel for all the bitmask functions. The bit for src[i] is set iff:
+//
+//     ((src[i].v & m1) == v1) && ((src[i].v & m2) != v2)
+//
+// and the result is then inverted if `inv` is not zero.
+// Returns the number of bits set.
+static inline size_t val_mask2_n(const val_t *src, size_t n, uint64_t m1, uint64_t v1,
+                                 uint64_t m2, uint64_t v2, int inv, uint64_t *bits) {
+  size_t count = 0;
+
+#if VAL_SIMD == 512
+  const __m512i vm1 = _mm512_set1_epi64((long long)m1), vv1 = _mm512_set1_epi64((long long)v1);
+  const __m512i vm2 = _mm512_set1_epi64((long long)m2), vv2 = _mm512_set1_epi64((long long)v2);
+#elif VAL_SIMD == 256
+  const __m256i vm1 = _mm256_set1_epi64x((long long)m1), vv1 = _mm256_set1_epi64x((long long)v1);
+  const __m256i vm2 = _mm256_set1_epi64x((long long)m2), vv2 = _mm256_set1_epi64x((long long)v2);
+#elif VAL_SIMD == 128
+  const __m128i vm1 = _mm_set1_epi64x((long long)m1), vv1 = _mm_set1_epi64x((long long)v1);
+  const __m128i vm2 = _mm_set1_epi64x((long long)m2), vv2 = _mm_set1_epi64x((long long)v2);
+#endif
+
+  for (size_t base = 0; base < n; base += 64) {
+    const val_t *p = src + base;
+    size_t   cnt  = (n - base < 64) ? (n - base) : 64;
+    uint64_t word = 0;
+    size_t   i    = 0;
+
+#if VAL_SIMD == 512
+    for (; i + 8 <= cnt; i += 8) {
+      __m512i x = _mm512_loadu_si512((const void *)(p + i));
+      __mmask8 k = _mm512_cmpeq_epi64_mask(_mm512_and_si512(x, vm1), vv1)
+                 & _mm512_cmpneq_epi64_mask(_mm512_and_si512(x, vm2), vv2);
+      word |= (uint64_t)k << i;
+    }
+#elif VAL_SIMD == 256
+    for (; i + 4 <= cnt; i += 4) {
+      __m256i x  = _mm256_loadu_si256((const __m256i *)(p + i));
+      __m256i e1 = _mm256_cmpeq_epi64(_mm256_and_si256(x, vm1), vv1);
+      __m256i e2 = _mm256_cmpeq_epi64(_mm256_and_si256(x, vm2), vv2);
+      word |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_andnot_si256(e2, e1))) << i;
+    }
+#elif VAL_SIMD == 128
+    // SSE2 has no 64-bit compare: two 32-bit halves are equal iff both their compares are.
+    for (; i + 2 <= cnt; i += 2) {
+      __m128i x  = _mm_loadu_si128((const __m128i *)(p + i));
+      __m128i e1 = _mm_cmpeq_epi32(_mm_and_si128(x, vm1), vv1);
+      __m128i e2 = _mm_cmpeq_epi32(_mm_and_si128(x, vm2), vv2);
+      e1 = _mm_and_si128(e1, _mm_shuffle_epi32(e1, _MM_SHUFFLE(2, 3, 0, 1)));
+      e2 = _mm_and_si128(e2, _mm_shuffle_epi32(e2, _MM_SHUFFLE(2, 3, 0, 1)));
+      word |= (uint64_t)_mm_movemask_pd(_mm_castsi128_pd(_mm_andnot_si128(e2, e1))) << i;
+    }
+#endif
+
+    for (; i < cnt; i++)
+      word |= (uint64_t)((((p[i].v & m1) == v1) & ((p[i].v & m2) != v2))) << i;
+
+    if (inv) word = ~word & ((cnt < 64) ? ((((uint64_t)1) << cnt) - 1) : ~(uint64_t)0);
+
+    bits[base / 64] = word;
+    count += (size_t)val_popcount64(word);
+  }
+  return count;
+}
+
+// Values `v` such that `(v.v & mask) == value`
+static inline size_t valmask_n(const val_t *src, size_t n, uint64_t mask, uint64_t value, uint64_t *bits) {
+  return val_mask2_n(src, n, mask, value, 0, 1, 0, bits);
+}
+
+// Same as `val_isnumber()`
+// With VALNATIVEINT, the native integers are added block by block (while they are still in cache).
+static inline size_t valmask_number_n(const val_t *src, size_t n, uint64_t *bits) {
+#ifdef VALNATIVEINT
+  size_t count = 0;
+  for (size_t base = 0; base < n; base += 64) {
+    size_t   cnt = (n - base < 64) ? (n - base) : 64;
+    uint64_t ints;
+    val_mask2_n(src + base, cnt, VAL_NAN_MASK, VAL_NAN_MASK, VAL_DBLNAN_MASK, VAL_DBLNAN_POS, 1, bits + base / 64);
+    val_mask2_n(src + base, cnt, VAL_INT32_MASK, VAL_INT32, 0, 1, 0, &ints);
+    bits[base / 64] |= ints;
+    count += (size_t)val_popcount64(bits[base / 64]);
+  }
+  return count;
+#else
+  return val_mask2_n(src, n, VAL_NAN_MASK, VAL_NAN_MASK, VAL_DBLNAN_MASK, VAL_DBLNAN_POS, 1, bits);
+#endif
+}
+
+// Same as `val_is_any_ptr()`: a NaN with the prefix (without the sign) at or above 7FFA,
+// i.e. with at least one of the bits 49 and 50 set.
+static inline size_t valmask_ptr_n(const val_t *src, size_t n, uint64_t *bits) {
+  return val_mask2_n(src, n, VAL_NAN_MASK, VAL_NAN_MASK, VAL_F7_TYPE_MASK & ~VAL_CONST_ANY, 0, 0, bits);
+}
+
+// Same as `val_issymconst_1()`
+static inline size_t valmask_sym_n(const val_t *src, size_t n, uint64_t *bits) {
+  return val_mask2_n(src, n, VAL_TYPE_MASK, VAL_CONST_ANY, VAL_SYM_MASK, VAL_SYM_NOT, 0, bits);
+}
+
+#define valmask_const_n(src, n, bits)    valmask_n(src, n, VAL_TYPE_MASK, VAL_CONST_ANY, bits)
+#define valmask_bool_n(src, n, bits)     valmask_n(src, n, VAL_CONSTTYPE_MASK, VAL_FALSE, bits)
+#define valmask_nil_n(src, n, bits)      valmask_n(src, n, ~(uint64_t)0, VAL_NIL, bits)
+#define valmask_numconst_n(src, n, bits) valmask_n(src, n, VAL_CONSTTYPE_MASK, VAL_CONST_0, bits)
+#define valmask_charptr_n(src, n, bits)  valmask_n(src, n, VAL_TYPE_MASK, VALPTR_CHAR, bits)
+#define valmask_bufptr_n(src, n, bits)   valmask_n(src, n, VAL_TYPE_MASK, VALPTR_BUF, bits)
+#define valmask_ptrtype_n(src, n, t, bits) valmask_n(src, n, VAL_TYPE_MASK, t, bits)
+
+// Checks bit `i` of a bitmask
+#define valmaskbit(bits, i) (((bits)[(i) / 64] >> ((i) % 64)) & 1)
+
+// ==== Hashing
+
+static inline int val_ctz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(x);
+#else
+  int n = 0;
+  while (!(x & 1)) { x >>= 1; n++; }
+  return n;
+#endif
+}
+
+// Hint that `p` will be read soon (it's not an error if `p` is out of the array)
+#if defined(__GNUC__) || defined(__clang__)
+#define val_prefetch(p) __builtin_prefetch(p)
+#else
+#define val_prefetch(p) ((void)0)
+#endif
+
+// Values that `val_hash()` hashes as strings: char * (FFFA) and buffers (FFFB)
+#define VAL_STRHASH_MASK  (VAL_TYPE_MASK & ~(VALPTR_CHAR ^ VALPTR_BUF))
+#define VAL_STRHASH_VALUE  VALPTR_CHAR
+
+#if VAL_SIMD == 512 && !defined(__AVX512DQ__)
+// No 64-bit multiply without AVX512DQ: (a * b) mod 2^64 from three 32x32 products.
+static inline __m512i val_mullo64_512(__m512i a, uint64_t b) {
+  const __m512i bl = _mm512_set1_epi64((long long)(b & VAL_32BIT_MASK));
+  const __m512i bh = _mm512_set1_epi64((long long)(b >> 32));
+  __m512i cross = _mm512_add_epi64(_mm512_mul_epu32(_mm512_srli_epi64(a, 32), bl), _mm512_mul_epu32(a, bh));
+  return _mm512_add_epi64(_mm512_mul_epu32(a, bl), _mm512_slli_epi64(cross, 32));
+}
+#elif VAL_SIMD == 512
+#define val_mullo64_512(a, b) _mm512_mullo_epi64(a, _mm512_set1_epi64((long long)(b)))
+#elif VAL_SIMD == 256
+static inline __m256i val_mullo64_256(__m256i a, uint64_t b) {
+  const __m256i bl = _mm256_set1_epi64x((long long)(b & VAL_32BIT_MASK));
+  const __m256i bh = _mm256_set1_epi64x((long long)(b >> 32));
+  __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), bl), _mm256_mul_epu32(a, bh));
+  return _mm256_add_epi64(_mm256_mul_epu32(a, bl), _mm256_slli_epi64(cross, 32));
+}
+#endif
+
+// Stores in `hashes[i]` the same value `val_hash(src[i])` would return.
+// The fmix finalizer is computed for all the values at once, then the strings,
+// buffers and short strings (if any) are hashed one by one (as are the interned
+// strings, whose hash is stored with them). Native integers are converted to double before the
+// finalizer (as `val_hash()` does).
+// With SSE2 only, emulating the 64-bit multiplies on two lanes is slower than
+// the scalar code, which is used instead (i.e. `val_hash()` on each value).
+static inline void valhash_n(const val_t *src, size_t n, uint32_t *hashes) {
+#if VAL_SIMD == 512
+  const __m512i smask = _mm512_set1_epi64((long long)VAL_STRHASH_MASK);
+  const __m512i sval  = _mm512_set1_epi64((long long)VAL_STRHASH_VALUE);
+  const __m512i ssmin = _mm512_set1_epi64((long long)VAL_SSTR_MIN);
+  const __m512i ssrng = _mm512_set1_epi64((long long)VAL_SSTR_RANGE);
+#ifdef VALINTERN
+  const __m512i tmask = _mm512_set1_epi64((long long)VAL_TYPE_MASK);
+  const __m512i ival  = _mm512_set1_epi64((long long)VALPTR_INTERN);
+#endif
+#ifdef VALNATIVEINT
+  const __m512i i32m  = _mm512_set1_epi64((long long)VAL_INT32_MASK);
+  const __m512i i32v  = _mm512_set1_epi64((long long)VAL_INT32);
+#endif
+#elif VAL_SIMD == 256
+  const __m256i smask = _mm256_set1_epi64x((long long)VAL_STRHASH_MASK);
+  const __m256i sval  = _mm256_set1_epi64x((long long)VAL_STRHASH_VALUE);
+  // No unsigned 64-bit compare in AVX2: flip the sign bits and use the signed one
+  const __m256i ssmin = _mm256_set1_epi64x((long long)(VAL_SSTR_MIN ^ 0x8000000000000000));
+  const __m256i ssrng = _mm256_set1_epi64x((long long)(VAL_SSTR_RANGE ^ 0x8000000000000000));
+#ifdef VALINTERN
+  const __m256i tmask = _mm256_set1_epi64x((long long)VAL_TYPE_MASK);
+  const __m256i ival  = _mm256_set1_epi64x((long long)VALPTR_INTERN);
+#endif
+  const __m256i hi32  = _mm256_setr_epi32(1, 3, 5, 7, 1, 3, 5, 7);
+#ifdef VALNATIVEINT
+  const __m256i lo32  = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  const __m256i i32m  = _mm256_set1_epi64x((long long)VAL_INT32_MASK);
+  const __m256i i32v  = _mm256_set1_epi64x((long long)VAL_INT32);
+#endif
+#endif
+
+  for (size_t base = 0; base < n; base += 64) {
+    const val_t *p = src + base;
+    uint32_t    *h = hashes + base;
+    size_t     cnt = (n - base < 64) ? (n - base) : 64;
+    size_t       i = 0;
+    uint64_t strbits = 0;   // The strings and buffers in this block
+
+#if VAL_SIMD == 512
+    for (; i + 8 <= cnt; i += 8) {
+      __m512i x = _mm512_loadu_si512((const void *)(p + i));
+      strbits |= (uint64_t)_mm512_cmpeq_epi64_mask(_mm512_and_si512(x, smask), sval) << i;
+      strbits |= (uint64_t)_mm512_cmplt_epu64_mask(_mm512_sub_epi64(x, ssmin), ssrng) << i;
+#ifdef VALINTERN
+      strbits |= (uint64_t)_mm512_cmpeq_epi64_mask(_mm512_and_si512(x, tmask), ival) << i;
+#endif
+#ifdef VALNATIVEINT
+      __mmask8 ints = _mm512_cmpeq_epi64_mask(_mm512_and_si512(x, i32m), i32v);
+      x = _mm512_mask_mov_epi64(x, ints, _mm512_castpd_si512(_mm512_cvtepi32_pd(_mm512_cvtepi64_epi32(x))));
+#endif
+      x = _mm512_xor_si512(x, _mm512_srli_epi64(x, 33));
+      x = val_mullo64_512(x, 0XFF51AFD7ED558CCD);
+      x = _mm512_xor_si512(x, _mm512_srli_epi64(x, 33));
+      x = val_mullo64_512(x, 0XC4CEB9FE1A85EC53);
+      x = _mm512_xor_si512(x, _mm512_srli_epi64(x, 33));
+      _mm256_storeu_si256((__m256i *)(h + i), _mm512_cvtepi64_epi32(_mm512_srli_epi64(x, 32)));
+    }
+#elif VAL_SIMD == 256
+    for (; i + 4 <= cnt; i += 4) {
+      __m256i x = _mm256_loadu_si256((const __m256i *)(p + i));
+      __m256i s = _mm256_cmpeq_epi64(_mm256_and_si256(x, smask), sval);
+      s = _mm256_or_si256(s, _mm256_cmpgt_epi64(ssrng, _mm256_sub_epi64(x, ssmin)));
+#ifdef VALINTERN
+      s = _mm256_or_si256(s, _mm256_cmpeq_epi64(_mm256_and_si256(x, tmask), ival));
+#endif
+      strbits |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(s)) << i;
+#ifdef VALNATIVEINT
+      __m256i ints = _mm256_cmpeq_epi64(_mm256_and_si256(x, i32m), i32v);
+      __m256d d    = _mm256_cvtepi32_pd(_mm256_castsi256_si128(_mm256_permutevar8x32_epi32(x, lo32)));
+      x = _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(x), d, _mm256_castsi256_pd(ints)));
+#endif
+      x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+      x = val_mullo64_256(x, 0XFF51AFD7ED558CCD);
+      x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+      x = val_mullo64_256(x, 0XC4CEB9FE1A85EC53);
+      x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+      _mm_storeu_si128((__m128i *)(h + i), _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(x, hi32)));
+    }
+#endif
+    for (; i < cnt; i++) h[i] = val_hash(p[i]);
+
+    // Strings and buffers are hashed with FNV1a by `val_hash()`
+    while (strbits) {
+      int k = val_ctz64(strbits);
+      h[k] = val_hash(p[k]);
+      strbits &= strbits - 1;
+    }
+  }
+}
+
+// ==== Integers
+
+// Same as `val_isint()` on each value (see `val.h` for the details).
+// Note that variable shifts by more than 63 bits give 0, so only negative
+// counts need to be clamped.
+static inline size_t valisint_n(const val_t *src, size_t n, uint64_t *bits) {
+  size_t count = 0;
+
+#if VAL_SIMD == 512
+  const __m512i zero  = _mm512_setzero_si512();
+  const __m512i one   = _mm512_set1_epi64(1);
+  const __m512i e_all = _mm512_set1_epi64(0x7FF);
+  const __m512i fmask = _mm512_set1_epi64((((int64_t)1) << 52) - 1);
+  const __m512i lead  = _mm512_set1_epi64(((int64_t)1) << 52);
+  const __m512i bias  = _mm512_set1_epi64(1075);
+#elif VAL_SIMD == 256
+  const __m256i zero  = _mm256_setzero_si256();
+  const __m256i one   = _mm256_set1_epi64x(1);
+  const __m256i e_all = _mm256_set1_epi64x(0x7FF);
+  const __m256i fmask = _mm256_set1_epi64x((((int64_t)1) << 52) - 1);
+  const __m256i lead  = _mm256_set1_epi64x(((int64_t)1) << 52);
+  const __m256i bias  = _mm256_set1_epi64x(1075);
+#endif
+
+  for (size_t base = 0; base < n; base += 64) {
+    const val_t *p = src + base;
+    size_t   cnt  = (n - base < 64) ? (n - base) : 64;
+    uint64_t word = 0;
+    size_t   i    = 0;
+
+#if VAL_SIMD == 512
+    for (; i + 8 <= cnt; i += 8) {
+      __m512i  x    = _mm512_loadu_si512((const void *)(p + i));
+      __m512i  e    = _mm512_and_si512(_mm512_srli_epi64(x, 52), e_all);
+      __mmask8 norm = _mm512_cmpneq_epi64_mask(e, zero);
+      __m512i  frac = _mm512_mask_or_epi64(_mm512_and_si512(x, fmask), norm, _mm512_and_si512(x, fmask), lead);
+      __m512i  len  = _mm512_mask_sub_epi64(_mm512_sub_epi64(bias, e), (__mmask8)~norm, _mm512_sub_epi64(bias, e), one);
+      __m512i  mask = _mm512_sub_epi64(_mm512_sllv_epi64(one, _mm512_max_epi64(len, zero)), one);
+      __mmask8 k    = _mm512_testn_epi64_mask(frac, mask) & _mm512_cmpneq_epi64_mask(e, e_all);
+      word |= (uint64_t)k << i;
+    }
+#elif VAL_SIMD == 256
+    for (; i + 4 <= cnt; i += 4) {
+      __m256i x    = _mm256_loadu_si256((const __m256i *)(p + i));
+      __m256i e    = _mm256_and_si256(_mm256_srli_epi64(x, 52), e_all);
+      __m256i subn = _mm256_cmpeq_epi64(e, zero);                                 // -1 for zero/subnormals
+      __m256i frac = _mm256_or_si256(_mm256_and_si256(x, fmask), _mm256_andnot_si256(subn, lead));
+      __m256i len  = _mm256_add_epi64(_mm256_sub_epi64(bias, e), subn);
+      len = _mm256_andnot_si256(_mm256_cmpgt_epi64(zero, len), len);
+      __m256i mask = _mm256_sub_epi64(_mm256_sllv_epi64(one, len), one);
+      __m256i isint = _mm256_andnot_si256(_mm256_cmpeq_epi64(e, e_all),
+                                          _mm256_cmpeq_epi64(_mm256_and_si256(frac, mask), zero));
+      word |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(isint)) << i;
+    }
+#endif
+
+    for (; i < cnt; i++) word |= (uint64_t)val_isint(p[i]) << i;
+
+#ifdef VALNATIVEINT
+    uint64_t ints;
+    val_mask2_n(p, cnt, VAL_INT32_MASK, VAL_INT32, 0, 1, 0, &ints);
+    word |= ints;
+#endif
+
+    bits[base / 64] = word;
+    count += (size_t)val_popcount64(word);
+  }
+  return count;
+}
+
+
+// ==== Symbols
+
+// Same as `valsymconst()` on each string (NULL is the same as "").
+// The strings are loaded as in `valsymconst()`, then mapped and packed in parallel:
+//   - with AVX-512 VBMI, the 128 bytes table is a single `vpermi2b` for 8 symbols;
+//   - with AVX2, the table is split in 8 tables of 16 bytes for `vpshufb`;
+// the 6-bit codes are packed with `vpmaddubsw`/`vpmaddwd` (pairs, then quads).
+static inline void valsymconst_n(char **strs, size_t n, val_t *dst) {
+  size_t i = 0;
+
+#if VAL_SIMD == 512 && defined(__AVX512VBMI__)
+  const __m512i tlo  = _mm512_loadu_si512((const void *)val_ascii_to_sym);
+  const __m512i thi  = _mm512_loadu_si512((const void *)(val_ascii_to_sym + 64));
+  const __m512i term = _mm512_set1_epi8(0x3F);
+  const __m512i w12  = _mm512_set1_epi16(0x4001);      // b0 + 64 * b1
+  const __m512i w24  = _mm512_set1_epi32(0x10000001);  // w0 + 4096 * w1
+  const __m512i lo24 = _mm512_set1_epi64(0x0000000000FFFFFF);
+  const __m512i hi24 = _mm512_set1_epi64(0x0000FFFFFF000000);
+  const __m512i sym0 = _mm512_set1_epi64((long long)VAL_SYM_0);
+  uint64_t tmp[8];
+
+  for (; i < (n & ~(size_t)7); i += 8) {
+    for (int k = 0; k < 8; k++) tmp[k] = strs[i + k] ? val_sym_load(strs[i + k]) : 0;
+
+    // The index bit 6 selects the table, bit 7 is ignored (as `& 0x7F`)
+    __m512i   c = _mm512_permutex2var_epi8(tlo, _mm512_loadu_si512((const void *)tmp), thi);
+
+    // Terminators (and all the bytes after them in each symbol)
+    __mmask64 t = _mm512_cmpeq_epi8_mask(c, term);
+    t |= (t << 1) & 0xFEFEFEFEFEFEFEFE;
+    t |= (t << 2) & 0xFCFCFCFCFCFCFCFC;
+    t |= (t << 4) & 0xF0F0F0F0F0F0F0F0;
+    c = _mm512_mask_mov_epi8(c, t, term);
+
+    c = _mm512_madd_epi16(_mm512_maddubs_epi16(c, w12), w24);
+    c = _mm512_or_si512(_mm512_and_si512(c, lo24), _mm512_and_si512(_mm512_srli_epi64(c, 8), hi24));
+    _mm512_storeu_si512((void *)(dst + i), _mm512_or_si512(c, sym0));
+  }
+#elif VAL_SIMD == 512 || VAL_SIMD == 256
+  const __m256i m0F  = _mm256_set1_epi8(0x0F);
+  const __m256i m07  = _mm256_set1_epi8(0x07);
+  const __m256i term = _mm256_set1_epi8(0x3F);
+  const __m256i w12  = _mm256_set1_epi16(0x4001);
+  const __m256i w24  = _mm256_set1_epi32(0x10000001);
+  const __m256i lo24 = _mm256_set1_epi64x(0x0000000000FFFFFF);
+  const __m256i hi24 = _mm256_set1_epi64x(0x0000FFFFFF000000);
+  const __m256i sym0 = _mm256_set1_epi64x((long long)VAL_SYM_0);
+  __m256i tab[8];
+  uint64_t tmp[4];
+
+  for (int k = 0; k < 8; k++)
+    tab[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(val_ascii_to_sym + 16 * k)));
+
+  for (; i < (n & ~(size_t)3); i += 4) {
+    for (int k = 0; k < 4; k++) tmp[k] = strs[i + k] ? val_sym_load(strs[i + k]) : 0;
+
+    __m256i x  = _mm256_loadu_si256((const __m256i *)tmp);
+    __m256i lo = _mm256_and_si256(x, m0F);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), m07);
+    __m256i c  = _mm256_setzero_si256();
+    for (int k = 0; k < 8; k++)
+      c = _mm256_or_si256(c, _mm256_and_si256(_mm256_shuffle_epi8(tab[k], lo),
+                                              _mm256_cmpeq_epi8(hi, _mm256_set1_epi8((char)k))));
+
+    __m256i t = _mm256_cmpeq_epi8(c, term);
+    t = _mm256_or_si256(t, _mm256_slli_epi64(t, 8));
+    t = _mm256_or_si256(t, _mm256_slli_epi64(t, 16));
+    t = _mm256_or_si256(t, _mm256_slli_epi64(t, 32));
+    c = _mm256_or_si256(c, _mm256_and_si256(t, term));
+
+    c = _mm256_madd_epi16(_mm256_maddubs_epi16(c, w12), w24);
+    c = _mm256_or_si256(_mm256_and_si256(c, lo24), _mm256_and_si256(_mm256_srli_epi64(c, 8), hi24));
+    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_or_si256(c, sym0));
+  }
+#endif
+
+  for (; i < n; i++) dst[i] = valsymconst(strs[i]);
+}
+
+// Same as `valsymtostr()` on each value.
+// The codes are spread to bytes (with `vpmultishiftqb` or shifts) and mapped to
+// characters with `vpermb` (AVX-512 VBMI) or four `vpshufb` (AVX2).
+static inline void valsymtostr_n(const val_t *src, size_t n, valstr_t *dst) {
+  size_t i = 0;
+
+#if VAL_SIMD == 512 && defined(__AVX512VBMI__)
+  const __m512i tab  = _mm512_loadu_si512((const void *)val_sym_to_ascii);
+  const __m512i offs = _mm512_set1_epi64(0x2A241E18120C0600);   // Bit offsets of the codes: 0, 6, ..., 42
+  const __m512i tmsk = _mm512_set1_epi64((long long)VAL_TYPE_MASK);
+  const __m512i sym0 = _mm512_set1_epi64((long long)VAL_SYM_0);
+  uint64_t tmp[8];
+
+  for (; i < (n & ~(size_t)7); i += 8) {
+    __m512i  x    = _mm512_loadu_si512((const void *)(src + i));
+    __mmask8 syms = _mm512_cmpeq_epi64_mask(_mm512_and_si512(x, tmsk), sym0);
+    __m512i  c    = _mm512_permutexvar_epi8(_mm512_multishift_epi64_epi8(offs, x), tab);  // Index bits 6,7 ignored
+    _mm512_storeu_si512((void *)tmp, _mm512_maskz_mov_epi64(syms, c));
+    for (int k = 0; k < 8; k++) { memcpy(dst[i + k].str, tmp + k, 8); dst[i + k].str[8] = '\0'; }
+  }
+#elif VAL_SIMD == 512 || VAL_SIMD == 256
+  const __m256i m0F  = _mm256_set1_epi8(0x0F);
+  const __m256i m03  = _mm256_set1_epi8(0x03);
+  const __m256i tmsk = _mm256_set1_epi64x((long long)VAL_TYPE_MASK);
+  const __m256i sym0 = _mm256_set1_epi64x((long long)VAL_SYM_0);
+  const __m256i pmsk = _mm256_set1_epi64x((long long)VAL_PAYLOAD_MASK);
+  __m256i tab[4];
+  uint64_t tmp[4];
+
+  for (int k = 0; k < 4; k++)
+    tab[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(val_sym_to_ascii + 16 * k)));
+
+  for (; i < (n & ~(size_t)3); i += 4) {
+    __m256i x    = _mm256_loadu_si256((const __m256i *)(src + i));
+    __m256i syms = _mm256_cmpeq_epi64(_mm256_and_si256(x, tmsk), sym0);
+
+    // Same as `val_sym_unpack()`
+    __m256i p = _mm256_and_si256(x, pmsk);
+    p = _mm256_or_si256(_mm256_and_si256(p, _mm256_set1_epi64x(0x0000000000FFFFFF)),
+                        _mm256_and_si256(_mm256_slli_epi64(p, 8), _mm256_set1_epi64x(0x00FFFFFF00000000)));
+    p = _mm256_or_si256(_mm256_and_si256(p, _mm256_set1_epi64x(0x00000FFF00000FFF)),
+                        _mm256_and_si256(_mm256_slli_epi64(p, 4), _mm256_set1_epi64x(0x0FFF00000FFF0000)));
+    p = _mm256_or_si256(_mm256_and_si256(p, _mm256_set1_epi64x(0x003F003F003F003F)),
+                        _mm256_and_si256(_mm256_slli_epi64(p, 2), _mm256_set1_epi64x(0x3F003F003F003F00)));
+
+    __m256i lo = _mm256_and_si256(p, m0F);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(p, 4), m03);
+    __m256i c  = _mm256_setzero_si256();
+    for (int k = 0; k < 4; k++)
+      c = _mm256_or_si256(c, _mm256_and_si256(_mm256_shuffle_epi8(tab[k], lo),
+                                              _mm256_cmpeq_epi8(hi, _mm256_set1_epi8((char)k))));
+
+    _mm256_storeu_si256((__m256i *)tmp, _mm256_and_si256(c, syms));
+    for (int k = 0; k < 4; k++) { memcpy(dst[i + k].str, tmp + k, 8); dst[i + k].str[8] = '\0'; }
+  }
+#endif
+
+  for (; i < n; i++) dst[i] = valsymtostr(src[i]);
+}
+
+// ==== Sort keys
+
+// Stores in `keys[i]` the same value `val_sortkey(src[i])` would return.
+// The keys of numbers and of the other non-string values are computed for all the
+// values at once, then strings (and native integers) are done one by one.
+// With SSE2 only, the scalar code is used.
+static inline void valsortkey_n(const val_t *src, size_t n, uint64_t *keys) {
+#if VAL_SIMD == 512
+  const __m512i smask = _mm512_set1_epi64((long long)VAL_STRHASH_MASK);
+  const __m512i sval  = _mm512_set1_epi64((long long)VAL_STRHASH_VALUE);
+  const __m512i ssmin = _mm512_set1_epi64((long long)VAL_SSTR_MIN);
+  const __m512i ssrng = _mm512_set1_epi64((long long)VAL_SSTR_RANGE);
+#ifdef VALINTERN
+  const __m512i tmask = _mm512_set1_epi64((long long)VAL_TYPE_MASK);
+  const __m512i ival  = _mm512_set1_epi64((long long)VALPTR_INTERN);
+#endif
+#ifdef VALNATIVEINT
+  const __m512i i32m  = _mm512_set1_epi64((long long)VAL_INT32_MASK);
+  const __m512i i32v  = _mm512_set1_epi64((long long)VAL_INT32);
+#endif
+  const __m512i nmask = _mm512_set1_epi64((long long)VAL_F7_TYPE_MASK);
+  const __m512i nval  = _mm512_set1_epi64((long long)VAL_CONST_ANY);
+  const __m512i abs   = _mm512_set1_epi64((long long)0x7FFFFFFFFFFFFFFF);
+  const __m512i inf   = _mm512_set1_epi64((long long)0x7FF0000000000000);
+  const __m512i sign  = _mm512_set1_epi64((long long)0x8000000000000000);
+  const __m512i knan  = _mm512_set1_epi64((long long)VAL_SORTKEY_NAN);
+  const __m512i kbase = _mm512_set1_epi64((long long)(VAL_SORTKEY_NAN - 1));
+  const __m512i omask = _mm512_set1_epi64((long long)0x0007FFFFFFFFFFFF);
+#elif VAL_SIMD == 256
+  const __m256i smask = _mm256_set1_epi64x((long long)VAL_STRHASH_MASK);
+  const __m256i sval  = _mm256_set1_epi64x((long long)VAL_STRHASH_VALUE);
+  const __m256i ssmin = _mm256_set1_epi64x((long long)(VAL_SSTR_MIN ^ 0x8000000000000000));
+  const __m256i ssrng = _mm256_set1_epi64x((long long)(VAL_SSTR_RANGE ^ 0x8000000000000000));
+#ifdef VALINTERN
+  const __m256i tmask = _mm256_set1_epi64x((long long)VAL_TYPE_MASK);
+  const __m256i ival  = _mm256_set1_epi64x((long long)VALPTR_INTERN);
+#endif
+#ifdef VALNATIVEINT
+  const __m256i i32m  = _mm256_set1_epi64x((long long)VAL_INT32_MASK);
+  const __m256i i32v  = _mm256_set1_epi64x((long long)VAL_INT32);
+#endif
+  // All the compared quantities are positive (as signed): the signed compare is enough
+  const __m256i nmask = _mm256_set1_epi64x((long long)VAL_F7_TYPE_MASK);
+  const __m256i nval  = _mm256_set1_epi64x((long long)VAL_CONST_ANY);
+  const __m256i abs   = _mm256_set1_epi64x((long long)0x7FFFFFFFFFFFFFFF);
+  const __m256i inf   = _mm256_set1_epi64x((long long)0x7FF0000000000000);
+  const __m256i sign  = _mm256_set1_epi64x((long long)0x8000000000000000);
+  const __m256i knan  = _mm256_set1_epi64x((long long)VAL_SORTKEY_NAN);
+  const __m256i kbase = _mm256_set1_epi64x((long long)(VAL_SORTKEY_NAN - 1));
+  const __m256i omask = _mm256_set1_epi64x((long long)0x0007FFFFFFFFFFFF);
+  const __m256i zero  = _mm256_setzero_si256();
+#endif
+
+  for (size_t base = 0; base < n; base += 64) {
+    const val_t *p = src + base;
+    uint64_t    *k = keys + base;
+    size_t     cnt = (n - base < 64) ? (n - base) : 64;
+    size_t       i = 0;
+    uint64_t strbits = 0;   // The strings (and native integers) in this block
+
+#if VAL_SIMD == 512
+    for (; i + 8 <= cnt; i += 8) {
+      __m512i x = _mm512_loadu_si512((const void *)(p + i));
+      strbits |= (uint64_t)_mm512_cmpeq_epi64_mask(_mm512_and_si512(x, smask), sval) << i;
+      strbits |= (uint64_t)_mm512_cmplt_epu64_mask(_mm512_sub_epi64(x, ssmin), ssrng) << i;
+#ifdef VALINTERN
+      strbits |= (uint64_t)_mm512_cmpeq_epi64_mask(_mm512_and_si512(x, tmask), ival) << i;
+#endif
+#ifdef VALNATIVEINT
+      strbits |= (uint64_t)_mm512_cmpeq_epi64_mask(_mm512_and_si512(x, i32m), i32v) << i;
+#endif
+      __mmask8 num = _mm512_cmplt_epu64_mask(_mm512_and_si512(x, nmask), nval);
+      __mmask8 nan = _mm512_cmpgt_epu64_mask(_mm512_and_si512(x, abs), inf);
+
+      // Numbers
+      __m512i d  = _mm512_maskz_mov_epi64(_mm512_test_epi64_mask(x, abs), x);  // -0.0 is 0.0
+      __m512i kn = _mm512_xor_si512(d, _mm512_or_si512(_mm512_srai_epi64(d, 63), sign));
+      kn = _mm512_mask_mov_epi64(kn, nan, knan);
+
+      // Other values
+      __m512i s  = _mm512_srli_epi64(x, 63);
+      __m512i ko = _mm512_add_epi64(kbase, _mm512_and_si512(x, omask));
+      ko = _mm512_sub_epi64(_mm512_add_epi64(ko, _mm512_slli_epi64(s, 51)), _mm512_slli_epi64(s, 48));
+
+      _mm512_storeu_si512((void *)(k + i), _mm512_mask_mov_epi64(ko, num, kn));
+    }
+#elif VAL_SIMD == 256
+    for (; i + 4 <= cnt; i += 4) {
+      __m256i x = _mm256_loadu_si256((const __m256i *)(p + i));
+      __m256i t = _mm256_cmpeq_epi64(_mm256_and_si256(x, smask), sval);
+      t = _mm256_or_si256(t, _mm256_cmpgt_epi64(ssrng, _mm256_sub_epi64(x, ssmin)));
+#ifdef VALINTERN
+      t = _mm256_or_si256(t, _mm256_cmpeq_epi64(_mm256_and_si256(x, tmask), ival));
+#endif
+#ifdef VALNATIVEINT
+      t = _mm256_or_si256(t, _mm256_cmpeq_epi64(_mm256_and_si256(x, i32m), i32v));
+#endif
+      strbits |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(t)) << i;
+
+      __m256i num = _mm256_cmpgt_epi64(nval, _mm256_and_si256(x, nmask));
+      __m256i nan = _mm256_cmpgt_epi64(_mm256_and_si256(x, abs), inf);
+
+      // Numbers
+      __m256i d  = _mm256_andnot_si256(_mm256_cmpeq_epi64(_mm256_and_si256(x, abs), zero), x);  // -0.0 is 0.0
+      __m256i kn = _mm256_xor_si256(d, _mm256_or_si256(_mm256_cmpgt_epi64(zero, d), sign));
+      kn = _mm256_blendv_epi8(kn, knan, nan);
+
+      // Other values
+      __m256i s  = _mm256_srli_epi64(x, 63);
+      __m256i ko = _mm256_add_epi64(kbase, _mm256_and_si256(x, omask));
+      ko = _mm256_sub_epi64(_mm256_add_epi64(ko, _mm256_slli_epi64(s, 51)), _mm256_slli_epi64(s, 48));
+
+      _mm256_storeu_si256((__m256i *)(k + i), _mm256_blendv_epi8(ko, kn, num));
+    }
+#endif
+    for (; i < cnt; i++) k[i] = val_sortkey(p[i]);
+
+    while (strbits) {
+      int j = val_ctz64(strbits);
+      k[j] = val_sortkey(p[j]);
+      strbits &= strbits - 1;
+    }
+  }
+}
+
+// ==== Homogeneous arrays
+
+#define VALCMP_ANY 0   // Values of different kinds (or no value at all)
+#define VALCMP_NUM 1   // All numbers: `valcmp_num()`
+#define VALCMP_STR 2   // All strings: `valcmp_str()`
+#define VALCMP_SYM 3   // All constants (symbols, booleans, nil, ...): `valcmp_sym()`
+
+// Returns the kind of all the values in the array (VALCMP_ANY if they are not of the same kind),
+// so that a specialized comparison can be used in place of `val_cmp()`.
+// The scan stops as soon as two values of different kinds are found.
+static inline int valcmpkind_n(const val_t *src, size_t n) {
+  // Not zero as long as all the values seen so far are of that kind
+  uint64_t num = ~(uint64_t)0;
+  uint64_t str = ~(uint64_t)0;
+  uint64_t sym = ~(uint64_t)0;
+
+#if VAL_SIMD == 512
+  const __m512i nmask = _mm512_set1_epi64((long long)VAL_F7_TYPE_MASK);
+  const __m512i nval  = _mm512_set1_epi64((long long)VAL_CONST_ANY);
+  const __m512i smask = _mm512_set1_epi64((long long)VAL_STRHASH_MASK);
+  const __m512i sval  = _mm512_set1_epi64((long long)VAL_STRHASH_VALUE);
+  const __m512i ssmin = _mm512_set1_epi64((long long)VAL_SSTR_MIN);
+  const __m512i ssrng = _mm512_set1_epi64((long long)VAL_SSTR_RANGE);
+  const __m512i tmask = _mm512_set1_epi64((long long)VAL_TYPE_MASK);
+  const __m512i cval  = _mm512_set1_epi64((long long)VAL_CONST_ANY);
+#ifdef VALINTERN
+  const __m512i ival  = _mm512_set1_epi64((long long)VALPTR_INTERN);
+#endif
+#ifdef VALNATIVEINT
+  const __m512i i32m  = _mm512_set1_epi64((long long)VAL_INT32_MASK);
+  const __m512i i32v  = _mm512_set1_epi64((long long)VAL_INT32);
+#endif
+#elif VAL_SIMD == 256
+  // The compared quantities are positive (as signed) except for short strings (sign flipped)
+  const __m256i nmask = _mm256_set1_epi64x((long long)VAL_F7_TYPE_MASK);
+  const __m256i nval  = _mm256_set1_epi64x((long long)VAL_CONST_ANY);
+  const __m256i smask = _mm256_set1_epi64x((long long)VAL_STRHASH_MASK);
+  const __m256i sval  = _mm256_set1_epi64x((long long)VAL_STRHASH_VALUE);
+  const __m256i ssmin = _mm256_set1_epi64x((long long)(VAL_SSTR_MIN ^ 0x8000000000000000));
+  const __m256i ssrng = _mm256_set1_epi64x((long long)(VAL_SSTR_RANGE ^ 0x8000000000000000));
+  const __m256i tmask = _mm256_set1_epi64x((long long)VAL_TYPE_MASK);
+  const __m256i cval  = _mm256_set1_epi64x((long long)VAL_CONST_ANY);
+#ifdef VALINTERN
+  const __m256i ival  = _mm256_set1_epi64x((long long)VALPTR_INTERN);
+#endif
+#ifdef VALNATIVEINT
+  const __m256i i32m  = _mm256_set1_epi64x((long long)VAL_INT32_MASK);
+  const __m256i i32v  = _mm256_set1_epi64x((long long)VAL_INT32);
+#endif
+#endif
+
+  for (size_t base = 0; base < n && (num | str | sym); base += 64) {
+    const val_t *p = src + base;
+    size_t     cnt = (n - base < 64) ? (n - base) : 64;
+    size_t       i = 0;
+    uint64_t    bn = 0, bs = 0, by = 0;
+
+#if VAL_SIMD == 512
+    for (; i + 8 <= cnt; i += 8) {
+      __m512i  x = _mm512_loadu_si512((const void *)(p + i));
+      __mmask8 t = _mm512_cmplt_epu64_mask(_mm512_and_si512(x, nmask), nval);
+#ifdef VALNATIVEINT
+      t |= _mm512_cmpeq_epi64_mask(_mm512_and_si512(x, i32m), i32v);
+#endif
+      bn |= (uint64_t)t << i;
+      t  = _mm512_cmpeq_epi64_mask(_mm512_and_si512(x, smask), sval);
+      t |= _mm512_cmplt_epu64_mask(_mm512_sub_epi64(x, ssmin), ssrng);
+#ifdef VALINTERN
+      t |= _mm512_cmpeq_epi64_mask(_mm512_and_si512(x, tmask), ival);
+#endif
+      bs |= (uint64_t)t << i;
+      t  = _mm512_cmpeq_epi64_mask(_mm512_and_si512(x, tmask), cval);
+      by |= (uint64_t)t << i;
+    }
+#elif VAL_SIMD == 256
+    for (; i + 4 <= cnt; i += 4) {
+      __m256i x = _mm256_loadu_si256((const __m256i *)(p + i));
+      __m256i t = _mm256_cmpgt_epi64(nval, _mm256_and_si256(x, nmask));
+#ifdef VALNATIVEINT
+      t = _mm256_or_si256(t, _mm256_cmpeq_epi64(_mm256_and_si256(x, i32m), i32v));
+#endif
+      bn |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(t)) << i;
+      t = _mm256_cmpeq_epi64(_mm256_and_si256(x, smask), sval);
+      t = _mm256_or_si256(t, _mm256_cmpgt_epi64(ssrng, _mm256_sub_epi64(x, ssmin)));
+#ifdef VALINTERN
+      t = _mm256_or_si256(t, _mm256_cmpeq_epi64(_mm256_and_si256(x, tmask), ival));
+#endif
+      bs |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(t)) << i;
+      t = _mm256_cmpeq_epi64(_mm256_and_si256(x, tmask), cval);
+      by |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(t)) << i;
+    }
+#endif
+    for (; i < cnt; i++) {
+      val_t v = p[i];
+      bn |= (uint64_t)(((v.v & VAL_F7_TYPE_MASK) < VAL_CONST_ANY)
+#ifdef VALNATIVEINT
+                       | val_is_int32(v)
+#endif
+                      ) << i;
+      bs |= (uint64_t)(((v.v & VAL_STRHASH_MASK) == VAL_STRHASH_VALUE) | val_is_sstr(v)
+#ifdef VALINTERN
+                       | val_is_interned(v)
+#endif
+                      ) << i;
+      by |= (uint64_t)((v.v & VAL_TYPE_MASK) == VAL_CONST_ANY) << i;
+    }
+
+    uint64_t all = (cnt == 64) ? ~(uint64_t)0 : (((uint64_t)1 << cnt) - 1);
+    num &= (uint64_t)0 - (bn == all);
+    str &= (uint64_t)0 - (bs == all);
+    sym &= (uint64_t)0 - (by == all);
+  }
+
+  if (n == 0) return VALCMP_ANY;
+  return num ? VALCMP_NUM : str ? VALCMP_STR : sym ? VALCMP_SYM : VALCMP_ANY;
+}
+
+#endif // VALBATCH_VERSION
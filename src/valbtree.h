@@ -0,0 +1,548 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Ordered maps with val_t keys and values (B+trees).
+//
+// Keys and values are stored in the leaves, up to VALBTREE_MAX per node, and the
+// leaves are linked in both directions for range scans. Internal nodes only hold the
+// separators: the first key of each child (but the first one). Next to each key, a node
+// stores its sort key (see `valsortkey()` in `val.h`) so that the search in a node
+// compares plain integers and calls `val_cmp()` only on strings whose keys are tied.
+//
+// Keys are in the order of `valsort()`: keys that are equal for `val_cmp()` (e.g. `0` and
+// `-0.0`, or two strings with the same text) are the same key, while NaNs are after +inf
+// and only match other NaNs.
+//
+// Nodes are taken from blocks of VALBTREE_BLOCK nodes owned by the tree, and the nodes
+// that are released (when two nodes are merged) are kept for later use. As for maps, the
+// tree does not own the keys: strings used as keys must stay valid and unchanged until
+// they are removed.
+
+#ifndef VALBTREE_VERSION
+#define VALBTREE_VERSION 0x0004009C
+
+#include <stdlib.h>
+#include "valbatch.h"
+
+#define VALBTREE_ORDER  32                    // A node is split when it gets to this many keys
+#define VALBTREE_MAX    (VALBTREE_ORDER - 1)  // Max number of keys in a node
+#define VALBTREE_MIN    (VALBTREE_ORDER / 2)  // Min number of keys in a leaf (but the root)
+#define VALBTREE_BLOCK  64                    // Number of nodes allocated at once
+
+// Min number of keys in a node (but the root): splitting an internal node moves a key up
+#define valbtree_min(nd) ((nd)->leaf ? VALBTREE_MIN : VALBTREE_MIN - 1)
+
+typedef struct valbtree_node_s {
+  uint64_t skey[VALBTREE_ORDER];             // The sort keys of the keys
+  val_t    key[VALBTREE_ORDER];
+  union {
+    val_t                   val[VALBTREE_ORDER];        // Leaves: the values
+    struct valbtree_node_s *child[VALBTREE_ORDER + 1];  // Internal nodes: the children
+  };
+  struct valbtree_node_s *prev;              // Leaves: the previous leaf
+  struct valbtree_node_s *next;              // Leaves: the next leaf (and free list link)
+  int count;                                 // Number of keys
+  int leaf;
+} valbtree_node_t;
+
+typedef struct valbtree_blk_s {
+  struct valbtree_blk_s *next;
+  valbtree_node_t        node[VALBTREE_BLOCK];
+} *valbtree_blk_t;
+
+typedef struct valbtree_s {
+  valbtree_node_t *root;     // Always a node (an empty leaf for an empty tree)
+  size_t           count;    // Number of keys in the tree
+  int              height;   // Number of levels (1 if the root is a leaf)
+  valbtree_node_t *free;     // Nodes that can be used
+  size_t           nfree;
+  valbtree_blk_t   blocks;
+} *valbtree_t;
+
+// A position in the tree, between two keys (see `valbtreenext()`)
+typedef struct {
+  valbtree_node_t *node;
+  int i;
+} valbtree_iter_t;
+
+// ==== Nodes
+
+// Makes sure there are `n` nodes to take without allocating memory
+static inline int valbtree_reserve(valbtree_t t, size_t n) {
+  while (t->nfree < n) {
+    valbtree_blk_t b = malloc(sizeof(struct valbtree_blk_s));
+    if (b == NULL) { errno = ENOMEM; return -1; }
+    b->next = t->blocks;
+    t->blocks = b;
+    for (int i = 0; i < VALBTREE_BLOCK; i++) {
+      b->node[i].next = t->free;
+      t->free = &b->node[i];
+    }
+    t->nfree += VALBTREE_BLOCK;
+  }
+  return 0;
+}
+
+// Takes a node (there must be one reserved)
+static inline valbtree_node_t *valbtree_take(valbtree_t t, int leaf) {
+  valbtree_node_t *nd = t->free;
+  t->free = nd->next;
+  t->nfree--;
+  nd->prev  = NULL;
+  nd->next  = NULL;
+  nd->count = 0;
+  nd->leaf  = leaf;
+  return nd;
+}
+
+static inline void valbtree_release(valbtree_t t, valbtree_node_t *nd) {
+  nd->next = t->free;
+  t->free = nd;
+  t->nfree++;
+}
+
+// Compares the key `a` (with sort key `ka`) with the key `b` (with sort key `kb`)
+static inline int valbtree_cmp(uint64_t ka, val_t a, uint64_t kb, val_t b) {
+  if (ka != kb) return (ka > kb) - (ka < kb);
+  return valsortkeytie(ka) ? val_cmp(a, b) : 0;
+}
+
+// Number of keys in `nd` lower than `x` (with sort key `k`), or not higher than `x` if `upper`.
+// The sort keys are all compared (no branches) and the tied ones are checked afterwards.
+static inline int valbtree_rank(const valbtree_node_t *nd, uint64_t k, val_t x, int upper) {
+  int i = 0;
+  for (int j = 0; j < nd->count; j++) i += (nd->skey[j] < k);
+  while (i < nd->count && nd->skey[i] == k) {
+    int c = valsortkeytie(k) ? val_cmp(nd->key[i], x) : 0;
+    if (c > 0 || (c == 0 && !upper)) break;
+    i++;
+  }
+  return i;
+}
+
+// The leaf where `x` is (or would be)
+static inline valbtree_node_t *valbtree_leaf(valbtree_t t, uint64_t k, val_t x) {
+  valbtree_node_t *nd = t->root;
+  while (!nd->leaf) nd = nd->child[valbtree_rank(nd, k, x, 1)];
+  return nd;
+}
+
+// ==== Trees
+
+// Returns a new (empty) tree, NULL and errno set to ENOMEM if there's no memory.
+static inline valbtree_t valbtreenew(void) {
+  valbtree_t t = malloc(sizeof(struct valbtree_s));
+  if (t == NULL) { errno = ENOMEM; return NULL; }
+  t->free   = NULL;
+  t->nfree  = 0;
+  t->blocks = NULL;
+  t->count  = 0;
+  t->height = 1;
+  if (valbtree_reserve(t, 1) < 0) { free(t); return NULL; }
+  t->root = valbtree_take(t, 1);
+  return t;
+}
+
+static inline valbtree_t valbtreefree(valbtree_t t) {
+  if (t) {
+    for (valbtree_blk_t b = t->blocks, next; b; b = next) { next = b->next; free(b); }
+    free(t);
+  }
+  return NULL;
+}
+
+#define valbtreecount(t) ((t) ? (t)->count : 0)
+
+// Returns a pointer to the value associated to the key `k` (or NULL if there is none).
+// The pointer is valid until the next key is added or removed.
+#define valbtreeref(t, k) valbtree_ref(t, val(k))
+static inline val_t *valbtree_ref(valbtree_t t, val_t k) {
+  uint64_t sk = val_sortkey(k);
+  valbtree_node_t *nd = valbtree_leaf(t, sk, k);
+  int i = valbtree_rank(nd, sk, k, 0);
+  if (i < nd->count && valbtree_cmp(nd->skey[i], nd->key[i], sk, k) == 0) return &nd->val[i];
+  return NULL;
+}
+
+#define valbtreehas(t, k) (valbtree_ref(t, val(k)) != NULL)
+
+// Returns the value associated to `k`, or the default (`valnil` if not specified)
+#define valbtreeget(...) VAL_vrg(valbtree_get_,__VA_ARGS__)
+#define valbtree_get_2(t, k)    valbtree_get(t, val(k), valnil)
+#define valbtree_get_3(t, k, d) valbtree_get(t, val(k), val(d))
+static inline val_t valbtree_get(valbtree_t t, val_t k, val_t dflt) {
+  val_t *ref = valbtree_ref(t, k);
+  return ref ? *ref : dflt;
+}
+
+// Inserts the key in the subtree `nd` (there are enough nodes reserved for the splits).
+// If `nd` is split, returns the new node on its right (and the separator in `sk` and `sx`).
+static inline valbtree_node_t *valbtree_ins(valbtree_t t, valbtree_node_t *nd, uint64_t k, val_t x, val_t v,
+                                            uint64_t *sk, val_t *sx) {
+  int i;
+
+  if (nd->leaf) {
+    i = valbtree_rank(nd, k, x, 0);
+    if (i < nd->count && valbtree_cmp(nd->skey[i], nd->key[i], k, x) == 0) { nd->val[i] = v; return NULL; }
+    t->count++;
+  }
+  else {
+    i = valbtree_rank(nd, k, x, 1);
+    valbtree_node_t *right = valbtree_ins(t, nd->child[i], k, x, v, &k, &x);
+    if (right == NULL) return NULL;
+    // The new key is now the separator `x`, with `right` as the child after it
+    memmove(&nd->child[i + 2], &nd->child[i + 1], (size_t)(nd->count - i) * sizeof(valbtree_node_t *));
+    nd->child[i + 1] = right;
+  }
+
+  memmove(&nd->skey[i + 1], &nd->skey[i], (size_t)(nd->count - i) * sizeof(uint64_t));
+  memmove(&nd->key[i + 1],  &nd->key[i],  (size_t)(nd->count - i) * sizeof(val_t));
+  nd->skey[i] = k;
+  nd->key[i]  = x;
+  if (nd->leaf) {
+    memmove(&nd->val[i + 1], &nd->val[i], (size_t)(nd->count - i) * sizeof(val_t));
+    nd->val[i] = v;
+  }
+  if (++nd->count < VALBTREE_ORDER) return NULL;
+
+  // Full: the upper half goes to a new node
+  valbtree_node_t *r = valbtree_take(t, nd->leaf);
+  int h = VALBTREE_ORDER / 2;
+  if (nd->leaf) {
+    r->count = VALBTREE_ORDER - h;
+    memcpy(r->skey, &nd->skey[h], (size_t)r->count * sizeof(uint64_t));
+    memcpy(r->key,  &nd->key[h],  (size_t)r->count * sizeof(val_t));
+    memcpy(r->val,  &nd->val[h],  (size_t)r->count * sizeof(val_t));
+    r->prev = nd;
+    r->next = nd->next;
+    if (nd->next) nd->next->prev = r;
+    nd->next = r;
+    *sk = r->skey[0];
+    *sx = r->key[0];
+  }
+  else {
+    // The key in the middle moves up
+    r->count = VALBTREE_ORDER - h - 1;
+    memcpy(r->skey,  &nd->skey[h + 1],  (size_t)r->count * sizeof(uint64_t));
+    memcpy(r->key,   &nd->key[h + 1],   (size_t)r->count * sizeof(val_t));
+    memcpy(r->child, &nd->child[h + 1], (size_t)(r->count + 1) * sizeof(valbtree_node_t *));
+    *sk = nd->skey[h];
+    *sx = nd->key[h];
+  }
+  nd->count = h;
+  return r;
+}
+
+// Associates the value `v` to the key `k` (replacing the previous value, if any).
+// Returns 0 or -1 (errno set to ENOMEM, with the tree unchanged) if there's no memory.
+#define valbtreeset(t, k, v) valbtree_set(t, val(k), val(v))
+static inline int valbtree_set(valbtree_t t, val_t k, val_t v) {
+  if (valbtree_reserve(t, (size_t)t->height + 1) < 0) return -1;
+
+  uint64_t sk;
+  val_t    sx;
+  valbtree_node_t *right = valbtree_ins(t, t->root, val_sortkey(k), k, v, &sk, &sx);
+  if (right) {
+    valbtree_node_t *root = valbtree_take(t, 0);
+    root->count    = 1;
+    root->skey[0]  = sk;
+    root->key[0]   = sx;
+    root->child[0] = t->root;
+    root->child[1] = right;
+    t->root = root;
+    t->height++;
+  }
+  return 0;
+}
+
+// Fixes the child `i` of `nd` that has less keys than its minimum, taking a key from a
+// sibling or merging it with a sibling.
+static inline void valbtree_fix(valbtree_t t, valbtree_node_t *nd, int i) {
+  valbtree_node_t *c = nd->child[i];
+  valbtree_node_t *l = (i > 0) ? nd->child[i - 1] : NULL;
+  valbtree_node_t *r = (i < nd->count) ? nd->child[i + 1] : NULL;
+
+  if (l && l->count > valbtree_min(l)) {
+    // The last key of the left sibling moves to `c`
+    memmove(&c->skey[1], c->skey, (size_t)c->count * sizeof(uint64_t));
+    memmove(&c->key[1],  c->key,  (size_t)c->count * sizeof(val_t));
+    if (c->leaf) {
+      memmove(&c->val[1], c->val, (size_t)c->count * sizeof(val_t));
+      c->skey[0] = l->skey[l->count - 1];
+      c->key[0]  = l->key[l->count - 1];
+      c->val[0]  = l->val[l->count - 1];
+      nd->skey[i - 1] = c->skey[0];
+      nd->key[i - 1]  = c->key[0];
+    }
+    else {
+      memmove(&c->child[1], c->child, (size_t)(c->count + 1) * sizeof(valbtree_node_t *));
+      c->skey[0]  = nd->skey[i - 1];
+      c->key[0]   = nd->key[i - 1];
+      c->child[0] = l->child[l->count];
+      nd->skey[i - 1] = l->skey[l->count - 1];
+      nd->key[i - 1]  = l->key[l->count - 1];
+    }
+    l->count--;
+    c->count++;
+    return;
+  }
+
+  if (r && r->count > valbtree_min(r)) {
+    // The first key of the right sibling moves to `c`
+    if (c->leaf) {
+      c->skey[c->count] = r->skey[0];
+      c->key[c->count]  = r->key[0];
+      c->val[c->count]  = r->val[0];
+      memmove(r->val, &r->val[1], (size_t)(r->count - 1) * sizeof(val_t));
+    }
+    else {
+      c->skey[c->count]      = nd->skey[i];
+      c->key[c->count]       = nd->key[i];
+      c->child[c->count + 1] = r->child[0];
+      nd->skey[i] = r->skey[0];
+      nd->key[i]  = r->key[0];
+      memmove(r->child, &r->child[1], (size_t)r->count * sizeof(valbtree_node_t *));
+    }
+    memmove(r->skey, &r->skey[1], (size_t)(r->count - 1) * sizeof(uint64_t));
+    memmove(r->key,  &r->key[1],  (size_t)(r->count - 1) * sizeof(val_t));
+    c->count++;
+    r->count--;
+    if (c->leaf) {
+      nd->skey[i] = r->skey[0];
+      nd->key[i]  = r->key[0];
+    }
+    return;
+  }
+
+  // Merge the child `i` (or the one on its left) with the next one
+  if (l) { r = c; c = l; i--; }
+  if (c->leaf) {
+    memcpy(&c->skey[c->count], r->skey, (size_t)r->count * sizeof(uint64_t));
+    memcpy(&c->key[c->count],  r->key,  (size_t)r->count * sizeof(val_t));
+    memcpy(&c->val[c->count],  r->val,  (size_t)r->count * sizeof(val_t));
+    c->count += r->count;
+    c->next = r->next;
+    if (r->next) r->next->prev = c;
+  }
+  else {
+    // The separator comes down between the two
+    c->skey[c->count] = nd->skey[i];
+    c->key[c->count]  = nd->key[i];
+    memcpy(&c->skey[c->count + 1],  r->skey,  (size_t)r->count * sizeof(uint64_t));
+    memcpy(&c->key[c->count + 1],   r->key,   (size_t)r->count * sizeof(val_t));
+    memcpy(&c->child[c->count + 1], r->child, (size_t)(r->count + 1) * sizeof(valbtree_node_t *));
+    c->count += r->count + 1;
+  }
+  memmove(&nd->skey[i], &nd->skey[i + 1], (size_t)(nd->count - i - 1) * sizeof(uint64_t));
+  memmove(&nd->key[i],  &nd->key[i + 1],  (size_t)(nd->count - i - 1) * sizeof(val_t));
+  memmove(&nd->child[i + 1], &nd->child[i + 2], (size_t)(nd->count - i - 1) * sizeof(valbtree_node_t *));
+  nd->count--;
+  valbtree_release(t, r);
+}
+
+// Removes the key from the subtree `nd`. Returns 1 if it was there, 0 otherwise.
+static inline int valbtree_rem(valbtree_t t, valbtree_node_t *nd, uint64_t k, val_t x) {
+  if (nd->leaf) {
+    int i = valbtree_rank(nd, k, x, 0);
+    if (i == nd->count || valbtree_cmp(nd->skey[i], nd->key[i], k, x) != 0) return 0;
+    memmove(&nd->skey[i], &nd->skey[i + 1], (size_t)(nd->count - i - 1) * sizeof(uint64_t));
+    memmove(&nd->key[i],  &nd->key[i + 1],  (size_t)(nd->count - i - 1) * sizeof(val_t));
+    memmove(&nd->val[i],  &nd->val[i + 1],  (size_t)(nd->count - i - 1) * sizeof(val_t));
+    nd->count--;
+    return 1;
+  }
+  int i = valbtree_rank(nd, k, x, 1);
+  if (!valbtree_rem(t, nd->child[i], k, x)) return 0;
+  if (nd->child[i]->count < valbtree_min(nd->child[i])) valbtree_fix(t, nd, i);
+  return 1;
+}
+
+// Removes the key `k`. Returns 1 if the key was in the tree, 0 otherwise.
+#define valbtreedel(t, k) valbtree_del(t, val(k))
+static inline int valbtree_del(valbtree_t t, val_t k) {
+  uint64_t sk = val_sortkey(k);
+  if (!valbtree_rem(t, t->root, sk, k)) return 0;
+  t->count--;
+  if (!t->root->leaf && t->root->count == 0) {
+    valbtree_node_t *root = t->root;
+    t->root = root->child[0];
+    t->height--;
+    valbtree_release(t, root);
+  }
+
+  // The removed key can still be a separator (at most one, on its path): it is replaced
+  // by the first key on its right, so that the caller can release the removed key.
+  valbtree_node_t *nd = t->root;
+  while (!nd->leaf) {
+    int i = valbtree_rank(nd, sk, k, 1);
+    if (i > 0 && valbtree_cmp(nd->skey[i - 1], nd->key[i - 1], sk, k) == 0) {
+      valbtree_node_t *c = nd->child[i];
+      while (!c->leaf) c = c->child[0];
+      nd->skey[i - 1] = c->skey[0];
+      nd->key[i - 1]  = c->key[0];
+      break;
+    }
+    nd = nd->child[i];
+  }
+  return 1;
+}
+
+// Loads the `n` keys in `keys` (sorted as by `valsort()`) with their values in `vals`
+// (or `valnil` if `vals` is NULL) in an empty tree. If there are equal keys, the last
+// value is kept. Leaves are filled up, so the tree takes the least memory and range scans
+// touch the least nodes. Returns 0, or -1 with errno set to ENOMEM if there's no memory
+// or to EINVAL if the tree is not empty or the keys are not sorted (the tree is unchanged).
+static inline int valbtreeload(valbtree_t t, const val_t *keys, const val_t *vals, size_t n) {
+  if (t->count > 0) { errno = EINVAL; return -1; }
+  if (n == 0) return 0;
+
+  uint64_t *sk = malloc(n * sizeof(uint64_t));
+  if (sk == NULL) { errno = ENOMEM; return -1; }
+  valsortkey_n(keys, n, sk);
+
+  // Number of distinct keys
+  size_t m = 1;
+  for (size_t j = 1; j < n; j++) {
+    int c = valbtree_cmp(sk[j - 1], keys[j - 1], sk[j], keys[j]);
+    if (c > 0) { free(sk); errno = EINVAL; return -1; }
+    m += (c != 0);
+  }
+
+  // Number of nodes on each level (children are split evenly among the parents)
+  size_t nodes = 0;
+  for (size_t c = (m + VALBTREE_MAX - 1) / VALBTREE_MAX; ; c = (c + VALBTREE_MAX) / (VALBTREE_MAX + 1)) {
+    nodes += c;
+    if (c == 1) break;
+  }
+
+  // The first node of each level with its first key (for the separators in the parents)
+  valbtree_node_t **lvl = malloc(nodes * (sizeof(valbtree_node_t *) + sizeof(uint64_t) + sizeof(val_t)));
+  if (lvl == NULL || valbtree_reserve(t, nodes) < 0) { free(lvl); free(sk); errno = ENOMEM; return -1; }
+  uint64_t *lsk = (uint64_t *)(lvl + nodes);
+  val_t    *lkx = (val_t *)(lsk + nodes);
+
+  valbtree_release(t, t->root);
+
+  // Leaves
+  size_t nl = (m + VALBTREE_MAX - 1) / VALBTREE_MAX;
+  size_t j = 0;
+  valbtree_node_t *prev = NULL;
+  for (size_t l = 0; l < nl; l++) {
+    valbtree_node_t *nd = valbtree_take(t, 1);
+    size_t cnt = m / nl + (l < m % nl);
+    while ((size_t)nd->count < cnt) {
+      // Equal keys: the last one wins
+      while (j + 1 < n && valbtree_cmp(sk[j], keys[j], sk[j + 1], keys[j + 1]) == 0) j++;
+      nd->skey[nd->count] = sk[j];
+      nd->key[nd->count]  = keys[j];
+      nd->val[nd->count]  = vals ? vals[j] : valnil;
+      nd->count++;
+      j++;
+    }
+    nd->prev = prev;
+    if (prev) prev->next = nd;
+    prev = nd;
+    lvl[l] = nd;
+    lsk[l] = nd->skey[0];
+    lkx[l] = nd->key[0];
+  }
+
+  // Internal levels, up to the root
+  size_t c = nl;
+  t->height = 1;
+  while (c > 1) {
+    size_t np = (c + VALBTREE_MAX) / (VALBTREE_MAX + 1);
+    size_t k = 0;
+    for (size_t p = 0; p < np; p++) {
+      valbtree_node_t *nd = valbtree_take(t, 0);
+      size_t cnt = c / np + (p < c % np);
+      uint64_t fsk = lsk[k];
+      val_t    fkx = lkx[k];
+      nd->child[0] = lvl[k++];
+      for (size_t q = 1; q < cnt; q++, k++) {
+        nd->skey[nd->count]  = lsk[k];
+        nd->key[nd->count]   = lkx[k];
+        nd->child[++nd->count] = lvl[k];
+      }
+      lvl[p] = nd;
+      lsk[p] = fsk;
+      lkx[p] = fkx;
+    }
+    c = np;
+    t->height++;
+  }
+
+  t->root  = lvl[0];
+  t->count = m;
+  free(lvl);
+  free(sk);
+  return 0;
+}
+
+// ==== Iterators
+// An iterator is a position between two keys. `valbtreenext()` returns the key after the
+// position and moves past it, `valbtreeprev()` returns the key before it and moves back:
+//
+//    valbtree_iter_t it = valbtreeseek(t, lo);
+//    while (valbtreenext(&it, &k, &v) && valcmp(k, hi) < 0) { ... }
+//
+// Both return 0 (and don't move) when there are no more keys. Either `k` or `v` can be NULL.
+// Iterators are not valid anymore after keys are added or removed (values can be changed).
+
+// Before the first key
+static inline valbtree_iter_t valbtreefirst(valbtree_t t) {
+  valbtree_node_t *nd = t->root;
+  while (!nd->leaf) nd = nd->child[0];
+  valbtree_iter_t it = {nd, 0};
+  return it;
+}
+
+// After the last key
+static inline valbtree_iter_t valbtreelast(valbtree_t t) {
+  valbtree_node_t *nd = t->root;
+  while (!nd->leaf) nd = nd->child[nd->count];
+  valbtree_iter_t it = {nd, nd->count};
+  return it;
+}
+
+// Before the first key that is not lower than `k`
+#define valbtreeseek(t, k) valbtree_seek(t, val(k))
+static inline valbtree_iter_t valbtree_seek(valbtree_t t, val_t k) {
+  uint64_t sk = val_sortkey(k);
+  valbtree_node_t *nd = valbtree_leaf(t, sk, k);
+  valbtree_iter_t it = {nd, valbtree_rank(nd, sk, k, 0)};
+  return it;
+}
+
+static inline int valbtreenext(valbtree_iter_t *it, val_t *k, val_t *v) {
+  valbtree_node_t *nd = it->node;
+  int i = it->i;
+  while (i >= nd->count) {
+    if (nd->next == NULL) return 0;
+    nd = nd->next;
+    i = 0;
+  }
+  if (k) *k = nd->key[i];
+  if (v) *v = nd->val[i];
+  it->node = nd;
+  it->i = i + 1;
+  return 1;
+}
+
+static inline int valbtreeprev(valbtree_iter_t *it, val_t *k, val_t *v) {
+  valbtree_node_t *nd = it->node;
+  int i = it->i;
+  while (i <= 0) {
+    if (nd->prev == NULL) return 0;
+    nd = nd->prev;
+    i = nd->count;
+  }
+  i--;
+  if (k) *k = nd->key[i];
+  if (v) *v = nd->val[i];
+  it->node = nd;
+  it->i = i;
+  return 1;
+}
+
+#endif // VALBTREE_VERSION
@@ -0,0 +1,106 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Standard buffers.
+//
+// With VALSTDBUF defined, `valptr_buf_t` is a pointer to a buffer that knows its
+// length and keeps its hash (see `struct valptr_buf_s` in `val.h`):
+//
+//   - `valcmp()` uses `memcmp()` on the length of the buffer (that can contain NUL bytes);
+//   - `valhash()` computes the hash only once (and returns it with no scan afterwards);
+//   - in a `VALMAP_SEMANTIC` map, keys with different lengths (or hashes) are not compared.
+//
+// The functions below keep the buffer NUL terminated and reset the hash whenever the
+// content changes. If the content is changed directly, call `valbufchanged()`.
+//
+// This header defines VALSTDBUF and must be included before `val.h` (directly or
+// through other headers) is included, or VALSTDBUF must be defined globally.
+
+#ifndef VALBUF_VERSION
+#define VALBUF_VERSION 0x0004009C
+
+#ifndef VALSTDBUF
+  #ifdef VAL_VERSION
+    #error "Define VALSTDBUF (or include valbuf.h) before including val.h"
+  #endif
+  #define VALSTDBUF
+#endif
+
+#include <stdlib.h>
+#include "val.h"
+
+typedef valptr_buf_t valbuf_t;
+
+#define VALBUF_MIN_CAP 16
+
+// Makes room for `len` bytes (plus the final NUL). Returns 0 or -1 (errno set to ENOMEM).
+static inline int valbuf_grow(valbuf_t b, size_t len) {
+  if (len < b->cap) return 0;
+
+  size_t cap = (b->cap < VALBUF_MIN_CAP) ? VALBUF_MIN_CAP : b->cap;
+  while (cap <= len) cap *= 2;
+
+  // A buffer that doesn't own its memory (cap == 0) gets a copy of it
+  char *buf = b->cap ? realloc(b->buf, cap) : malloc(cap);
+  if (buf == NULL) { errno = ENOMEM; return -1; }
+  if (b->cap == 0 && b->buf && b->len) memcpy(buf, b->buf, b->len);
+  b->buf = buf;
+  b->cap = cap;
+  return 0;
+}
+
+// Returns a new empty buffer with room for `cap` bytes (NULL and errno set to ENOMEM if there's no memory)
+static inline valbuf_t valbufnew(size_t cap) {
+  valbuf_t b = malloc(sizeof(struct valptr_buf_s));
+  if (b == NULL) { errno = ENOMEM; return NULL; }
+  b->buf  = NULL;
+  b->len  = 0;
+  b->cap  = 0;
+  b->hash = 0;
+  if (valbuf_grow(b, cap) < 0) { free(b); return NULL; }
+  b->buf[0] = '\0';
+  return b;
+}
+
+// Releases the buffer. Returns NULL.
+static inline valbuf_t valbuffree(valbuf_t b) {
+  if (b) {
+    if (b->cap) free(b->buf);
+    free(b);
+  }
+  return NULL;
+}
+
+// To be called after changing the content of the buffer directly
+static inline void valbufchanged(valbuf_t b) { b->hash = 0; }
+
+// Appends `len` bytes (that can be NUL). Returns 0 or -1 (errno set to ENOMEM).
+static inline int valbufappend(valbuf_t b, const void *data, size_t len) {
+  if (valbuf_grow(b, b->len + len) < 0) return -1;
+  if (len) memcpy(b->buf + b->len, data, len);
+  b->len += len;
+  b->buf[b->len] = '\0';
+  b->hash = 0;
+  return 0;
+}
+
+// Appends the string `s`
+#define valbufcat(b, s) valbufappend(b, s, strlen(s))
+
+// Returns a new buffer with a copy of `len` bytes from `data`
+static inline valbuf_t valbuffrom(const void *data, size_t len) {
+  valbuf_t b = valbufnew(len);
+  if (b) valbufappend(b, data, len);
+  return b;
+}
+
+// Empties the buffer (without releasing memory). A buffer that doesn't own its memory
+// (cap == 0) only drops it: what it referred to is left unchanged.
+static inline void valbufclear(valbuf_t b) {
+  b->len  = 0;
+  b->hash = 0;
+  if (b->cap == 0) b->buf = "";
+  else if (b->buf) b->buf[0] = '\0';
+}
+
+#endif // VALBUF_VERSION
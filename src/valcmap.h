@@ -0,0 +1,369 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Concurrent hash maps with val_t keys and values.
+//
+// A val_t is a single 64-bit word, so keys and values can be read and changed with
+// C11 atomics. The table uses open addressing with linear probing: a slot is a key
+// and a value, both atomic. A key is set once (with a CAS on an empty slot) and
+// never changes afterwards; the value can be set, replaced or removed with a CAS.
+// Lookups never wait and never write (not even the hash of a buffer used as a key).
+//
+// Empty slots and missing values are marked with sentinels in the reserved part of
+// the NaN space (FFF9 00xx, see `val.h`): they are not valid keys or values.
+//
+//   VALCMAP_EMPTY   Key of a slot that was never used
+//   VALCMAP_NOVAL   Value of a key that is not in the map (never set, or removed)
+//   VALCMAP_MOVED   Key or value of a slot that has been copied to the next table
+//
+// When the table is 3/4 full, a new table is allocated (twice the size, or the same
+// size if most slots hold removed keys) and the slots are copied in chunks of
+// VALCMAP_CHUNK. The threads that want to change the map while the copy is going on
+// claim the chunks that are left and copy them, without waiting for the chunks claimed
+// by the others: a key is changed in the old table until its slot is copied, then in the
+// next one. A copied value is replaced by VALCMAP_MOVED with a CAS, so that a value
+// changed during the copy is copied again, and lookups and updates that find
+// VALCMAP_MOVED go on in the next table. The thread that copies the last slot makes the
+// next table the current one. Old tables are released with the map, as other threads could
+// still be reading them: they take less memory than the current table.
+//
+// The two modes are the same of `valmap.h` (VALMAP_IDENTITY and VALMAP_SEMANTIC).
+// The map does not own the keys: strings used as keys must stay valid and unchanged.
+
+#ifndef VALCMAP_VERSION
+#define VALCMAP_VERSION 0x0004009C
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "valmap.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sched.h>
+#define valcmap_yield() sched_yield()
+#else
+#define valcmap_yield() ((void)0)
+#endif
+
+#define VALCMAP_EMPTY   ((uint64_t)0xFFF9000100000000)
+#define VALCMAP_NOVAL   ((uint64_t)0xFFF9000100000001)
+#define VALCMAP_MOVED   ((uint64_t)0xFFF9000100000002)
+
+#define VALCMAP_MINCAP  64
+#define VALCMAP_CHUNK   1024   // Slots copied at once during a resize
+
+// As the `expected` or `desired` value of `valcmapcas()`: the key is not in the map
+#define valcmapnone ((val_t){VALCMAP_NOVAL})
+
+#define valcmap_issentinel(x) (((x) - VALCMAP_EMPTY) <= (VALCMAP_MOVED - VALCMAP_EMPTY))
+
+typedef struct valcmap_tbl_s {
+  size_t                          cap;      // Number of slots (a power of 2)
+  _Atomic size_t                  used;     // Slots with a key (or reserved for the copy)
+  _Atomic(struct valcmap_tbl_s *) next;     // The table the slots are copied to
+  _Atomic size_t                  claimed;  // Slots claimed to be copied
+  _Atomic size_t                  copied;   // Slots copied
+  struct valcmap_tbl_s           *older;    // The previous table (released with the map)
+  _Atomic uint64_t                slot[];   // Key and value of each slot
+} valcmap_tbl_t;
+
+typedef struct valcmap_s {
+  _Atomic(valcmap_tbl_t *) tbl;     // The current table
+  _Atomic size_t           count;   // Number of keys in the map
+  int                      mode;
+} *valcmap_t;
+
+static inline valcmap_tbl_t *valcmap_tblnew(size_t cap) {
+  valcmap_tbl_t *t = malloc(sizeof(valcmap_tbl_t) + 2 * cap * sizeof(_Atomic uint64_t));
+  if (t == NULL) { errno = ENOMEM; return NULL; }
+  t->cap = cap;
+  atomic_init(&t->used, 0);
+  atomic_init(&t->next, NULL);
+  atomic_init(&t->claimed, 0);
+  atomic_init(&t->copied, 0);
+  t->older = NULL;
+  for (size_t i = 0; i < cap; i++) {
+    atomic_init(&t->slot[2 * i],     VALCMAP_EMPTY);
+    atomic_init(&t->slot[2 * i + 1], VALCMAP_NOVAL);
+  }
+  return t;
+}
+
+#define valcmap_key(t, i) (&(t)->slot[2 * (i)])
+#define valcmap_val(t, i) (&(t)->slot[2 * (i) + 1])
+
+// ==== Resizing
+
+// Stores the value `v` of the key `k` in the table `t` (that is not yet used by the other
+// threads for `k`: only the thread copying the slot of `k` can write it).
+static inline void valcmap_copyto(valcmap_t m, valcmap_tbl_t *t, val_t k, uint64_t h, uint64_t v) {
+  size_t mask = t->cap - 1;
+  for (size_t i = h & mask; ; i = (i + 1) & mask) {
+    uint64_t kk = atomic_load_explicit(valcmap_key(t, i), memory_order_acquire);
+    if (kk == VALCMAP_EMPTY) {
+      if (!atomic_compare_exchange_strong_explicit(valcmap_key(t, i), &kk, k.v,
+                                                   memory_order_acq_rel, memory_order_acquire)) {
+        if (!valmap_eqmode(m->mode, (val_t){kk}, k)) continue;
+      }
+      else atomic_fetch_add(&t->used, 1);
+    }
+    else if (!valmap_eqmode(m->mode, (val_t){kk}, k)) continue;
+    atomic_store_explicit(valcmap_val(t, i), v, memory_order_release);
+    return;
+  }
+}
+
+// Copies the slot `i` of `t` to the next table `n`
+static inline void valcmap_copyslot(valcmap_t m, valcmap_tbl_t *t, valcmap_tbl_t *n, size_t i) {
+  uint64_t k = VALCMAP_EMPTY;
+
+  // Empty slots are closed: the keys that are not in `t` are added to `n`
+  if (atomic_compare_exchange_strong(valcmap_key(t, i), &k, VALCMAP_MOVED)) return;
+
+  uint64_t h = valmap_hashmode(m->mode, (val_t){k});
+  uint64_t v = atomic_load_explicit(valcmap_val(t, i), memory_order_acquire);
+  int stored = 0;
+  while (v != VALCMAP_MOVED) {
+    if (v != VALCMAP_NOVAL || stored) { valcmap_copyto(m, n, (val_t){k}, h, v); stored = 1; }
+    // If the value changed in the meantime, it's copied again
+    if (atomic_compare_exchange_strong(valcmap_val(t, i), &v, VALCMAP_MOVED)) break;
+  }
+}
+
+// Copies the chunks of `t` that are left (if any), without waiting for the chunks claimed
+// by the other threads. The thread that copies the last slot makes `n` the current table.
+static inline void valcmap_help(valcmap_t m, valcmap_tbl_t *t, valcmap_tbl_t *n) {
+  size_t c;
+  while ((c = atomic_fetch_add(&t->claimed, VALCMAP_CHUNK)) < t->cap) {
+    size_t end = (c + VALCMAP_CHUNK < t->cap) ? c + VALCMAP_CHUNK : t->cap;
+    for (size_t i = c; i < end; i++) valcmap_copyslot(m, t, n, i);
+    atomic_fetch_sub(&n->used, end - c);  // The copied keys are counted on their own
+    if (atomic_fetch_add(&t->copied, end - c) + (end - c) == t->cap) {
+      n->older = t;
+      atomic_store_explicit(&m->tbl, n, memory_order_release);
+    }
+  }
+}
+
+// Allocates the next table of `t` (unless another thread already did)
+static inline int valcmap_grow(valcmap_t m, valcmap_tbl_t *t) {
+  if (atomic_load(&t->next)) return 0;
+
+  // Twice the size, unless the keys in the table are mostly removed ones
+  size_t cap = t->cap;
+  if (atomic_load(&m->count) >= cap / 4) cap *= 2;
+
+  valcmap_tbl_t *n = valcmap_tblnew(cap);
+  if (n == NULL) return -1;
+
+  // A slot is reserved for each slot to copy: the keys added to `n` during the copy
+  // can't take the room of the copied ones
+  atomic_store(&n->used, t->cap);
+  valcmap_tbl_t *none = NULL;
+  if (!atomic_compare_exchange_strong(&t->next, &none, n)) free(n);
+  return 0;
+}
+
+// ==== Maps
+
+// Returns a new (empty) map, NULL and errno set to ENOMEM if there's no memory.
+static inline valcmap_t valcmapnew(int mode) {
+  valcmap_t m = malloc(sizeof(struct valcmap_s));
+  if (m == NULL) { errno = ENOMEM; return NULL; }
+  valcmap_tbl_t *t = valcmap_tblnew(VALCMAP_MINCAP);
+  if (t == NULL) { free(m); return NULL; }
+  atomic_init(&m->tbl, t);
+  atomic_init(&m->count, 0);
+  m->mode = (mode == VALMAP_SEMANTIC) ? VALMAP_SEMANTIC : VALMAP_IDENTITY;
+  return m;
+}
+
+// Releases the map (no other thread can be using it). Returns NULL.
+static inline valcmap_t valcmapfree(valcmap_t m) {
+  if (m) {
+    valcmap_tbl_t *t = atomic_load(&m->tbl);
+    free(atomic_load(&t->next));  // A resize that didn't start
+    while (t) { valcmap_tbl_t *older = t->older; free(t); t = older; }
+    free(m);
+  }
+  return NULL;
+}
+
+#define valcmapcount(m) ((m) ? atomic_load(&(m)->count) : 0)
+
+// Returns the value of `k` (VALCMAP_NOVAL if it is not in the map)
+static inline uint64_t valcmap_lookup(valcmap_t m, val_t k) {
+  uint64_t h = valmap_hashmode(m->mode, k);
+  valcmap_tbl_t *t = atomic_load_explicit(&m->tbl, memory_order_acquire);
+
+  while (t) {
+    size_t mask = t->cap - 1;
+    size_t i = h & mask;
+    size_t p = 0;
+    for (; p < t->cap; p++, i = (i + 1) & mask) {
+      uint64_t kk = atomic_load_explicit(valcmap_key(t, i), memory_order_acquire);
+      if (kk == VALCMAP_EMPTY) return VALCMAP_NOVAL;
+      if (kk == VALCMAP_MOVED) break;
+      if (valmap_eqmode(m->mode, (val_t){kk}, k)) {
+        uint64_t v = atomic_load_explicit(valcmap_val(t, i), memory_order_acquire);
+        if (v != VALCMAP_MOVED) return v;
+        break;
+      }
+    }
+    // Copied (or not in a full table): the key can only be in the next table
+    t = atomic_load_explicit(&t->next, memory_order_acquire);
+  }
+  return VALCMAP_NOVAL;
+}
+
+// Returns the value associated to `k`, or the default (`valnil` if not specified)
+#define valcmapget(...) VAL_vrg(valcmap_get_,__VA_ARGS__)
+#define valcmap_get_2(m, k)    valcmap_get(m, val(k), valnil)
+#define valcmap_get_3(m, k, d) valcmap_get(m, val(k), val(d))
+static inline val_t valcmap_get(valcmap_t m, val_t k, val_t dflt) {
+  uint64_t v = valcmap_lookup(m, k);
+  return (v == VALCMAP_NOVAL) ? dflt : (val_t){v};
+}
+
+#define valcmaphas(m, k) (valcmap_lookup(m, val(k)) != VALCMAP_NOVAL)
+
+// Replaces the value of `k` with `desired` if it is `*expected` (VALCMAP_NOVAL means that
+// the key is not in the map). If `any`, the value is replaced whatever it is.
+// Returns 1 if the value was replaced, 0 if it was not (with the value in `*expected`),
+// -1 if there's no memory.
+// During a resize the key is changed in the table where it is, as for lookups: in the old
+// table until its slot is copied (the copy sees the change), in the next one afterwards.
+static inline int valcmap_update(valcmap_t m, val_t k, uint64_t *expected, uint64_t desired, int any) {
+  uint64_t h = valmap_hashmode(m->mode, k);
+  valcmap_tbl_t *t = atomic_load_explicit(&m->tbl, memory_order_acquire);
+
+  for (;;) {
+    // Only the current table grows: the next one is still being filled with the copied slots
+    int cur = (t == atomic_load_explicit(&m->tbl, memory_order_acquire));
+    valcmap_tbl_t *n = atomic_load(&t->next);
+    if (n && cur) valcmap_help(m, t, n);
+    else if (!n && cur && atomic_load(&t->used) >= t->cap - t->cap / 4) {
+      if (valcmap_grow(m, t) < 0) return -1;
+      continue;
+    }
+
+    // The slot of the key (or the empty one where it would go)
+    size_t mask = t->cap - 1;
+    size_t i = h & mask;
+    size_t p = 0;
+    uint64_t kk = 0;
+    int full = 0;
+    for (; p < t->cap; p++, i = (i + 1) & mask) {
+      kk = atomic_load_explicit(valcmap_key(t, i), memory_order_acquire);
+      if (kk == VALCMAP_EMPTY) {
+        // Nothing to remove, or nothing to replace
+        if (desired == VALCMAP_NOVAL || (!any && *expected != VALCMAP_NOVAL)) break;
+        // In a table still being filled by a copy, the slot is counted before it's taken
+        if (!cur && atomic_fetch_add(&t->used, 1) >= t->cap - t->cap / 4) {
+          atomic_fetch_sub(&t->used, 1);
+          full = 1;
+          break;
+        }
+        if (atomic_compare_exchange_strong_explicit(valcmap_key(t, i), &kk, k.v,
+                                                    memory_order_acq_rel, memory_order_acquire)) {
+          if (cur) atomic_fetch_add(&t->used, 1);
+          kk = k.v;
+          break;
+        }
+        if (!cur) atomic_fetch_sub(&t->used, 1);
+      }
+      if (kk == VALCMAP_MOVED) break;
+      if (valmap_eqmode(m->mode, (val_t){kk}, k)) break;
+    }
+    if (p == t->cap || kk == VALCMAP_MOVED) {
+      // Not in `t`, that is full or being copied: the key goes in the next table
+      if ((n = atomic_load(&t->next))) { t = n; continue; }
+      if (cur) { if (valcmap_grow(m, t) < 0) return -1; continue; }
+      full = 1;
+    }
+    if (full) {
+      // The next table is full before the copy to it ended: it goes on from the current
+      // table, helping with the chunks that are left (no other thread could claim them)
+      valcmap_yield();
+      t = atomic_load_explicit(&m->tbl, memory_order_acquire);
+      continue;
+    }
+
+    if (kk == VALCMAP_EMPTY) {
+      // Not in the map
+      if (any || *expected == VALCMAP_NOVAL) return 1;
+      *expected = VALCMAP_NOVAL;
+      return 0;
+    }
+
+    uint64_t v = atomic_load_explicit(valcmap_val(t, i), memory_order_acquire);
+    while (v != VALCMAP_MOVED) {
+      if (!any && v != *expected) { *expected = v; return 0; }
+      if (v == desired) return 1;
+      if (atomic_compare_exchange_weak_explicit(valcmap_val(t, i), &v, desired,
+                                                memory_order_acq_rel, memory_order_acquire)) {
+        if (v == VALCMAP_NOVAL) atomic_fetch_add(&m->count, 1);
+        else if (desired == VALCMAP_NOVAL) atomic_fetch_sub(&m->count, 1);
+        return 1;
+      }
+    }
+    // Copied: the value is in the next table
+    t = atomic_load(&t->next);
+  }
+}
+
+// Associates the value `v` to the key `k` (replacing the previous value, if any).
+// Returns 0, or -1 with errno set to ENOMEM if there's no memory or to EINVAL if `k`
+// or `v` is one of the sentinels.
+#define valcmapset(m, k, v) valcmap_set(m, val(k), val(v))
+static inline int valcmap_set(valcmap_t m, val_t k, val_t v) {
+  if (valcmap_issentinel(k.v) || valcmap_issentinel(v.v)) { errno = EINVAL; return -1; }
+  uint64_t e = 0;
+  return (valcmap_update(m, k, &e, v.v, 1) < 0) ? -1 : 0;
+}
+
+// Removes the key `k`. Returns 1 if the key was in the map, 0 otherwise.
+#define valcmapdel(m, k) valcmap_del(m, val(k))
+static inline int valcmap_del(valcmap_t m, val_t k) {
+  for (;;) {
+    uint64_t e = valcmap_lookup(m, k);
+    if (e == VALCMAP_NOVAL) return 0;
+    if (valcmap_update(m, k, &e, VALCMAP_NOVAL, 0) > 0) return 1;
+  }
+}
+
+// Sets the value of `k` to `desired` if it is `*expected` (`valcmapnone` as `expected` means
+// that the key must not be in the map, as `desired` that the key is to be removed). Returns 1
+// if the value was replaced; 0 if it was not, with the current value in `*expected`; -1 with
+// errno set to ENOMEM if there's no memory or to EINVAL if `k` is one of the sentinels.
+#define valcmapcas(m, k, e, d) valcmap_cas(m, val(k), e, val(d))
+static inline int valcmap_cas(valcmap_t m, val_t k, val_t *expected, val_t desired) {
+  if (valcmap_issentinel(k.v) || (valcmap_issentinel(desired.v) && desired.v != VALCMAP_NOVAL)) {
+    errno = EINVAL;
+    return -1;
+  }
+  return valcmap_update(m, k, &expected->v, desired.v, 0);
+}
+
+// Iterates over the keys:
+//
+//    for (size_t i = 0; (i = valcmapnext(m, i, &k, &v)); ) { ... }
+//
+// Returns 0 when there are no more keys. Either `k` or `v` can be NULL. Keys that are
+// added or removed by other threads during the iteration may or may not be seen (and,
+// if the map is resized, some keys could be seen twice).
+static inline size_t valcmapnext(valcmap_t m, size_t i, val_t *k, val_t *v) {
+  valcmap_tbl_t *t = atomic_load_explicit(&m->tbl, memory_order_acquire);
+  for (; i < t->cap; i++) {
+    uint64_t kk = atomic_load_explicit(valcmap_key(t, i), memory_order_acquire);
+    if (kk == VALCMAP_EMPTY || kk == VALCMAP_MOVED) continue;
+    uint64_t vv = atomic_load_explicit(valcmap_val(t, i), memory_order_acquire);
+    if (vv == VALCMAP_MOVED) vv = valcmap_lookup(m, (val_t){kk});
+    if (vv == VALCMAP_NOVAL) continue;
+    if (k) *k = (val_t){kk};
+    if (v) *v = (val_t){vv};
+    return i + 1;
+  }
+  return 0;
+}
+
+#endif // VALCMAP_VERSION
@@ -0,0 +1,265 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Mark and sweep garbage collection of pointers boxed in val_t.
+//
+// The collector manages the objects that are added to it (any pointer that can be
+// tagged, see `valtagptr()`) and frees those that can't be reached from a set of root
+// slots (`val_t` variables registered with `valgcroot()`). How to reach other values
+// from an object, and how to free it, is defined for each pointer type (VALPTR_FILE,
+// VALPTR_BUF and VALPTR_0 .. VALPTR_7) by a pair of callbacks.
+//
+// Managed objects are the keys of an identity map (see `valmap.h`) whose values are the
+// same pointers, tagged: the tag bits are the mark bits, so objects need no header and
+// no extra memory. Marking pushes the objects on a stack as they are marked and pops
+// them to be traced; sweeping walks the map once, frees the unmarked objects and clears
+// the marks of the others.
+//
+// Marking can be done in steps (`valgcstep()`) to bound the pauses. While a collection
+// is in progress the program must call `valgcbarrier()` on each managed value it stores
+// into a managed object (an "insertion" barrier: the value is marked, so that it can't
+// be missed if the object has already been traced). Roots are traced again before the
+// sweep and objects added during the marking are marked, so neither needs a barrier.
+
+#ifndef VALGC_VERSION
+#define VALGC_VERSION 0x0004009C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "valmap.h"
+
+#define VALGC_MARK   1   // Tag bit of the marked objects
+#define VALGC_TYPES  16  // Slots for the pointer types (only 6 .. 15 are used)
+
+typedef struct valgc_s *valgc_t;
+
+// Calls `valgcmark()` on the values stored in the object `p`
+typedef void (*valgc_trace_t)(valgc_t gc, void *p);
+
+// Releases the object `p`
+typedef void (*valgc_free_t)(void *p);
+
+struct valgc_s {
+  valmap_t      objs;               // Managed objects (untagged) -> the same pointer with the mark bits
+  val_t       **roots;
+  size_t        nroots;
+  size_t        maxroots;
+  val_t        *stack;              // Marked objects still to be traced
+  size_t        nstack;
+  size_t        maxstack;
+  int           marking;            // A collection is in progress
+  int           nomem;              // The stack could not grow (the marking must be done again)
+  size_t        freed;              // Objects released by the last collection
+  valgc_trace_t trace[VALGC_TYPES];
+  valgc_free_t  fin[VALGC_TYPES];
+};
+
+// Index of the pointer type (7FFB -> 6, FFFB -> 7, 7FFC -> 8, ..., FFFF -> 15)
+#define valgc_type(x) ((int)((((x).v >> 47) & 0xE) | ((x).v >> 63)))
+
+#define valgc_untag(x) ((val_t){(x).v & ~VAL_TAG_MASK})
+
+static inline void valgc_fclose(void *p) { fclose(p); }
+
+#ifdef VALBUF_VERSION
+static inline void valgc_buffree(void *p) { valbuffree(p); }
+#endif
+
+// ==== Collectors
+
+// Returns a new collector, or NULL with errno set to ENOMEM if there's no memory.
+// Objects are released with `free()` (`fclose()` for VALPTR_FILE and `valbuffree()` for
+// VALPTR_BUF if `valbuf.h` is included) and have no values to trace, unless other
+// callbacks are set with `valgctype()`.
+static inline valgc_t valgcnew(void) {
+  valgc_t gc = calloc(1, sizeof(struct valgc_s));
+  if (gc == NULL) { errno = ENOMEM; return NULL; }
+  gc->objs = valmapnew(VALMAP_IDENTITY);
+  if (gc->objs == NULL) { free(gc); return NULL; }
+  for (int i = 0; i < VALGC_TYPES; i++) gc->fin[i] = free;
+  gc->fin[valgc_type(((val_t){VALPTR_FILE}))] = valgc_fclose;
+#ifdef VALBUF_VERSION
+  gc->fin[valgc_type(((val_t){VALPTR_BUF}))] = valgc_buffree;
+#endif
+  return gc;
+}
+
+// Releases all the managed objects and the collector. Returns NULL.
+static inline valgc_t valgcfree(valgc_t gc) {
+  if (gc) {
+    val_t k;
+    for (size_t i = 0; (i = valmapnext(gc->objs, i, &k, NULL)); )
+      if (gc->fin[valgc_type(k)]) gc->fin[valgc_type(k)](valtoptr(k));
+    valmapfree(gc->objs);
+    free(gc->roots);
+    free(gc->stack);
+    free(gc);
+  }
+  return NULL;
+}
+
+#define valgccount(gc) ((gc) ? valmapcount((gc)->objs) : 0)
+
+// Sets how the objects of a pointer type (e.g. VALPTR_3) are traced and released.
+// Either callback can be NULL (no values to trace, nothing to release).
+// Returns 0, or -1 with errno set to EINVAL if `type` is not a type that can be tagged.
+static inline int valgctype(valgc_t gc, uint64_t type, valgc_trace_t trace, valgc_free_t fin) {
+  val_t t = {type};
+  if (val_check_taggable_ptr(t) <= 0 || (type & ~VAL_TYPE_MASK)) { errno = EINVAL; return -1; }
+  gc->trace[valgc_type(t)] = trace;
+  gc->fin[valgc_type(t)] = fin;
+  return 0;
+}
+
+// ==== Roots
+
+// Registers the variable `*slot` as a root: the values reachable from it are not freed.
+// Returns 0, or -1 with errno set to ENOMEM if there's no memory.
+static inline int valgcroot(valgc_t gc, val_t *slot) {
+  if (gc->nroots == gc->maxroots) {
+    size_t max = gc->maxroots ? 2 * gc->maxroots : 16;
+    val_t **r = realloc(gc->roots, max * sizeof(val_t *));
+    if (r == NULL) { errno = ENOMEM; return -1; }
+    gc->roots = r;
+    gc->maxroots = max;
+  }
+  gc->roots[gc->nroots++] = slot;
+  return 0;
+}
+
+// Removes the root `*slot`. Returns 1 if it was a root, 0 otherwise.
+static inline int valgcunroot(valgc_t gc, val_t *slot) {
+  for (size_t i = gc->nroots; i-- > 0; ) {
+    if (gc->roots[i] == slot) {
+      gc->roots[i] = gc->roots[--gc->nroots];
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// ==== Marking
+
+// Marks the object `v` (if it is a managed object that is not marked yet) and
+// pushes it to be traced.
+#define valgcmark(gc, v) valgc_mark(gc, val(v))
+static inline void valgc_mark(valgc_t gc, val_t v) {
+  if (val_check_taggable_ptr(v) <= 0) return;
+  val_t *ref = valmap_ref(gc->objs, valgc_untag(v));
+  if (ref == NULL || (ref->v & VALGC_MARK)) return;
+
+  if (gc->nstack == gc->maxstack) {
+    size_t max = gc->maxstack ? 2 * gc->maxstack : 256;
+    val_t *s = realloc(gc->stack, max * sizeof(val_t));
+    if (s == NULL) { gc->nomem = 1; return; }  // Left unmarked
+    gc->stack = s;
+    gc->maxstack = max;
+  }
+  ref->v |= VALGC_MARK;
+  gc->stack[gc->nstack++] = valgc_untag(v);
+}
+
+// To be called on each managed value `v` stored into a managed object while a collection
+// is in progress.
+#define valgcbarrier(gc, v) do { if ((gc)->marking) valgc_mark(gc, val(v)); } while (0)
+
+// Traces up to `budget` objects. Returns the number of objects traced.
+static inline size_t valgc_trace(valgc_t gc, size_t budget) {
+  size_t n = 0;
+  while (n < budget && gc->nstack > 0) {
+    val_t v = gc->stack[--gc->nstack];
+    valgc_trace_t trace = gc->trace[valgc_type(v)];
+    if (trace) trace(gc, valtoptr(v));
+    n++;
+  }
+  return n;
+}
+
+static inline void valgc_markroots(valgc_t gc) {
+  for (size_t i = 0; i < gc->nroots; i++) valgc_mark(gc, *gc->roots[i]);
+}
+
+// Clears all the marks (to start again)
+static inline void valgc_unmark(valgc_t gc) {
+  valmap_t m = gc->objs;
+  for (size_t i = 0; (i = valmapnext(m, i, NULL, NULL)); ) m->slots[i - 1].val.v &= ~(uint64_t)VALGC_MARK;
+  gc->nstack = 0;
+}
+
+// ==== Sweeping
+
+// Releases the objects that are not marked and clears the marks of the others.
+// Returns the number of objects released.
+static inline size_t valgc_sweep(valgc_t gc) {
+  valmap_t m = gc->objs;
+  size_t n = 0;
+  val_t k;
+  for (size_t i = 0; (i = valmapnext(m, i, &k, NULL)); ) {
+    val_t *v = &m->slots[i - 1].val;
+    if (v->v & VALGC_MARK) { v->v &= ~(uint64_t)VALGC_MARK; continue; }
+    if (gc->fin[valgc_type(k)]) gc->fin[valgc_type(k)](valtoptr(k));
+    valmap_delat(m, i - 1);
+    n++;
+  }
+  gc->marking = 0;
+  return n;
+}
+
+// ==== Collecting
+
+// Adds the object `v` to the collector, which will free it when it can't be reached from
+// the roots anymore. Returns `v`, or `valnil` with errno set to EINVAL if `v` is not a
+// pointer that can be tagged, or to ENOMEM if there's no memory (and `v` is not added).
+#define valgcadd(gc, v) valgc_add(gc, val(v))
+static inline val_t valgc_add(valgc_t gc, val_t v) {
+  if (val_check_taggable_ptr(v) <= 0 || valtoptr(v) == NULL) { errno = EINVAL; return valnil; }
+  val_t k = valgc_untag(v);
+  if (valmap_set(gc->objs, k, k) < 0) return valnil;
+
+  // Objects added during the marking are alive for this collection (and so are the
+  // values they hold)
+  if (gc->marking) valgc_mark(gc, k);
+  return v;
+}
+
+// Does a part of a collection: traces up to `budget` objects and, if there are no more
+// objects to trace, sweeps. Returns 1 if the collection has been completed (see
+// `valgcfreed()`), 0 otherwise.
+static inline int valgcstep(valgc_t gc, size_t budget) {
+  if (!gc->marking) {
+    gc->marking = 1;
+    gc->nomem = 0;
+    valgc_markroots(gc);
+  }
+  valgc_trace(gc, budget);
+  if (gc->nstack > 0) return 0;
+
+  // The roots could have changed in the meantime
+  valgc_markroots(gc);
+  valgc_trace(gc, SIZE_MAX);
+
+  if (gc->nomem) {
+    // Some objects might have been left unmarked: nothing can be freed this time
+    valgc_unmark(gc);
+    gc->marking = 0;
+    gc->freed = 0;
+    errno = ENOMEM;
+    return 1;
+  }
+  gc->freed = valgc_sweep(gc);
+  return 1;
+}
+
+// Number of objects released by the last collection
+#define valgcfreed(gc) ((gc)->freed)
+
+// Completes the collection in progress (if any) and does a full collection.
+// Returns the number of objects released.
+static inline size_t valgccollect(valgc_t gc) {
+  size_t n = 0;
+  if (gc->marking) { valgcstep(gc, SIZE_MAX); n = gc->freed; }
+  valgcstep(gc, SIZE_MAX);
+  return n + gc->freed;
+}
+
+#endif // VALGC_VERSION
@@ -0,0 +1,193 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Static search index over sorted arrays of val_t.
+//
+// A binary search on a large array touches a different cache line at every step and
+// only the first few steps hit lines that are shared by all the searches. The index
+// stores the sort keys of the values (see `valsortkey()` in `val.h`) in Eytzinger order:
+// the root is at position 1 and the children of the key at position `i` are at `2i`
+// and `2i+1`, as in a binary heap. The first levels of the tree are packed in a few
+// cache lines and the search moves down the tree comparing plain integers, prefetching
+// the cache line that holds the 8 keys three levels below.
+//
+// For each key the index also holds the position of its value in the sorted array,
+// which is not copied and must stay unchanged as long as the index is used. Strings
+// whose keys are tied (see `valsortkeytie()`) are then compared with `val_cmp()` in
+// the (short) range of the array with the same key.
+//
+// The array must be sorted in the order of `valsort()`, which places NaNs after +inf.
+
+#ifndef VALIDX_VERSION
+#define VALIDX_VERSION 0x0004009C
+
+#include <stdlib.h>
+#include "valbatch.h"
+
+#define VALIDX_LINE     64   // Size of a cache line (the keys array is aligned to it)
+#define VALIDX_BATCH    8    // Number of searches interleaved by `validxlower_n()`
+
+typedef struct validx_s {
+  uint64_t    *keys;   // keys[1..n] in Eytzinger order, keys[0] unused
+  size_t      *pos;    // pos[i] is the position in the array of the value with key keys[i]
+  const val_t *vals;   // The sorted array
+  size_t       n;
+  void        *mem;    // Memory holding keys (aligned) and pos
+} *validx_t;
+
+// Stores the sorted keys `src` in Eytzinger order (in-order visit of the implicit tree)
+static inline size_t validx_fill(validx_t ix, const uint64_t *src, size_t r, size_t i) {
+  if (i <= ix->n) {
+    r = validx_fill(ix, src, r, 2 * i);
+    ix->keys[i] = src[r];
+    ix->pos[i]  = r++;
+    r = validx_fill(ix, src, r, 2 * i + 1);
+  }
+  return r;
+}
+
+// Position in the Eytzinger order of the first key not lower than `k` (0 if there is none).
+// The keys three levels below `i` are at `8i..8i+7`, in a single cache line.
+static inline size_t validx_search(const validx_t ix, uint64_t k) {
+  const uint64_t *keys = ix->keys;
+  size_t i = 1;
+  while (i <= ix->n) {
+    val_prefetch(keys + 8 * i);
+    i = 2 * i + (keys[i] < k);
+  }
+  // The last step to the left is where the search ended (all the steps after it went right)
+  return i >> (val_ctz64(~(uint64_t)i) + 1);
+}
+
+static inline size_t validx_keypos(const validx_t ix, uint64_t k) {
+  size_t i = validx_search(ix, k);
+  return i ? ix->pos[i] : ix->n;
+}
+
+// ==== Index
+
+// Returns the index of the `n` values in `a`, that must be sorted as by `valsort()`.
+// Returns NULL with errno set to ENOMEM if there is no memory or to EINVAL if the
+// values are not sorted.
+static inline validx_t validxnew(const val_t *a, size_t n) {
+  validx_t ix = malloc(sizeof(struct validx_s));
+  if (ix == NULL) { errno = ENOMEM; return NULL; }
+
+  uint64_t *src = malloc((n + 1) * sizeof(uint64_t));
+  ix->mem = malloc((n + 1) * (sizeof(uint64_t) + sizeof(size_t)) + VALIDX_LINE);
+  if (src == NULL || ix->mem == NULL) {
+    free(src); free(ix->mem); free(ix);
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  valsortkey_n(a, n, src);
+  for (size_t i = 1; i < n; i++) {
+    if (src[i - 1] > src[i]) {
+      free(src); free(ix->mem); free(ix);
+      errno = EINVAL;
+      return NULL;
+    }
+  }
+
+  // keys[0] starts a cache line: the keys at `8j..8j+7` share one
+  uintptr_t p = ((uintptr_t)ix->mem + VALIDX_LINE - 1) & ~(uintptr_t)(VALIDX_LINE - 1);
+  ix->keys = (uint64_t *)p;
+  ix->pos  = (size_t *)(ix->keys + n + 1);
+  ix->vals = a;
+  ix->n    = n;
+  validx_fill(ix, src, 0, 1);
+
+  free(src);
+  return ix;
+}
+
+static inline validx_t validxfree(validx_t ix) {
+  if (ix) {
+    free(ix->mem);
+    free(ix);
+  }
+  return NULL;
+}
+
+#define validxcount(ix) ((ix) ? (ix)->n : 0)
+
+// ==== Queries
+// With `k` the key of `x`, the values with keys lower (higher) than `k` are lower (higher)
+// than `x`. If `k` is tied, the values with the same key are compared with `val_cmp()`.
+
+// Returns the position of the first value that is not lower than `x` (`n` if they all are)
+#define validxlower(ix, x) validx_lower(ix, val(x))
+static inline size_t validx_lower(const validx_t ix, val_t x) {
+  uint64_t k = val_sortkey(x);
+  size_t lo = validx_keypos(ix, k);
+  if (valsortkeytie(k)) {
+    size_t hi = validx_keypos(ix, k + 1);
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (val_cmp(ix->vals[mid], x) < 0) lo = mid + 1;
+      else hi = mid;
+    }
+  }
+  return lo;
+}
+
+// Returns the position of the first value that is higher than `x` (`n` if there is none)
+#define validxupper(ix, x) validx_upper(ix, val(x))
+static inline size_t validx_upper(const validx_t ix, val_t x) {
+  uint64_t k = val_sortkey(x);
+  size_t hi = validx_keypos(ix, k + 1);
+  if (valsortkeytie(k)) {
+    size_t lo = validx_keypos(ix, k);
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (val_cmp(ix->vals[mid], x) <= 0) lo = mid + 1;
+      else hi = mid;
+    }
+  }
+  return hi;
+}
+
+// Returns the position of the first value equal to `x` and stores in `*end` the position
+// after the last one. If there is none, both are the position where `x` would be.
+#define validxrange(ix, x, end) validx_range(ix, val(x), end)
+static inline size_t validx_range(const validx_t ix, val_t x, size_t *end) {
+  size_t first = validx_lower(ix, x);
+  *end = validx_upper(ix, x);
+  return first;
+}
+
+// Stores in `pos[i]` the same result of `validxlower(ix, x[i])` for the `n` values in `x`.
+// The searches are interleaved, VALIDX_BATCH at a time, so that their cache misses overlap.
+static inline void validxlower_n(const validx_t ix, const val_t *x, size_t n, size_t *pos) {
+  uint64_t k[VALIDX_BATCH];
+  size_t   i[VALIDX_BATCH];
+  const uint64_t *keys = ix->keys;
+
+  for (size_t base = 0; base < n; base += VALIDX_BATCH) {
+    size_t cnt = (n - base < VALIDX_BATCH) ? (n - base) : VALIDX_BATCH;
+    valsortkey_n(x + base, cnt, k);
+    for (size_t j = 0; j < cnt; j++) i[j] = 1;
+
+    // All the searches go down the same number of levels (give or take one)
+    int more = 1;
+    while (more) {
+      more = 0;
+      for (size_t j = 0; j < cnt; j++) {
+        if (i[j] <= ix->n) {
+          val_prefetch(keys + 8 * i[j]);
+          i[j] = 2 * i[j] + (keys[i[j]] < k[j]);
+          more = 1;
+        }
+      }
+    }
+
+    for (size_t j = 0; j < cnt; j++) {
+      if (valsortkeytie(k[j])) { pos[base + j] = validx_lower(ix, x[base + j]); continue; }
+      size_t e = i[j] >> (val_ctz64(~(uint64_t)i[j]) + 1);
+      pos[base + j] = e ? ix->pos[e] : ix->n;
+    }
+  }
+}
+
+#endif // VALIDX_VERSION
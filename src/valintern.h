@@ -0,0 +1,131 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// String interning.
+//
+// A pool keeps a single copy of each string. Interned strings are boxed as `valptr_7_t`
+// pointers to a descriptor that holds the string, its length and its hash:
+//
+//   - two strings interned in the same pool are equal iff they are identical
+//     (`valeq()`), and `valcmp()` returns 0 without calling `strcmp()`;
+//   - `valhash()` returns the stored hash (which is the same of the `char *`);
+//   - they are still strings: compared with `char *` or buffers, they behave
+//     as a `char *`.
+//
+// Strings and descriptors are allocated in large blocks and are only released
+// when the pool is freed.
+//
+// This header defines VALINTERN and must be included before `val.h` (directly
+// or through other headers) is included, or VALINTERN must be defined globally.
+
+#ifndef VALINTERN_VERSION
+#define VALINTERN_VERSION 0x0004009C
+
+#ifndef VALINTERN
+  #ifdef VAL_VERSION
+    #error "Define VALINTERN (or include valintern.h) before including val.h"
+  #endif
+  #define VALINTERN
+#endif
+
+#include "valmap.h"
+
+#define VALPOOL_BLOCK 65536
+#define VALPOOL_ALIGN 8      // Enough for the descriptors and for the pointer tags
+
+typedef struct valpool_blk_s {
+  struct valpool_blk_s *next;
+  size_t used;
+  size_t size;
+  alignas(VALPOOL_ALIGN) char data[];
+} *valpool_blk_t;
+
+typedef struct valpool_s {
+  valmap_t      map;     // The interned strings (as keys)
+  valpool_blk_t blocks;  // The memory for descriptors and strings
+} *valpool_t;
+
+// Returns a new (empty) pool, NULL and errno set to ENOMEM if there's no memory.
+static inline valpool_t valpoolnew(void) {
+  valpool_t p = malloc(sizeof(struct valpool_s));
+  if (p == NULL) { errno = ENOMEM; return NULL; }
+  p->blocks = NULL;
+  p->map    = valmapnew(VALMAP_SEMANTIC);
+  if (p->map == NULL) { free(p); return NULL; }
+  return p;
+}
+
+// Releases the pool and all its strings. Returns NULL.
+static inline valpool_t valpoolfree(valpool_t p) {
+  if (p) {
+    for (valpool_blk_t b = p->blocks, next; b; b = next) { next = b->next; free(b); }
+    valmapfree(p->map);
+    free(p);
+  }
+  return NULL;
+}
+
+#define valpoolcount(p) valmapcount((p)->map)
+
+static inline void *valpool_alloc(valpool_t p, size_t size) {
+  valpool_blk_t b = p->blocks;
+
+  size = (size + VALPOOL_ALIGN - 1) & ~(size_t)(VALPOOL_ALIGN - 1);
+  if (b == NULL || b->size - b->used < size) {
+    size_t bsize = (size > VALPOOL_BLOCK) ? size : VALPOOL_BLOCK;
+    b = malloc(sizeof(struct valpool_blk_s) + bsize);
+    if (b == NULL) { errno = ENOMEM; return NULL; }
+    b->used = 0;
+    b->size = bsize;
+    b->next = p->blocks;
+    p->blocks = b;
+  }
+  void *ret = b->data + b->used;
+  b->used += size;
+  return ret;
+}
+
+// Returns the interned string with the same text of `s` (adding it to the pool if
+// needed). Returns `valnil` (and sets errno) if `s` is NULL or there's no memory.
+static inline val_t valintern(valpool_t p, const char *s) {
+  if (p == NULL || s == NULL) { errno = EINVAL; return valnil; }
+
+  val_t *ref = valmap_ref(p->map, val((char *)s));
+  if (ref) return *ref;
+
+  size_t len = strlen(s);
+  if (len > UINT32_MAX) { errno = EINVAL; return valnil; }
+
+  valptr_7_t d = valpool_alloc(p, sizeof(struct valptr_7_s) + len + 1);
+  if (d == NULL) return valnil;
+
+  d->str  = (char *)(d + 1);
+  d->len  = (uint32_t)len;
+  memcpy(d->str, s, len + 1);
+  d->hash = val_hash(val(d->str));
+  d->prefix = 0;
+  for (size_t k = 0; k < 8; k++) d->prefix = (d->prefix << 8) | (uint8_t)(k < len ? s[k] : 0);
+
+  val_t v = val(d);
+  if (valmap_set(p->map, v, v) < 0) return valnil;
+  return v;
+}
+
+// Returns the interned string for `v` if `v` is a string (`char *`, buffer, short
+// string or an interned string from another pool), `v` itself otherwise.
+#define valinternval(p, v) val_internval(p, val(v))
+static inline val_t val_internval(valpool_t p, val_t v) {
+  char buf[VAL_SSTR_LEN + 1];
+  char *s = val_get_strptr(v, buf);
+  if (s == val_emptystr || s == NULL) return v;
+  return valintern(p, s);
+}
+
+// The length of an interned string (0 if `v` is not an interned string)
+#define valinternlen(v) val_internlen(val(v))
+static inline size_t val_internlen(val_t v) {
+  valptr_7_t d = val_is_interned(v) ? valtoptr(v) : NULL;
+  return d ? d->len : 0;
+}
+
+#endif // VALINTERN_VERSION
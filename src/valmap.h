@@ -0,0 +1,366 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Hash maps with val_t keys and values.
+//
+// The table uses open addressing with the "Swiss table" layout: next to the array of
+// slots (each holding a key and its value) there is an array of control bytes, one per
+// slot, that is either EMPTY, DELETED or the lowest 7 bits of the hash of the key (H2).
+// Slots are organized in groups of 16 and a lookup checks the control bytes of a whole
+// group at once (with SSE2 if available): only the slots whose control byte matches H2
+// are compared with the key. The group where the search starts is given by the
+// remaining bits of the hash (H1) and the next groups are probed with a triangular
+// sequence until a group with an EMPTY slot is found.
+//
+// There are two modes, chosen when the map is created:
+//
+//   VALMAP_IDENTITY  Keys are the same if they are identical (as for `valeq()`).
+//   VALMAP_SEMANTIC  Keys are the same if `valcmp()` considers them equal: strings and
+//                    buffers holding the same text are the same key, as are numbers with
+//                    the same value (`0.0` and `-0.0`, `3` and `3.0` with VALNATIVEINT).
+//                    Unlike `valcmp()`, NaN keys only match other NaN keys.
+//
+// The map does not own the keys: strings and buffers used as keys must stay valid (and
+// unchanged) as long as they are in the map.
+
+#ifndef VALMAP_VERSION
+#define VALMAP_VERSION 0x0004009C
+
+#include <stdlib.h>
+#include "valbatch.h"
+
+#define VALMAP_IDENTITY 0
+#define VALMAP_SEMANTIC 1
+
+#define VALMAP_GROUP    16
+#define VALMAP_EMPTY    ((uint8_t)0x80)
+#define VALMAP_DELETED  ((uint8_t)0xFE)
+#define VALMAP_NONE     (~(size_t)0)
+
+typedef struct {
+  val_t key;
+  val_t val;
+} valmap_slot_t;
+
+typedef struct valmap_s {
+  uint8_t       *ctrl;        // One control byte per slot
+  valmap_slot_t *slots;
+  size_t         cap;         // Number of slots (a power of 2, multiple of VALMAP_GROUP)
+  size_t         count;       // Number of keys in the map
+  size_t         growth;      // Number of EMPTY slots that can be still used before rehashing
+  int            mode;
+} *valmap_t;
+
+// ==== Hashing and equality
+
+// 64→64-bit MurmurHash3 “fmix” finalizer
+static inline uint64_t valmap_fmix64(uint64_t h) {
+  h ^= h >> 33;
+  h *= (uint64_t)0XFF51AFD7ED558CCD;
+  h ^= h >> 33;
+  h *= (uint64_t)0XC4CEB9FE1A85EC53;
+  h ^= h >> 33;
+  return h;
+}
+
+// In semantic mode strings are hashed on their content (as `val_hash()` does, with
+// NULL being the same as ""), numbers on their value as a double (with a single
+// value for all the NaNs and for ±0). The hash stored in a buffer is used, but a
+// missing one is not stored: lookups in a `valcmap_t` never write, not even to keys.
+static inline uint64_t valmap_hashmode(int mode, val_t k) {
+  if (mode == VALMAP_SEMANTIC) {
+#ifdef VALINTERN
+    if (val_is_interned(k) && valtoptr(k)) return valmap_fmix64(((valptr_7_t)valtoptr(k))->hash);
+#endif
+    if (val_is_sstr(k)) return valmap_fmix64(val_hash(k));
+#ifdef VALSTDBUF
+    if (valisbufptr(k) && valtoptr(k) && ((valptr_buf_t)valtoptr(k))->buf) {
+      valptr_buf_t b = valtoptr(k);
+      return valmap_fmix64(b->hash ? b->hash : val_buf_hash(b));
+    }
+#endif
+    char *s = val_get_charptr(k);
+    if (s != val_emptystr) {
+      uint32_t hash = (uint32_t)0X811C9DC5;
+      if (s) while (*s) { hash ^= (uint32_t)(*s++); hash *= (uint32_t)0x01000193; }
+      return valmap_fmix64(hash);
+    }
+    if (val_isnumber(k)) {
+      double d = val_todouble(k);
+      if (d != d) k.v = VAL_DBLNAN_POS;              // All the NaNs are the same key
+      else k = val_fromdouble(d + 0.0);              // -0.0 + 0.0 is 0.0
+    }
+  }
+  return valmap_fmix64(k.v);
+}
+
+static inline int valmap_eqmode(int mode, val_t a, val_t b) {
+  if (a.v == b.v) return 1;
+  if (mode == VALMAP_IDENTITY) return 0;
+
+  char buf_a[VAL_SSTR_LEN + 1], buf_b[VAL_SSTR_LEN + 1];
+
+#ifdef VALSTDBUF
+  // Standard buffers: different lengths (or different hashes, if known) can't be equal
+  if (valisbufptr(a) || valisbufptr(b)) {
+    size_t la, lb;
+    char *sa = val_get_strlen(a, buf_a, &la);
+    char *sb = val_get_strlen(b, buf_b, &lb);
+    if (sa == val_emptystr || sb == val_emptystr || la != lb) return 0;
+    if (la == 0) return 1;
+    valptr_buf_t ba = valisbufptr(a) ? valtoptr(a) : NULL;
+    valptr_buf_t bb = valisbufptr(b) ? valtoptr(b) : NULL;
+    if (ba && bb && ba->hash && bb->hash && ba->hash != bb->hash) return 0;
+    return memcmp(sa, sb, la) == 0;
+  }
+#endif
+
+  char *sa = val_get_strptr(a, buf_a);
+  if (sa != val_emptystr) {
+    char *sb = val_get_strptr(b, buf_b);
+    if (sb == val_emptystr) return 0;
+    return strcmp(sa ? sa : val_emptystr, sb ? sb : val_emptystr) == 0;
+  }
+  if (val_isnumber(a) && val_isnumber(b)) {
+    double da = val_todouble(a);
+    double db = val_todouble(b);
+    return (da == db) || ((da != da) && (db != db));
+  }
+  return 0;
+}
+
+#define valmap_hash(m, k)  valmap_hashmode((m)->mode, k)
+#define valmap_eq(m, a, b) valmap_eqmode((m)->mode, a, b)
+
+// ==== Control bytes
+
+// Bit `i` of the result is set if the control byte `i` of the group is `c`
+static inline uint32_t valmap_match(const uint8_t *ctrl, uint8_t c) {
+#if VAL_SIMD >= 128
+  __m128i g = _mm_loadu_si128((const __m128i *)ctrl);
+  return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)c)));
+#else
+  uint32_t bits = 0;
+  for (int i = 0; i < VALMAP_GROUP; i++) bits |= (uint32_t)(ctrl[i] == c) << i;
+  return bits;
+#endif
+}
+
+// EMPTY and DELETED are the only control bytes with the highest bit set
+static inline uint32_t valmap_match_free(const uint8_t *ctrl) {
+#if VAL_SIMD >= 128
+  return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#else
+  uint32_t bits = 0;
+  for (int i = 0; i < VALMAP_GROUP; i++) bits |= (uint32_t)(ctrl[i] >> 7) << i;
+  return bits;
+#endif
+}
+
+#define valmap_h1(h)  ((size_t)((h) >> 7))
+#define valmap_h2(h)  ((uint8_t)((h) & 0x7F))
+
+// Returns the slot with the key `k` or VALMAP_NONE
+static inline size_t valmap_find(valmap_t m, val_t k, uint64_t h) {
+  if (m->cap == 0) return VALMAP_NONE;
+
+  size_t  gmask = (m->cap / VALMAP_GROUP) - 1;
+  size_t  g     = valmap_h1(h) & gmask;
+  uint8_t h2    = valmap_h2(h);
+
+  for (size_t step = 1; ; step++) {
+    const uint8_t *ctrl  = m->ctrl + g * VALMAP_GROUP;
+    uint32_t       match = valmap_match(ctrl, h2);
+    while (match) {
+      size_t pos = g * VALMAP_GROUP + (size_t)val_ctz64(match);
+      if (m->slots[pos].key.v == k.v || (m->mode == VALMAP_SEMANTIC && valmap_eq(m, m->slots[pos].key, k)))
+        return pos;
+      match &= match - 1;
+    }
+    if (valmap_match(ctrl, VALMAP_EMPTY)) return VALMAP_NONE;
+    g = (g + step) & gmask;  // Triangular probing visits all the groups
+  }
+}
+
+// Returns the first EMPTY or DELETED slot in the probe sequence for the hash `h`
+static inline size_t valmap_find_free(valmap_t m, uint64_t h) {
+  size_t gmask = (m->cap / VALMAP_GROUP) - 1;
+  size_t g     = valmap_h1(h) & gmask;
+
+  for (size_t step = 1; ; step++) {
+    uint32_t match = valmap_match_free(m->ctrl + g * VALMAP_GROUP);
+    if (match) return g * VALMAP_GROUP + (size_t)val_ctz64(match);
+    g = (g + step) & gmask;
+  }
+}
+
+// At most 7/8 of the slots can be used (including the DELETED ones)
+#define valmap_maxload(cap) ((cap) - (cap) / 8)
+
+// Moves all the keys to a new table with `cap` slots (dropping the DELETED ones)
+static inline int valmap_rehash(valmap_t m, size_t cap) {
+  uint8_t       *ctrl  = malloc(cap);
+  valmap_slot_t *slots = malloc(cap * sizeof(valmap_slot_t));
+
+  if (ctrl == NULL || slots == NULL) {
+    free(ctrl); free(slots);
+    errno = ENOMEM;
+    return -1;
+  }
+  memset(ctrl, VALMAP_EMPTY, cap);
+
+  uint8_t       *old_ctrl  = m->ctrl;
+  valmap_slot_t *old_slots = m->slots;
+  size_t         old_cap   = m->cap;
+
+  m->ctrl  = ctrl;
+  m->slots = slots;
+  m->cap   = cap;
+
+  for (size_t i = 0; i < old_cap; i++) {
+    if (old_ctrl[i] & 0x80) continue;
+    uint64_t h   = valmap_hash(m, old_slots[i].key);
+    size_t   pos = valmap_find_free(m, h);
+    ctrl[pos]  = valmap_h2(h);
+    slots[pos] = old_slots[i];
+  }
+  m->growth = valmap_maxload(cap) - m->count;
+
+  free(old_ctrl);
+  free(old_slots);
+  return 0;
+}
+
+// ==== Maps
+
+// Returns a new (empty) map, NULL and errno set to ENOMEM if there's no memory.
+static inline valmap_t valmapnew(int mode) {
+  valmap_t m = malloc(sizeof(struct valmap_s));
+  if (m == NULL) { errno = ENOMEM; return NULL; }
+  m->ctrl   = NULL;
+  m->slots  = NULL;
+  m->cap    = 0;
+  m->count  = 0;
+  m->growth = 0;
+  m->mode   = (mode == VALMAP_SEMANTIC) ? VALMAP_SEMANTIC : VALMAP_IDENTITY;
+  return m;
+}
+
+static inline valmap_t valmapfree(valmap_t m) {
+  if (m) {
+    free(m->ctrl);
+    free(m->slots);
+    free(m);
+  }
+  return NULL;
+}
+
+#define valmapcount(m) ((m) ? (m)->count : 0)
+
+// Makes room for `n` keys (in total) without rehashing
+static inline int valmapreserve(valmap_t m, size_t n) {
+  size_t cap = VALMAP_GROUP;
+  while (valmap_maxload(cap) < n) cap *= 2;
+  if (cap <= m->cap) return 0;
+  return valmap_rehash(m, cap);
+}
+
+// Removes all the keys, keeping the allocated memory
+static inline void valmapclear(valmap_t m) {
+  if (m->cap) memset(m->ctrl, VALMAP_EMPTY, m->cap);
+  m->count  = 0;
+  m->growth = valmap_maxload(m->cap);
+}
+
+// Returns a pointer to the value associated to the key `k` (or NULL if there is none).
+// The pointer is valid until the next key is added.
+#define valmapref(m, k) valmap_ref(m, val(k))
+static inline val_t *valmap_ref(valmap_t m, val_t k) {
+  size_t pos = valmap_find(m, k, valmap_hash(m, k));
+  return (pos == VALMAP_NONE) ? NULL : &m->slots[pos].val;
+}
+
+#define valmaphas(m, k) (valmap_ref(m, val(k)) != NULL)
+
+// Returns the value associated to the key `k` or, if there is none, `valnil` (or the
+// specified default value).
+#define valmapget(...) VAL_vrg(valmap_get_,__VA_ARGS__)
+#define valmap_get_2(m, k)    valmap_get(m, val(k), valnil)
+#define valmap_get_3(m, k, d) valmap_get(m, val(k), val(d))
+static inline val_t valmap_get(valmap_t m, val_t k, val_t dflt) {
+  val_t *v = valmap_ref(m, k);
+  return v ? *v : dflt;
+}
+
+// Associates the value `v` to the key `k` and returns 0 (-1 and errno set to ENOMEM if
+// the table could not grow). If the key is already in the map, only its value changes.
+#define valmapset(m, k, v) valmap_set(m, val(k), val(v))
+static inline int valmap_set(valmap_t m, val_t k, val_t v) {
+  uint64_t h   = valmap_hash(m, k);
+  size_t   pos = valmap_find(m, k, h);
+
+  if (pos != VALMAP_NONE) {
+    m->slots[pos].val = v;
+    return 0;
+  }
+
+  pos = (m->cap > 0) ? valmap_find_free(m, h) : VALMAP_NONE;
+
+  // Only EMPTY slots count against the load factor
+  if (pos == VALMAP_NONE || (m->growth == 0 && m->ctrl[pos] == VALMAP_EMPTY)) {
+    // Too many DELETED slots: rehash in place, otherwise double the capacity
+    size_t cap = (m->cap == 0) ? VALMAP_GROUP
+               : (m->count < valmap_maxload(m->cap) / 2) ? m->cap : m->cap * 2;
+    if (valmap_rehash(m, cap) < 0) return -1;
+    pos = valmap_find_free(m, h);
+  }
+
+  if (m->ctrl[pos] == VALMAP_EMPTY) m->growth--;
+  m->ctrl[pos]      = valmap_h2(h);
+  m->slots[pos].key = k;
+  m->slots[pos].val = v;
+  m->count++;
+  return 0;
+}
+
+// Removes the key in the slot `pos`.
+// If the group of the slot has an EMPTY slot, no search can have gone past it and the
+// slot can be marked as EMPTY; otherwise it must be marked as DELETED.
+static inline void valmap_delat(valmap_t m, size_t pos) {
+  const uint8_t *group = m->ctrl + (pos & ~(size_t)(VALMAP_GROUP - 1));
+  if (valmap_match(group, VALMAP_EMPTY)) {
+    m->ctrl[pos] = VALMAP_EMPTY;
+    m->growth++;
+  }
+  else m->ctrl[pos] = VALMAP_DELETED;
+  m->count--;
+}
+
+// Removes the key `k`. Returns 1 if the key was in the map, 0 otherwise.
+#define valmapdel(m, k) valmap_del(m, val(k))
+static inline int valmap_del(valmap_t m, val_t k) {
+  size_t pos = valmap_find(m, k, valmap_hash(m, k));
+  if (pos == VALMAP_NONE) return 0;
+  valmap_delat(m, pos);
+  return 1;
+}
+
+// Iterates over the keys (in no particular order):
+//
+//    val_t k, v;
+//    for (size_t i = 0; (i = valmapnext(m, i, &k, &v)); ) { ... }
+//
+// Returns 0 when there are no more keys. Either `k` or `v` can be NULL.
+// Keys must not be added while iterating. Values can be changed and the last key
+// returned can be removed (slots are never moved by a removal).
+static inline size_t valmapnext(valmap_t m, size_t i, val_t *k, val_t *v) {
+  for (; i < m->cap; i++) {
+    if (m->ctrl[i] & 0x80) continue;
+    if (k) *k = m->slots[i].key;
+    if (v) *v = m->slots[i].val;
+    return i + 1;
+  }
+  return 0;
+}
+
+#endif // VALMAP_VERSION
@@ -0,0 +1,323 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Binary files of values that are loaded without parsing.
+//
+// A file has a header, the values as 64-bit words and a heap with the strings:
+//
+//     header | values (count * 8 bytes) | heap
+//
+// Numbers, constants, symbols and short strings are stored as they are. Strings and
+// buffers are stored in the heap, and their values keep the type of the pointer with the
+// offset of the string in the heap in place of the address. Strings with the same text
+// are stored once.
+//
+// `valserload()` maps the file in memory (or reads it where `mmap()` is not available)
+// and doesn't look at the values: their offsets are turned into pointers by `valserget()`
+// each time a value is read, or all at once by `valservals()`, that returns the values as
+// an array of `val_t` to be used directly. Files with no strings are ready to be used
+// as soon as they are mapped.
+//
+// Buffers are stored (if VALSTDBUF is defined) as `struct valptr_buf_s` at the start of
+// the heap: they are the only values that are fixed when the file is loaded. Loaded
+// buffers don't own their memory (their `cap` is 0). Interned strings are stored as
+// strings (and loaded as `char *`). Other pointers can't be stored.
+//
+// Files are meant to be read on the same kind of machine that wrote them: the byte order
+// and VALNATIVEINT must be the same. The content of the file is trusted.
+
+#ifndef VALSER_VERSION
+#define VALSER_VERSION 0x0004009C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "valmap.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+  #define VAL_MMAP 1
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+#endif
+
+#define VALSER_MAGIC     "VALSER\x00\x01"
+#define VALSER_ORDER     ((uint64_t)0x0102030405060708)
+#define VALSER_NATIVEINT 0x01   // Written with VALNATIVEINT defined
+
+typedef struct {
+  char     magic[8];
+  uint64_t order;    // VALSER_ORDER in the byte order of the writer
+  uint64_t flags;
+  uint64_t count;    // Number of values
+  uint64_t nrefs;    // Number of values that refer to the heap
+  uint64_t nbufs;    // Number of buffers at the start of the heap
+  uint64_t heap;     // Bytes in the heap
+} valser_header_t;
+
+typedef struct valser_s {
+  val_t  *v;         // The values (with heap offsets until `nrefs` is 0)
+  size_t  count;
+  size_t  nrefs;     // Values still to be turned into pointers
+  char   *heap;
+  void   *data;      // The whole file
+  size_t  size;
+  int     mapped;
+} *valser_t;
+
+// Strings and buffers refer to the heap. An offset of 0 is a NULL pointer.
+#define valser_isref(x) (((x).v & VAL_STRHASH_MASK) == VAL_STRHASH_VALUE)
+
+// ==== Writing
+
+typedef struct {
+  char   *heap;
+  size_t  len;
+  size_t  cap;
+} valser_heap_t;
+
+// Appends `len` bytes (zeros if `data` is NULL) to the heap, plus a NUL if `nul` is set.
+// Returns their offset, 0 if there's no memory (no data is at offset 0 but the first word).
+static inline size_t valser_heapadd(valser_heap_t *h, const void *data, size_t len, int nul) {
+  size_t need = h->len + len + (nul != 0);
+  if (need > h->cap) {
+    size_t cap = h->cap ? 2 * h->cap : 4096;
+    while (cap < need) cap *= 2;
+    char *p = realloc(h->heap, cap);
+    if (p == NULL) { errno = ENOMEM; return 0; }
+    h->heap = p;
+    h->cap = cap;
+  }
+  size_t off = h->len;
+  if (len && data) memcpy(h->heap + off, data, len);
+  else if (len) memset(h->heap + off, 0, len);
+  if (nul) h->heap[off + len] = '\0';
+  h->len = need;
+  return off;
+}
+
+// Writes the `n` values to the file `f`.
+// Returns 0 or -1 with errno set to EINVAL (if a value is a pointer other than a string or a
+// buffer), to ENOMEM, or as set by `fwrite()`.
+static inline int valserwrite(FILE *f, const val_t *src, size_t n) {
+  valser_header_t hdr;
+  memcpy(hdr.magic, VALSER_MAGIC, 8);
+  hdr.order = VALSER_ORDER;
+#ifdef VALNATIVEINT
+  hdr.flags = VALSER_NATIVEINT;
+#else
+  hdr.flags = 0;
+#endif
+  hdr.count = n;
+  hdr.nrefs = 0;
+  hdr.nbufs = 0;
+
+#ifdef VALSTDBUF
+  for (size_t i = 0; i < n; i++) hdr.nbufs += valisbufptr(src[i]) && valtoptr(src[i]) != NULL;
+#endif
+
+  val_t *dst = malloc((n ? n : 1) * sizeof(val_t));
+  valmap_t strs = valmapnew(VALMAP_SEMANTIC);
+  valser_heap_t h = {NULL, 0, 0};
+  int ret = -1;
+  if (dst == NULL || strs == NULL) { errno = ENOMEM; goto done; }
+
+  // The 8 bytes at offset 0 are not used (offset 0 is NULL), then the buffers
+  valser_heapadd(&h, NULL, 8, 0);
+  if (h.len != 8) goto done;
+#ifdef VALSTDBUF
+  size_t nextbuf = h.len;
+  if (hdr.nbufs && valser_heapadd(&h, NULL, hdr.nbufs * sizeof(struct valptr_buf_s), 0) == 0) goto done;
+#endif
+
+  for (size_t i = 0; i < n; i++) {
+    val_t x = src[i];
+    uint64_t type = x.v & VAL_TYPE_MASK;
+    dst[i] = x;
+    if (val_isnumber(x) || val_is_sstr(x) || (type == VAL_CONST_ANY)) continue;
+
+    if (type != VALPTR_CHAR && type != VALPTR_BUF
+#ifdef VALINTERN
+        && type != VALPTR_INTERN
+#endif
+       ) { errno = EINVAL; goto done; }
+
+    hdr.nrefs++;
+    size_t off = 0;
+#ifdef VALSTDBUF
+    if (type == VALPTR_BUF) {
+      valptr_buf_t b = valtoptr(x);
+      if (b != NULL) {
+        struct valptr_buf_s rec = {NULL, b->len, 0, 0};
+        size_t data = valser_heapadd(&h, b->buf ? b->buf : "", b->buf ? b->len : 0, 1);
+        if (data == 0) goto done;
+        rec.buf = (char *)(uintptr_t)data;
+        if (!b->buf) rec.len = 0;
+        memcpy(h.heap + nextbuf, &rec, sizeof(rec));
+        off = nextbuf;
+        nextbuf += sizeof(rec);
+      }
+      dst[i].v = VALPTR_BUF | off;
+      continue;
+    }
+#endif
+    char *s = val_get_charptr(x);
+    if (s != NULL) {
+      val_t *ref = valmap_ref(strs, val(s));
+      if (ref) off = (size_t)valtoint(*ref);
+      else {
+        off = valser_heapadd(&h, s, strlen(s), 1);
+        if (off == 0 || valmap_set(strs, val(s), val((int64_t)off)) < 0) goto done;
+      }
+    }
+    dst[i].v = VALPTR_CHAR | off;
+  }
+
+  // The heap is padded to a multiple of 8 bytes
+  while (h.len % 8) if (valser_heapadd(&h, NULL, 0, 1) == 0) goto done;
+  hdr.heap = h.len;
+
+  if (fwrite(&hdr, sizeof(hdr), 1, f) != 1
+      || (n && fwrite(dst, sizeof(val_t), n, f) != n)
+      || fwrite(h.heap, 1, h.len, f) != h.len) goto done;
+  ret = 0;
+
+done:
+  free(h.heap);
+  valmapfree(strs);
+  free(dst);
+  return ret;
+}
+
+// Writes the `n` values to the file `path` (as `valserwrite()`).
+static inline int valsersave(const char *path, const val_t *src, size_t n) {
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) return -1;
+  int ret = valserwrite(f, src, n);
+  if (fclose(f) != 0) ret = -1;
+  return ret;
+}
+
+// ==== Loading
+
+// Releases the loaded values (they, and the strings they point to, can't be used anymore).
+// Returns NULL.
+static inline valser_t valserfree(valser_t s) {
+  if (s) {
+#ifdef VAL_MMAP
+    if (s->mapped) munmap(s->data, s->size);
+    else
+#endif
+    free(s->data);
+    free(s);
+  }
+  return NULL;
+}
+
+// Checks the header and points the buffers to their data
+static inline valser_t valser_open(valser_t s) {
+  valser_header_t hdr;
+  if (s->size < sizeof(hdr)) { errno = EINVAL; return valserfree(s); }
+  memcpy(&hdr, s->data, sizeof(hdr));
+
+  int flags = 0;
+#ifdef VALNATIVEINT
+  flags = VALSER_NATIVEINT;
+#endif
+  if (memcmp(hdr.magic, VALSER_MAGIC, 8) != 0 || hdr.order != VALSER_ORDER || hdr.flags != (uint64_t)flags
+      || hdr.count > (s->size - sizeof(hdr)) / sizeof(val_t)
+      || hdr.heap != s->size - sizeof(hdr) - hdr.count * sizeof(val_t) || hdr.heap < 8) {
+    errno = EINVAL;
+    return valserfree(s);
+  }
+
+  s->v = (val_t *)((char *)s->data + sizeof(hdr));
+  s->count = hdr.count;
+  s->nrefs = hdr.nrefs;
+  s->heap = (char *)(s->v + hdr.count);
+
+#ifdef VALSTDBUF
+  if (hdr.nbufs > (hdr.heap - 8) / sizeof(struct valptr_buf_s)) { errno = EINVAL; return valserfree(s); }
+  valptr_buf_t b = (valptr_buf_t)(s->heap + 8);
+  for (size_t i = 0; i < hdr.nbufs; i++) {
+    uintptr_t off = (uintptr_t)b[i].buf;
+    if (off >= hdr.heap || b[i].len >= hdr.heap - off) { errno = EINVAL; return valserfree(s); }
+    b[i].buf = s->heap + off;
+  }
+#else
+  if (hdr.nbufs) { errno = EINVAL; return valserfree(s); }
+#endif
+  return s;
+}
+
+// Loads the values written in the file `path` by `valsersave()`. The values are not read:
+// the time taken doesn't depend on their number (but on the number of buffers).
+// Returns NULL with errno set to EINVAL (if the file was not written by `valsersave()` on
+// the same kind of machine), to ENOMEM or as set by `open()`/`fopen()`.
+static inline valser_t valserload(const char *path) {
+  valser_t s = malloc(sizeof(struct valser_s));
+  if (s == NULL) { errno = ENOMEM; return NULL; }
+  s->data = NULL;
+  s->size = 0;
+  s->mapped = 0;
+
+#ifdef VAL_MMAP
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) { free(s); return NULL; }
+  struct stat st;
+  if (fstat(fd, &st) != 0) { close(fd); free(s); return NULL; }
+  s->size = (size_t)st.st_size;
+  if (s->size == 0) { close(fd); errno = EINVAL; free(s); return NULL; }
+  // Private: the pages that are changed (by turning offsets into pointers) are copied
+  s->data = mmap(NULL, s->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (s->data == MAP_FAILED) { free(s); return NULL; }
+  s->mapped = 1;
+#else
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) { free(s); return NULL; }
+  if (fseek(f, 0, SEEK_END) == 0) {
+    long size = ftell(f);
+    if (size > 0) s->size = (size_t)size;
+  }
+  s->data = s->size ? malloc(s->size) : NULL;
+  if (s->data == NULL || fseek(f, 0, SEEK_SET) != 0 || fread(s->data, 1, s->size, f) != s->size) {
+    fclose(f);
+    errno = (s->size && s->data == NULL) ? ENOMEM : EINVAL;
+    return valserfree(s);
+  }
+  fclose(f);
+#endif
+  return valser_open(s);
+}
+
+#define valsercount(s) ((s)->count)
+
+static inline val_t valser_ptr(valser_t s, val_t x) {
+  uint64_t off = x.v & VAL_PAYLOAD_MASK;
+  if (off) x.v = (x.v & ~VAL_PAYLOAD_MASK) | ((uintptr_t)(s->heap + off) & VAL_PAYLOAD_MASK);
+  return x;
+}
+
+// Returns the value at position `i` (`valnil` if there's no such position)
+static inline val_t valserget(valser_t s, size_t i) {
+  if (i >= s->count) return valnil;
+  val_t x = s->v[i];
+  if (s->nrefs && valser_isref(x)) x = valser_ptr(s, x);
+  return x;
+}
+
+// Returns the array of the values (`valsercount(s)` of them), to be used until `valserfree()`.
+// The first call turns the offsets of the strings into pointers (if there are strings).
+static inline val_t *valservals(valser_t s) {
+  if (s->nrefs) {
+    val_t *v = s->v;
+    for (size_t i = 0; i < s->count; i++)
+      if (valser_isref(v[i])) v[i] = valser_ptr(s, v[i]);
+    s->nrefs = 0;
+  }
+  return s->v;
+}
+
+#endif // VALSER_VERSION
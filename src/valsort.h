@@ -0,0 +1,622 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Sorting arrays of val_t in the same order of `val_cmp()`.
+//
+// `valsort()` doesn't compare values: it sorts their sort keys (see `valsortkey()`
+// in `val.h`) with an LSD radix sort, one byte at a time. The keys already place
+// numbers, strings and the other values in their own ranges, so the radix sort
+// partitions the values by type and orders each partition in the same passes.
+// Passes on bytes that are the same for all the keys (e.g. the top bytes of small
+// integers) are skipped.
+//
+// Strings are ordered by the radix sort on their first 6 bytes. The strings that
+// are still tied (same first 6 bytes and longer than that) are then sorted by a
+// multikey quicksort on the bytes that follow.
+//
+// Values that are equal for `val_cmp()` (e.g. `0` and `-0.0`) are not guaranteed to
+// keep their order. As for `valsortkey()`, NaNs are placed after +inf.
+
+#ifndef VALSORT_VERSION
+#define VALSORT_VERSION 0x0004009C
+
+#include <stdlib.h>
+#include "valbatch.h"
+
+#define VALSORT_SMALL  32   // Arrays up to this size are sorted by insertion
+#define VALSORT_CHUNK 256   // Keys are computed in chunks of this size
+
+typedef struct {
+  uint64_t key;
+  val_t    v;
+} valsort_item_t;
+
+// A string being sorted by the multikey quicksort
+typedef struct {
+  const char *s;
+  size_t      len;
+  val_t       v;
+} valsort_str_t;
+
+// ==== Strings
+
+// The byte at depth `d` plus one, 0 at the end of the string (buffers can contain NUL bytes)
+static inline int valsort_byte(const valsort_str_t *x, size_t d) {
+  return (d < x->len) ? (uint8_t)x->s[d] + 1 : 0;
+}
+
+// The same result of `val_cmp()` on two strings whose first `d` bytes are the same
+static inline int valsort_strcmp(const valsort_str_t *a, const valsort_str_t *b, size_t d) {
+  size_t len = (a->len < b->len) ? a->len : b->len;
+  int c = (len > d) ? memcmp(a->s + d, b->s + d, len - d) : 0;
+  return c ? c : (a->len > b->len) - (a->len < b->len);
+}
+
+static inline void valsort_strswap(valsort_str_t *x, size_t i, size_t j) {
+  valsort_str_t t = x[i]; x[i] = x[j]; x[j] = t;
+}
+
+static inline int valsort_lencmp(const void *a, const void *b) {
+  size_t x = ((const valsort_str_t *)a)->len, y = ((const valsort_str_t *)b)->len;
+  return (x > y) - (x < y);
+}
+
+// Sorts by length the `n` strings in `x` that have the same bytes
+static inline void valsort_bylen(valsort_str_t *x, size_t n) {
+  size_t i = 1;
+  while (i < n && x[i].len == x[0].len) i++;
+  if (i < n) qsort(x, n, sizeof(valsort_str_t), valsort_lencmp);
+}
+
+// Multikey quicksort (Bentley and Sedgewick) of the strings whose first `d` bytes are the same.
+// The array is split in the strings whose byte at depth `d` is lower, equal or greater than
+// the pivot; only the equal ones move to the next byte.
+static inline void valsort_mkqs(valsort_str_t *x, size_t n, size_t d) {
+  while (n > 1) {
+    if (n <= VALSORT_SMALL) {
+      for (size_t i = 1; i < n; i++) {
+        valsort_str_t t = x[i];
+        size_t j = i;
+        for (; j > 0 && valsort_strcmp(&x[j - 1], &t, d) > 0; j--) x[j] = x[j - 1];
+        x[j] = t;
+      }
+      return;
+    }
+
+    // Median of three
+    int a = valsort_byte(&x[0], d), b = valsort_byte(&x[n / 2], d), c = valsort_byte(&x[n - 1], d);
+    int pivot = (a < b) ? ((b < c) ? b : (a < c) ? c : a)
+                        : ((a < c) ? a : (b < c) ? c : b);
+
+    size_t lt = 0, i = 0, gt = n;
+    while (i < gt) {
+      int k = valsort_byte(&x[i], d);
+      if      (k < pivot) valsort_strswap(x, lt++, i++);
+      else if (k > pivot) valsort_strswap(x, i, --gt);
+      else i++;
+    }
+
+    valsort_mkqs(x, lt, d);
+    valsort_mkqs(x + gt, n - gt, d);
+    if (pivot == 0) {
+      // The strings in the middle end before `d`: their bytes are the same but buffers
+      // with NULs can still have different lengths (e.g. "a\0" and "a\0\0" at depth 6)
+      valsort_bylen(x + lt, gt - lt);
+      return;
+    }
+    x += lt;
+    n  = gt - lt;
+    d++;
+  }
+}
+
+static inline int valsort_cmp(const void *a, const void *b) {
+  return val_cmp(*(const val_t *)a, *(const val_t *)b);
+}
+
+// Sorts the `n` values in `a` that are strings with the same (tied) sort key
+static inline void valsort_ties(val_t *a, size_t n) {
+  valsort_str_t *x = malloc(n * sizeof(valsort_str_t));
+  if (x == NULL) { qsort(a, n, sizeof(val_t), valsort_cmp); return; }  // No memory: slower, but still sorted
+
+  for (size_t i = 0; i < n; i++) {
+    char buf[VAL_SSTR_LEN + 1];
+    x[i].v = a[i];
+#ifdef VALSTDBUF
+    x[i].s = val_get_strlen(a[i], buf, &x[i].len);
+#else
+    x[i].s   = val_get_strptr(a[i], buf);
+    x[i].len = x[i].s ? strlen(x[i].s) : 0;
+#endif
+  }
+
+  // Strings with the same key have the same first bytes
+  valsort_mkqs(x, n, VAL_SORTKEY_LEN);
+
+  for (size_t i = 0; i < n; i++) a[i] = x[i].v;
+  free(x);
+}
+
+// ==== Sorting
+
+// Insertion sort on the keys
+static inline void valsort_small(valsort_item_t *x, size_t n) {
+  for (size_t i = 1; i < n; i++) {
+    valsort_item_t t = x[i];
+    size_t j = i;
+    for (; j > 0 && x[j - 1].key > t.key; j--) x[j] = x[j - 1];
+    x[j] = t;
+  }
+}
+
+// LSD radix sort of `n` items on their keys, using `tmp` as temporary storage.
+// Returns the array (`x` or `tmp`) with the sorted items.
+static inline valsort_item_t *valsort_radix(valsort_item_t *x, valsort_item_t *tmp, size_t n,
+                                            size_t (*cnt)[256]) {
+  for (int d = 0; d < 8; d++) {
+    size_t *c = cnt[d];
+    int shift = 8 * d;
+
+    // All the keys have the same byte: nothing to do
+    if (c[(x[0].key >> shift) & 0xFF] == n) continue;
+
+    size_t sum = 0;
+    for (int k = 0; k < 256; k++) { size_t t = c[k]; c[k] = sum; sum += t; }
+
+    for (size_t i = 0; i < n; i++) tmp[c[(x[i].key >> shift) & 0xFF]++] = x[i];
+
+    valsort_item_t *t = x; x = tmp; tmp = t;
+  }
+  return x;
+}
+
+// Stores in `x` the values of `a` with their keys and adds the bytes of the keys to the
+// histograms in `cnt`. Returns non zero if some keys have the tie bit set.
+static inline int valsort_keys(const val_t *a, size_t n, valsort_item_t *x, size_t (*cnt)[256]) {
+  uint64_t keys[VALSORT_CHUNK];
+  int ties = 0;
+  for (size_t base = 0; base < n; base += VALSORT_CHUNK) {
+    size_t m = (n - base < VALSORT_CHUNK) ? (n - base) : VALSORT_CHUNK;
+    valsortkey_n(a + base, m, keys);
+    for (size_t i = 0; i < m; i++) {
+      uint64_t k = keys[i];
+      x[base + i].key = k;
+      x[base + i].v   = a[base + i];
+      for (int d = 0; d < 8; d++) cnt[d][(k >> (8 * d)) & 0xFF]++;
+      ties |= valsortkeytie(k);
+    }
+  }
+  return ties;
+}
+
+// Sorts the `n` items in `x` (`tmp` has room for other `n` items) whose keys are counted in `cnt`
+// and stores their values in `a`. Then sorts the strings with the same tied key (if `ties`).
+static inline void valsort_items(valsort_item_t *x, valsort_item_t *tmp, size_t n, size_t (*cnt)[256],
+                                 int ties, val_t *a) {
+  if (n <= VALSORT_SMALL) valsort_small(x, n);
+  else x = valsort_radix(x, tmp, n, cnt);
+
+  for (size_t i = 0; i < n; i++) a[i] = x[i].v;
+
+  for (size_t i = 0; ties && i < n; ) {
+    size_t j = i + 1;
+    if (valsortkeytie(x[i].key)) {
+      while (j < n && x[j].key == x[i].key) j++;
+      if (j - i > 1) valsort_ties(a + i, j - i);
+    }
+    i = j;
+  }
+}
+
+// The value with the key `k` (for numbers and the other values that are not strings).
+// Different values with the same key (0.0 and -0.0, NaNs, native integers) give the same value.
+static inline uint64_t valsort_unkey(uint64_t k) {
+  if (k <= VAL_SORTKEY_NAN - 1) return (k >> 63) ? (k ^ (uint64_t)0x8000000000000000) : ~k;
+  k -= VAL_SORTKEY_NAN - 1;
+  uint64_t idx = k >> 48;  // 1..7 are 7FF9..7FFF, 8..14 are FFF9..FFFF
+  return (((idx <= 7) ? (uint64_t)0x7FF8 + idx : (uint64_t)0xFFF1 + idx) << 48) | (k & VAL_PAYLOAD_MASK);
+}
+
+static inline uint64_t *valsort_radix_keys(uint64_t *k, uint64_t *tmp, size_t n, size_t (*cnt)[256]) {
+  for (int d = 0; d < 8; d++) {
+    size_t *c = cnt[d];
+    int shift = 8 * d;
+
+    if (c[(k[0] >> shift) & 0xFF] == n) continue;
+
+    size_t sum = 0;
+    for (int j = 0; j < 256; j++) { size_t t = c[j]; c[j] = sum; sum += t; }
+
+    for (size_t i = 0; i < n; i++) tmp[c[(k[i] >> shift) & 0xFF]++] = k[i];
+
+    uint64_t *t = k; k = tmp; tmp = t;
+  }
+  return k;
+}
+
+// Arrays of numbers or of constants are sorted on the keys alone (half the bytes to move)
+// and the values are recovered from the keys. Returns 1 (and does nothing) if a key can't
+// be turned back into its value, 0 if the values are sorted, -1 if there's no memory.
+static inline int valsort_keysonly(val_t *a, size_t n) {
+  uint64_t *k = malloc(2 * n * sizeof(uint64_t));
+  if (k == NULL) { errno = ENOMEM; return -1; }
+
+  size_t (*cnt)[256] = calloc(8, sizeof(*cnt));
+  if (cnt == NULL) { free(k); errno = ENOMEM; return -1; }
+
+  int ret = 0;
+  for (size_t base = 0; base < n && ret == 0; base += VALSORT_CHUNK) {
+    size_t m = (n - base < VALSORT_CHUNK) ? (n - base) : VALSORT_CHUNK;
+    uint64_t diff = 0;
+    valsortkey_n(a + base, m, k + base);
+    for (size_t i = base; i < base + m; i++) {
+      for (int d = 0; d < 8; d++) cnt[d][(k[i] >> (8 * d)) & 0xFF]++;
+      diff |= valsort_unkey(k[i]) ^ a[i].v;
+    }
+    ret = (diff != 0);
+  }
+
+  if (ret == 0) {
+    uint64_t *s = valsort_radix_keys(k, k + n, n, cnt);
+    for (size_t i = 0; i < n; i++) a[i].v = valsort_unkey(s[i]);
+  }
+
+  free(cnt);
+  free(k);
+  return ret;
+}
+
+// Sorts as `valsort()` values that are known to be all of the kind `kind` (as returned
+// by `valcmpkind_n()`, VALCMP_ANY if unknown), without scanning them again.
+static inline int valsort_kind(val_t *a, size_t n, int kind) {
+  if (n < 2) return 0;
+
+  if (n > VALSORT_SMALL) {
+#ifdef VALNATIVEINT
+    if (kind == VALCMP_SYM) {  // Native integers have the same key of the double
+#else
+    if (kind == VALCMP_NUM || kind == VALCMP_SYM) {
+#endif
+      int ret = valsort_keysonly(a, n);
+      if (ret <= 0) return ret;
+    }
+  }
+
+  valsort_item_t *x = malloc(2 * n * sizeof(valsort_item_t));
+  if (x == NULL) { errno = ENOMEM; return -1; }
+
+  // The histograms of the eight bytes of the keys
+  size_t (*cnt)[256] = calloc(8, sizeof(*cnt));
+  if (cnt == NULL) { free(x); errno = ENOMEM; return -1; }
+
+  int ties = valsort_keys(a, n, x, cnt);
+  valsort_items(x, x + n, n, cnt, ties, a);
+
+  free(cnt);
+  free(x);
+  return 0;
+}
+
+// Sorts `n` values in the same order of `val_cmp()`.
+// Returns 0 or -1 (errno set to ENOMEM, with the values unchanged) if there is no memory.
+static inline int valsort(val_t *a, size_t n) {
+  return valsort_kind(a, n, (n > VALSORT_SMALL) ? valcmpkind_n(a, n) : VALCMP_ANY);
+}
+
+// ==== Searching
+
+// Strings (what `val_cmp()` compares with `strcmp()`)
+static inline int valsort_isstr(val_t v) {
+  return ((v.v & VAL_STRHASH_MASK) == VAL_STRHASH_VALUE) | val_is_sstr(v)
+#ifdef VALINTERN
+       | val_is_interned(v)
+#endif
+       ;
+}
+
+// Binary search with the comparison `cmp_` (without branches on the result of `cmp_`).
+// Both the values that can be compared at the next step are prefetched.
+#define VALSORT_LOWER(cmp_)                                    \
+  while (len > 1) {                                            \
+    size_t half = len / 2;                                     \
+    val_prefetch(base + (len - half) / 2);                     \
+    val_prefetch(base + half + (len - half) / 2);              \
+    base += (cmp_(base[half - 1], x) < 0) ? half : 0;          \
+    len  -= half;                                              \
+  }                                                            \
+  return (size_t)(base - a) + (cmp_(base[0], x) < 0);
+
+// Returns the position of the first value in the sorted array `a` that is not lower than `x`
+// (`n` if they are all lower). In a sorted array numbers come before any other value and the
+// strings are all together: if the first and the last value are numbers (strings), they all are
+// and `valcmp_num()` (`valcmp_str()`) is used.
+#define valbsearch(a, n, x) val_bsearch(a, n, val(x))
+static inline size_t val_bsearch(const val_t *a, size_t n, val_t x) {
+  const val_t *base = a;
+  size_t len = n;
+  if (n == 0) return 0;
+
+  if (val_isnumber(x) && val_isnumber(a[0]) && val_isnumber(a[n - 1])) {
+    VALSORT_LOWER(val_cmp_num);
+  }
+  if (valsort_isstr(x) && valsort_isstr(a[0]) && valsort_isstr(a[n - 1])) {
+    VALSORT_LOWER(val_cmp_str);
+  }
+  VALSORT_LOWER(val_cmp);
+}
+
+// Numbers and constants have no ties on their keys: the first lowest key (of the keys
+// xor'ed with `flip` to find the highest one) is the first lowest value.
+static inline size_t valsort_minkey(const val_t *src, size_t n, uint64_t flip) {
+  uint64_t keys[VALSORT_CHUNK];
+  uint64_t best = ~(uint64_t)0;
+  size_t   m    = n;
+
+  for (size_t base = 0; base < n; base += VALSORT_CHUNK) {
+    size_t cnt = (n - base < VALSORT_CHUNK) ? (n - base) : VALSORT_CHUNK;
+    valsortkey_n(src + base, cnt, keys);
+
+    uint64_t b = ~(uint64_t)0;
+    for (size_t i = 0; i < cnt; i++) {
+      uint64_t k = keys[i] ^ flip;
+      b = (k < b) ? k : b;
+    }
+    if (m == n || b < best) {
+      size_t i = 0;
+      while ((keys[i] ^ flip) != b) i++;
+      best = b;
+      m = base + i;
+    }
+  }
+  return m;
+}
+
+// Index of the first minimum (`op_` is `<`) or maximum (`op_` is `>`) with the comparison `cmp_`
+#define VALSORT_MINMAX(cmp_, op_) \
+  for (size_t i = 1; i < n; i++) if (cmp_(src[i], src[m]) op_ 0) m = i;
+
+// Returns the position of the lowest (highest) value in the array: the first one if there are
+// more than one, `n` if the array is empty. If the values are all numbers or all constants,
+// their sort keys are compared (NaNs are after +inf, as in `valsort()`); if they are all strings,
+// they are compared with `valcmp_str()`.
+static inline size_t valmin_n(const val_t *src, size_t n) {
+  size_t m = 0;
+  if (n == 0) return 0;
+  switch (valcmpkind_n(src, n)) {
+    case VALCMP_NUM:
+    case VALCMP_SYM: return valsort_minkey(src, n, 0);
+    case VALCMP_STR: VALSORT_MINMAX(val_cmp_str, <); break;
+    default:         VALSORT_MINMAX(val_cmp, <);     break;
+  }
+  return m;
+}
+
+static inline size_t valmax_n(const val_t *src, size_t n) {
+  size_t m = 0;
+  if (n == 0) return 0;
+  switch (valcmpkind_n(src, n)) {
+    case VALCMP_NUM:
+    case VALCMP_SYM: return valsort_minkey(src, n, ~(uint64_t)0);
+    case VALCMP_STR: VALSORT_MINMAX(val_cmp_str, >); break;
+    default:         VALSORT_MINMAX(val_cmp, >);     break;
+  }
+  return m;
+}
+
+// ==== Parallel sorting
+//
+// `valsort_mt()` is a sample sort on the keys:
+//   - the keys of a sample of the values give the splitters of `VALSORT_MT_BUCKETS` buckets
+//     per thread (values with the same key are always in the same bucket);
+//   - each thread computes the keys of a slice of the array and counts them in each bucket;
+//   - each thread copies its slice into the buckets (at the offsets given by the counts);
+//   - the buckets, assigned to the threads from the largest one, are sorted as in `valsort()`.
+// The buckets are already in order: there's nothing to merge.
+//
+// Threads are POSIX threads. Define VALNOTHREADS (or compile where pthreads are not
+// available) to have `valsort_mt()` be the same as `valsort()`.
+
+#if !defined(VALNOTHREADS) && (defined(__unix__) || defined(__APPLE__))
+  #define VAL_THREADS 1
+  #include <pthread.h>
+  #include <unistd.h>
+#else
+  #define VAL_THREADS 0
+#endif
+
+#define VALSORT_MT_MIN     (1 << 16)   // Smaller arrays are sorted by the calling thread
+#define VALSORT_MT_MAX     64          // Maximum number of threads
+#define VALSORT_MT_BUCKETS 4           // Buckets per thread (no more than 256 buckets in total)
+#define VALSORT_MT_SAMPLE  32          // Sampled keys per bucket
+
+#if VAL_THREADS
+typedef struct {
+  int             phase;
+  const val_t    *src;      // The slice of the array (phases 1 and 2)
+  size_t          lo, hi;
+  valsort_item_t *x;        // Items
+  valsort_item_t *tmp;      // Items in the buckets
+  val_t          *a;        // The array being sorted
+  const uint64_t *split;    // The splitters
+  int             nsplit;
+  size_t         *cnt;      // Items of the slice in each bucket, then their offsets
+  uint8_t        *id;       // The bucket of each item
+  const size_t   *bucket;   // Start of each bucket (phase 3)
+  int            *mine;     // Buckets to sort (phase 3)
+  int             nmine;
+} valsort_task_t;
+
+// The bucket of the key `k`: the number of splitters not above it
+static inline int valsort_bucket(const uint64_t *split, int nsplit, uint64_t k) {
+  int lo = 0, hi = nsplit;
+  while (lo < hi) {
+    int m = (lo + hi) / 2;
+    if (split[m] <= k) lo = m + 1;
+    else hi = m;
+  }
+  return lo;
+}
+
+static inline void *valsort_worker(void *arg) {
+  valsort_task_t *t = arg;
+
+  switch (t->phase) {
+    case 1: {  // Keys and bucket counts
+      valsort_item_t *x = t->x + t->lo;
+      size_t n = t->hi - t->lo;
+      uint64_t keys[VALSORT_CHUNK];
+      for (size_t base = 0; base < n; base += VALSORT_CHUNK) {
+        size_t m = (n - base < VALSORT_CHUNK) ? (n - base) : VALSORT_CHUNK;
+        valsortkey_n(t->src + t->lo + base, m, keys);
+        for (size_t i = 0; i < m; i++) {
+          x[base + i].key = keys[i];
+          x[base + i].v   = t->src[t->lo + base + i];
+          int b = valsort_bucket(t->split, t->nsplit, keys[i]);
+          t->id[t->lo + base + i] = (uint8_t)b;
+          t->cnt[b]++;
+        }
+      }
+      break;
+    }
+
+    case 2:   // Scatter into the buckets
+      for (size_t i = t->lo; i < t->hi; i++) t->tmp[t->cnt[t->id[i]]++] = t->x[i];
+      break;
+
+    case 3: { // Sort the buckets
+      size_t (*cnt)[256] = malloc(8 * sizeof(*cnt));
+      for (int b = 0; b < t->nmine; b++) {
+        size_t lo = t->bucket[t->mine[b]];
+        size_t n  = t->bucket[t->mine[b] + 1] - lo;
+        if (n == 0) continue;
+        if (cnt == NULL) {  // No memory: sort the values directly
+          for (size_t i = 0; i < n; i++) t->a[lo + i] = t->tmp[lo + i].v;
+          qsort(t->a + lo, n, sizeof(val_t), valsort_cmp);
+          continue;
+        }
+        int ties = 0;
+        memset(cnt, 0, 8 * sizeof(*cnt));
+        for (size_t i = lo; i < lo + n; i++) {
+          uint64_t k = t->tmp[i].key;
+          for (int d = 0; d < 8; d++) cnt[d][(k >> (8 * d)) & 0xFF]++;
+          ties |= valsortkeytie(k);
+        }
+        valsort_items(t->tmp + lo, t->x + lo, n, cnt, ties, t->a + lo);
+      }
+      free(cnt);
+      break;
+    }
+  }
+  return NULL;
+}
+
+// Runs the current phase of the tasks, one thread each (in the calling thread if it can't be created)
+static inline void valsort_run(valsort_task_t *task, int nthreads) {
+  pthread_t th[VALSORT_MT_MAX];
+  int       ok[VALSORT_MT_MAX];
+
+  for (int t = 1; t < nthreads; t++) ok[t] = (pthread_create(&th[t], NULL, valsort_worker, &task[t]) == 0);
+  valsort_worker(&task[0]);
+  for (int t = 1; t < nthreads; t++) {
+    if (ok[t]) pthread_join(th[t], NULL);
+    else valsort_worker(&task[t]);
+  }
+}
+
+static inline int valsort_cmpkey(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+#endif
+
+// Same as `valsort()` using `nthreads` threads (if `nthreads` is 0 or negative, one for each
+// online CPU). The order is the same of `valsort()`.
+static inline int valsort_mt(val_t *a, size_t n, int nthreads) {
+#if VAL_THREADS
+  if (nthreads <= 0) nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (nthreads > VALSORT_MT_MAX) nthreads = VALSORT_MT_MAX;
+  if (nthreads <= 1 || n < VALSORT_MT_MIN) return valsort(a, n);
+
+  int nbuckets = nthreads * VALSORT_MT_BUCKETS;
+  int nsample  = nbuckets * VALSORT_MT_SAMPLE;
+
+  valsort_item_t *x     = malloc(2 * n * sizeof(valsort_item_t));
+  valsort_task_t *task  = calloc((size_t)nthreads, sizeof(valsort_task_t));
+  size_t         *cnt   = calloc((size_t)nthreads * (size_t)nbuckets, sizeof(size_t));
+  size_t         *start = malloc(((size_t)nbuckets + 1) * sizeof(size_t));
+  int            *mine  = malloc((size_t)(nthreads + 1) * (size_t)nbuckets * sizeof(int));
+  uint64_t       *split = malloc((size_t)nsample * sizeof(uint64_t));
+  uint8_t        *id    = malloc(n);
+
+  if (!x || !task || !cnt || !start || !mine || !split || !id) {
+    free(x); free(task); free(cnt); free(start); free(mine); free(split); free(id);
+    errno = ENOMEM;
+    return -1;
+  }
+
+  // The splitters are evenly spaced in the sorted sample
+  for (int i = 0; i < nsample; i++) split[i] = valsortkey(a[(size_t)i * (n / (size_t)nsample)]);
+  qsort(split, (size_t)nsample, sizeof(uint64_t), valsort_cmpkey);
+  for (int b = 1; b < nbuckets; b++) split[b - 1] = split[b * VALSORT_MT_SAMPLE];
+
+  for (int t = 0; t < nthreads; t++) {
+    task[t].src    = a;
+    task[t].lo     = n * (size_t)t / (size_t)nthreads;
+    task[t].hi     = n * (size_t)(t + 1) / (size_t)nthreads;
+    task[t].x      = x;
+    task[t].tmp    = x + n;
+    task[t].a      = a;
+    task[t].split  = split;
+    task[t].nsplit = nbuckets - 1;
+    task[t].cnt    = cnt + (size_t)t * (size_t)nbuckets;
+    task[t].id     = id;
+    task[t].bucket = start;
+    task[t].phase  = 1;
+  }
+  valsort_run(task, nthreads);
+
+  // Offsets of each slice in each bucket (buckets in order, then slices in order)
+  size_t sum = 0;
+  for (int b = 0; b < nbuckets; b++) {
+    start[b] = sum;
+    for (int t = 0; t < nthreads; t++) {
+      size_t c = task[t].cnt[b];
+      task[t].cnt[b] = sum;
+      sum += c;
+    }
+  }
+  start[nbuckets] = sum;
+
+  for (int t = 0; t < nthreads; t++) task[t].phase = 2;
+  valsort_run(task, nthreads);
+
+  // Buckets from the largest one, each to the thread with less work so far.
+  // `order` are the buckets by size, then each thread has room for all of them.
+  int   *order = mine;
+  size_t load[VALSORT_MT_MAX] = {0};
+  for (int i = 0; i < nbuckets; i++) {
+    size_t sb = start[i + 1] - start[i];
+    int j = i;
+    for (; j > 0 && start[order[j - 1] + 1] - start[order[j - 1]] < sb; j--) order[j] = order[j - 1];
+    order[j] = i;
+  }
+  for (int i = 0; i < nbuckets; i++) {
+    int best = 0;
+    for (int t = 1; t < nthreads; t++) if (load[t] < load[best]) best = t;
+    load[best] += start[order[i] + 1] - start[order[i]];
+    task[best].mine = mine + (size_t)(best + 1) * (size_t)nbuckets;
+    task[best].mine[task[best].nmine++] = order[i];
+  }
+
+  for (int t = 0; t < nthreads; t++) task[t].phase = 3;
+  valsort_run(task, nthreads);
+
+  free(id); free(split); free(mine); free(start); free(cnt); free(task); free(x);
+  return 0;
+#else
+  (void)nthreads;
+  return valsort(a, n);
+#endif
+}
+
+#endif // VALSORT_VERSION
@@ -0,0 +1,272 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+// Growable arrays of val_t.
+//
+// A vector holds its values in a single array (`vec->v`, with `vec->len` values) that
+// doubles when it's full. Arrays of C integers, doubles and strings can be appended at
+// once: the values are boxed in a loop with no call and no branch that the compiler can
+// vectorize.
+//
+// The vector remembers the kinds of values (numbers, strings, constants, others) that
+// have been stored in it. When they are all of the same kind, `valveckind()` tells it
+// without looking at the values, so that `valvecsum()`, `valvecsort()` or any function
+// that takes the kind as `valcmpkind_n()` returns it can go straight to their specialized
+// code. Removing or overwriting values doesn't forget their kind (the result is still
+// correct, just less specific): `valvecrescan()` recomputes it. It must also be called
+// after writing directly into `vec->v`.
+
+#ifndef VALVEC_VERSION
+#define VALVEC_VERSION 0x0004009C
+
+#include <stdlib.h>
+#include <string.h>
+#include "valsort.h"
+
+#define VALVEC_MINCAP 8
+
+typedef struct valvec_s {
+  val_t   *v;        // The values
+  size_t   len;      // Number of values
+  size_t   cap;      // Number of values that fit in `v`
+  unsigned kinds;    // Bit `k` is set if a value of kind `k` (VALCMP_xxx) has been stored
+} *valvec_t;
+
+// Bit of the kind of the value (VALCMP_ANY stands for "not a number, string or constant")
+static inline unsigned valvec_kindbit(val_t x) {
+  if (((x.v & VAL_F7_TYPE_MASK) < VAL_CONST_ANY)
+#ifdef VALNATIVEINT
+      | val_is_int32(x)
+#endif
+     ) return 1u << VALCMP_NUM;
+  if (valsort_isstr(x)) return 1u << VALCMP_STR;
+  if ((x.v & VAL_TYPE_MASK) == VAL_CONST_ANY) return 1u << VALCMP_SYM;
+  return 1u << VALCMP_ANY;
+}
+
+static inline unsigned valvec_kindbits(const val_t *src, size_t n) {
+  return n ? 1u << valcmpkind_n(src, n) : 0;
+}
+
+// ==== Vectors
+
+// Returns a new empty vector with room for `cap` values, or NULL (with errno set to ENOMEM)
+// if there's no memory.
+static inline valvec_t valvecnew(size_t cap) {
+  valvec_t vec = malloc(sizeof(struct valvec_s));
+  if (vec == NULL) { errno = ENOMEM; return NULL; }
+  vec->v = NULL;
+  vec->len = vec->cap = 0;
+  vec->kinds = 0;
+  if (cap > 0) {
+    vec->v = malloc(cap * sizeof(val_t));
+    if (vec->v == NULL) { free(vec); errno = ENOMEM; return NULL; }
+    vec->cap = cap;
+  }
+  return vec;
+}
+
+// Releases the vector (not what its values point to). Returns NULL.
+static inline valvec_t valvecfree(valvec_t vec) {
+  if (vec) {
+    free(vec->v);
+    free(vec);
+  }
+  return NULL;
+}
+
+#define valveclen(vec) ((vec)->len)
+
+// Makes room for at least `n` values (in total) in the vector.
+// Returns 0 or -1 (errno set to ENOMEM, with the vector unchanged) if there's no memory.
+static inline int valvecreserve(valvec_t vec, size_t n) {
+  if (n <= vec->cap) return 0;
+  if (n > SIZE_MAX / sizeof(val_t)) { errno = ENOMEM; return -1; }
+  val_t *v = realloc(vec->v, n * sizeof(val_t));
+  if (v == NULL) { errno = ENOMEM; return -1; }
+  vec->v = v;
+  vec->cap = n;
+  return 0;
+}
+
+// Makes room for `n` more values, doubling the capacity if it's not enough
+static inline int valvec_grow(valvec_t vec, size_t n) {
+  if (n <= vec->cap - vec->len) return 0;
+  if (n > SIZE_MAX / sizeof(val_t) - vec->len) { errno = ENOMEM; return -1; }
+  size_t cap = vec->cap < VALVEC_MINCAP ? VALVEC_MINCAP : vec->cap;
+  while (cap - vec->len < n) cap = (cap > SIZE_MAX / (2 * sizeof(val_t))) ? vec->len + n : 2 * cap;
+  return valvecreserve(vec, cap);
+}
+
+// Releases the memory that is not used by the values.
+// Returns 0 or -1 (errno set to ENOMEM, with the vector unchanged) if there's no memory.
+static inline int valvecshrink(valvec_t vec) {
+  if (vec->len == vec->cap) return 0;
+  if (vec->len == 0) {
+    free(vec->v);
+    vec->v = NULL;
+    vec->cap = 0;
+    return 0;
+  }
+  val_t *v = realloc(vec->v, vec->len * sizeof(val_t));
+  if (v == NULL) { errno = ENOMEM; return -1; }
+  vec->v = v;
+  vec->cap = vec->len;
+  return 0;
+}
+
+// Removes all the values (keeping the memory)
+static inline void valvecclear(valvec_t vec) {
+  vec->len = 0;
+  vec->kinds = 0;
+}
+
+// ==== Values
+
+// Adds a value at the end of the vector.
+// Returns 0 or -1 (errno set to ENOMEM) if there's no memory.
+#define valvecpush(vec, x) valvec_push(vec, val(x))
+static inline int valvec_push(valvec_t vec, val_t x) {
+  if (vec->len == vec->cap && valvec_grow(vec, 1) < 0) return -1;
+  vec->v[vec->len++] = x;
+  vec->kinds |= valvec_kindbit(x);
+  return 0;
+}
+
+// Removes the last value and returns it (`valnil` if the vector is empty)
+static inline val_t valvecpop(valvec_t vec) {
+  if (vec->len == 0) return valnil;
+  return vec->v[--vec->len];
+}
+
+// Returns the value at position `i` (`valnil` if there's no such position)
+static inline val_t valvecget(valvec_t vec, size_t i) {
+  if (i >= vec->len) return valnil;
+  return vec->v[i];
+}
+
+// Replaces the value at position `i`.
+// Returns 0 or -1 (errno set to EINVAL) if there's no such position.
+#define valvecset(vec, i, x) valvec_set(vec, i, val(x))
+static inline int valvec_set(valvec_t vec, size_t i, val_t x) {
+  if (i >= vec->len) { errno = EINVAL; return -1; }
+  vec->v[i] = x;
+  vec->kinds |= valvec_kindbit(x);
+  return 0;
+}
+
+// Returns the kind of all the values in the vector as `valcmpkind_n()` does: VALCMP_NUM,
+// VALCMP_STR or VALCMP_SYM if they are all numbers, strings or constants, VALCMP_ANY if
+// they are not of the same kind or if the vector is empty.
+static inline int valveckind(valvec_t vec) {
+  unsigned k = vec->kinds;
+  if (vec->len == 0 || k == 0 || (k & (k - 1))) return VALCMP_ANY;
+  return val_ctz64(k);
+}
+
+// Recomputes the kind of the values (after they have been removed, replaced, or written
+// directly in `vec->v`)
+static inline void valvecrescan(valvec_t vec) {
+  vec->kinds = valvec_kindbits(vec->v, vec->len);
+}
+
+// ==== Bulk append
+
+// Adds `n` values at the end of the vector.
+// Returns 0 or -1 (errno set to ENOMEM, with the vector unchanged) if there's no memory.
+static inline int valvecappend(valvec_t vec, const val_t *src, size_t n) {
+  if (n == 0) return 0;
+  if (valvec_grow(vec, n) < 0) return -1;
+  memcpy(vec->v + vec->len, src, n * sizeof(val_t));
+  vec->kinds |= valvec_kindbits(src, n);
+  vec->len += n;
+  return 0;
+}
+
+// Adds `n` integers as numbers (native integers if VALNATIVEINT is defined)
+static inline int valvecappendint(valvec_t vec, const int *src, size_t n) {
+  if (n == 0) return 0;
+  if (valvec_grow(vec, n) < 0) return -1;
+  val_t *dst = vec->v + vec->len;
+  for (size_t i = 0; i < n; i++) {
+#ifdef VALNATIVEINT
+    dst[i].v = VAL_INT32 | (uint32_t)src[i];
+#else
+    dst[i] = val_fromdouble((double)src[i]);
+#endif
+  }
+  vec->kinds |= 1u << VALCMP_NUM;
+  vec->len += n;
+  return 0;
+}
+
+// Adds `n` doubles (a double and its val_t have the same bits: they are just copied)
+static inline int valvecappenddouble(valvec_t vec, const double *src, size_t n) {
+  if (n == 0) return 0;
+  if (valvec_grow(vec, n) < 0) return -1;
+  memcpy(vec->v + vec->len, src, n * sizeof(val_t));
+  vec->kinds |= 1u << VALCMP_NUM;
+  vec->len += n;
+  return 0;
+}
+
+// Adds `n` strings (the pointers, not a copy of the strings). NULL pointers are not
+// allowed.
+static inline int valvecappendstr(valvec_t vec, char *const *src, size_t n) {
+  if (n == 0) return 0;
+  if (valvec_grow(vec, n) < 0) return -1;
+  val_t *dst = vec->v + vec->len;
+  for (size_t i = 0; i < n; i++) dst[i].v = VALPTR_CHAR | ((uintptr_t)src[i] & VAL_PAYLOAD_MASK);
+  vec->kinds |= 1u << VALCMP_STR;
+  vec->len += n;
+  return 0;
+}
+
+// ==== Operations
+
+// The number in `x` (that must be a number), with no branch
+static inline double valvec_num(val_t x) {
+  double d;
+#ifdef VALNATIVEINT
+  double i = (double)(int32_t)(x.v & VAL_32BIT_MASK);
+  uint64_t ibits, m = (uint64_t)0 - (uint64_t)val_is_int32(x);
+  memcpy(&ibits, &i, sizeof(double));
+  x.v = (x.v & ~m) | (ibits & m);
+#endif
+  memcpy(&d, &x, sizeof(double));
+  return d;
+}
+
+// Returns the sum of the numbers in the vector (other values are skipped).
+// If the values are all numbers they are added with no check, in four separate sums (so
+// that the additions don't wait for each other): the rounding may differ from adding
+// them in order.
+static inline double valvecsum(valvec_t vec) {
+  const val_t *v = vec->v;
+  size_t n = vec->len;
+  size_t i = 0;
+
+  if (valveckind(vec) == VALCMP_NUM) {
+    double s[4] = {0.0, 0.0, 0.0, 0.0};
+    for (; i + 4 <= n; i += 4)
+      for (int j = 0; j < 4; j++) s[j] += valvec_num(v[i + j]);
+    for (; i < n; i++) s[0] += valvec_num(v[i]);
+    return (s[0] + s[1]) + (s[2] + s[3]);
+  }
+
+  double sum = 0.0;
+  for (; i < n; i++)
+    if (val_isnumber(v[i])) sum += valtodouble(v[i]);
+  return sum;
+}
+
+// Sorts the vector as `valsort()`. The values are scanned only if their kind is not
+// known (and the kind found is kept).
+// Returns 0 or -1 (errno set to ENOMEM, with the values unchanged) if there is no memory.
+static inline int valvecsort(valvec_t vec) {
+  if (valveckind(vec) == VALCMP_ANY && vec->len > VALSORT_SMALL && (vec->kinds & (vec->kinds - 1)))
+    valvecrescan(vec);
+  return valsort_kind(vec->v, vec->len, valveckind(vec));
+}
+
+#endif // VALVEC_VERSION
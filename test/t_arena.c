@@ -0,0 +1,103 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "valbuf.h"
+#include "valarena.h"
+
+#define NTHREADS 4
+
+static void *use_local(void *arg) {
+  int *ok = arg;
+  valarena_t a = valarenalocal();
+  *ok = (a != NULL) && (valarenalocal() == a);
+  for (int r = 0; r < 10; r++) {
+    for (int i = 0; i < 10000; i++) {
+      val_t s = valarenafmt(a, "%d", i);
+      *ok &= (atoi(valtoptr(s)) == i);
+    }
+    valarenareset(a);
+  }
+  valarenalocalfree();
+  return NULL;
+}
+
+tstsuite("Arenas") {
+  tstcase("Allocations") {
+    valarena_t a = valarenanew(1024);
+    tstassert(a != NULL);
+    tstcheck(valarenasize(a) == 0);
+
+    // Aligned and not overlapping
+    char *p[100];
+    int ok = 1;
+    for (int i = 0; i < 100; i++) {
+      p[i] = valarenaalloc(a, 1 + i % 24);
+      ok &= (p[i] != NULL) && ((uintptr_t)p[i] % VALARENA_ALIGN == 0);
+      memset(p[i], i, 1 + i % 24);
+    }
+    for (int i = 0; i < 100; i++)
+      for (int j = 0; j < 1 + i % 24; j++) ok &= (p[i][j] == (char)i);
+    tstcheck(ok);
+    size_t size = valarenasize(a);
+    tstcheck(size >= 1024 + 2048, "size: %zu", size);
+
+    // Large blocks are released on reset, chunks are kept
+    tstcheck(valarenaalloc(a, 4096) != NULL);
+    tstcheck(valarenasize(a) == size + 4096);
+    valarenareset(a);
+    tstcheck(valarenasize(a) == size);
+    tstcheck(valarenaalloc(a, 8) == (void *)p[0]);
+
+    // Reused without allocating
+    for (int i = 0; i < 100; i++) ok &= (valarenaalloc(a, 1 + i % 24) != NULL);
+    tstcheck(ok && valarenasize(a) == size);
+
+    a = valarenafree(a);
+    tstcheck(a == NULL);
+  }
+
+  tstcase("Strings and buffers") {
+    valarena_t a = valarenanew(0);
+
+    val_t s = valarenastr(a, "Hello");
+    tstcheck(valischarptr(s) && strcmp(valtoptr(s), "Hello") == 0);
+    tstcheck(valeq(valarenastrn(a, "Hello, world", 5), s) == 0 && valcmp(valarenastrn(a, "Hello, world", 5), s) == 0);
+    tstcheck(strcmp(valtoptr(valarenastr(a, NULL)), "") == 0);
+
+    val_t f = valarenafmt(a, "%s-%d", "x", 42);
+    tstcheck(strcmp(valtoptr(f), "x-42") == 0);
+
+    // Longer than the buffer used for the first attempt
+    char big[1000];
+    memset(big, 'z', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    f = valarenafmt(a, "[%s]", big);
+    tstcheck(strlen(valtoptr(f)) == 1001 && ((char *)valtoptr(f))[1000] == ']');
+
+    val_t b = valarenabuf(a, "a\0b", 3);
+    tstcheck(valisbufptr(b));
+    valbuf_t vb = valtoptr(b);
+    tstcheck(vb->len == 3 && vb->cap == 0 && memcmp(vb->buf, "a\0b", 4) == 0);
+    tstcheck(valcmp(b, valarenabuf(a, "a\0b", 3)) == 0);
+    tstcheck(valcmp(b, valarenabuf(a, "a\0c", 3)) < 0);
+    tstcheck(valhash(b) == valhash(valarenabuf(a, "a\0b", 3)));
+
+    valarenafree(a);
+  }
+
+  tstcase("Thread arenas") {
+    pthread_t th[NTHREADS];
+    int ok[NTHREADS];
+    for (int t = 0; t < NTHREADS; t++) tstassert(pthread_create(&th[t], NULL, use_local, &ok[t]) == 0);
+    int all = 1;
+    for (int t = 0; t < NTHREADS; t++) { pthread_join(th[t], NULL); all &= ok[t]; }
+    tstcheck(all);
+  }
+}
@@ -0,0 +1,174 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "valatomic.h"
+
+#define NTHREADS 8
+#define NOPS     50000
+
+static valatomic_t counter;
+static valatomic_t halves;
+static valatomic_t cell;
+static valatomic_t slot[64];
+static int         owner[64];
+
+typedef struct { int id; int ok; uint64_t got; } job_t;
+
+static void *count(void *arg) {
+  job_t *j = arg;
+  j->ok = 1;
+  for (int i = 0; i < NOPS; i++) {
+    j->ok &= valisnumber(valatomicfetchadd(&counter, 1));
+    valatomicfetchadd(&halves, 0.5);
+  }
+  return NULL;
+}
+
+// Each thread puts its own values in the cell and sums what it takes out
+static void *swap(void *arg) {
+  job_t *j = arg;
+  j->got = 0;
+  for (int i = 1; i <= NOPS; i++) j->got += valtoint(valatomicexchange(&cell, j->id * NOPS + i));
+  return NULL;
+}
+
+// Threads race to mark the pointers: only one succeeds for each of them
+static void *mark(void *arg) {
+  job_t *j = arg;
+  j->ok = 1;
+  for (int r = 0; r < 100; r++) {
+    for (int i = 0; i < 64; i++) {
+      val_t p = valatomicload(&slot[i]);
+      int prev = valatomicmark(&slot[i], 1);
+      j->ok &= (prev >= 0);
+      if (prev == 0) owner[i]++;
+      j->ok &= (valtoptr(valatomicload(&slot[i])) == valtoptr(p));
+    }
+  }
+  return NULL;
+}
+
+static int run(void *(*f)(void *), job_t *job) {
+  pthread_t th[NTHREADS];
+  for (int t = 0; t < NTHREADS; t++) {
+    job[t].id = t;
+    if (pthread_create(&th[t], NULL, f, &job[t]) != 0) return 0;
+  }
+  for (int t = 0; t < NTHREADS; t++) pthread_join(th[t], NULL);
+  return 1;
+}
+
+tstsuite("Atomic values") {
+  tstcase("Load, store, exchange") {
+    valatomic_t a = VALATOMIC_INIT(valnil);
+    tstcheck(valisnil(valatomicload(&a)));
+    valatomicstore(&a, 42);
+    tstcheck(valeq(valatomicload(&a), val(42)));
+    valatomicstore(&a, "x", memory_order_relaxed);
+    tstcheck(strcmp(valtoptr(valatomicload(&a, memory_order_relaxed)), "x") == 0);
+    tstcheck(valischarptr(valatomicexchange(&a, valtrue)));
+    tstcheck(valeq(valatomicload(&a), valtrue));
+
+    valatomicinit(&a, 1.5);
+    tstcheck(valeq(valatomicload(&a), val(1.5)));
+    tstcheck(valatomiclockfree(&a));
+  }
+
+  tstcase("Compare and swap") {
+    valatomic_t a = VALATOMIC_INIT(val(1));
+    val_t e = val(2);
+    tstcheck(!valatomiccas(&a, &e, 3) && valeq(e, val(1)));
+    tstcheck(valatomiccas(&a, &e, 3) && valeq(valatomicload(&a), val(3)));
+
+    // Values are compared on their bits
+    e = val(3.0);
+    tstcheck(valatomiccas(&a, &e, 4) == valeq(val(3), val(3.0)));
+
+    e = valatomicload(&a);
+    while (!valatomiccasweak(&a, &e, valfalse)) ;
+    tstcheck(valeq(valatomicload(&a), valfalse));
+  }
+
+  tstcase("Fetch and add") {
+    valatomic_t a = VALATOMIC_INIT(val(10));
+    tstcheck(valeq(valatomicfetchadd(&a, 5), val(10)));
+    tstcheck(valtoint(valatomicload(&a)) == 15);
+    tstcheck(valisint(valatomicload(&a)));
+    tstcheck(valtodouble(valatomicfetchadd(&a, -0.25)) == 15.0);
+    tstcheck(valtodouble(valatomicload(&a)) == 14.75);
+
+    // Past 32 bits (native integers become doubles)
+    valatomicstore(&a, INT32_MAX);
+    valatomicfetchadd(&a, 1);
+    tstcheck(valtoint(valatomicload(&a)) == (int64_t)INT32_MAX + 1);
+
+    // Not a number
+    valatomicstore(&a, "x");
+    errno = 0;
+    tstcheck(valischarptr(valatomicfetchadd(&a, 1)) && errno == EINVAL);
+    tstcheck(valischarptr(valatomicload(&a)));
+  }
+
+  tstcase("Pointer tags") {
+    void *mem = malloc(64);
+    val_t p = val((valptr_0_t)mem);
+    valatomic_t a = VALATOMIC_INIT(p);
+
+    tstcheck(valatomicmark(&a, 1) == 0 && valtagptr(valatomicload(&a)) == 1);
+    tstcheck(valatomicmark(&a, 4) == 1 && valtagptr(valatomicload(&a)) == 5);
+    tstcheck(valatomicunmark(&a, 1) == 5 && valtagptr(valatomicload(&a)) == 4);
+    tstcheck(valtoptr(valatomicload(&a)) == mem);
+
+    tstcheck(!valatomiccastag(&a, p, 0, 2));
+    tstcheck(valatomiccastag(&a, p, 4, 2) && valtagptr(valatomicload(&a)) == 2);
+    tstcheck(valatomiccastag(&a, valtagptr(p, 7), 2, 0) && valeq(valatomicload(&a), p));
+
+    // Another pointer
+    val_t q = val((valptr_0_t)((char *)mem + 8));
+    tstcheck(!valatomiccastag(&a, q, 0, 1));
+
+    // Not taggable
+    valatomicstore(&a, "x");
+    errno = 0;
+    tstcheck(valatomicmark(&a, 1) < 0 && errno == EINVAL);
+    tstcheck(!valatomiccastag(&a, valatomicload(&a), 0, 1));
+    free(mem);
+  }
+
+  tstcase("Threads") {
+    job_t job[NTHREADS];
+
+    valatomicinit(&counter, 0);
+    valatomicinit(&halves, 0);
+    tstassert(run(count, job));
+    int ok = 1;
+    for (int t = 0; t < NTHREADS; t++) ok &= job[t].ok;
+    tstcheck(ok);
+    tstcheck(valtoint(valatomicload(&counter)) == NTHREADS * NOPS, "counter: %" PRId64, valtoint(valatomicload(&counter)));
+    tstcheck(valtodouble(valatomicload(&halves)) == NTHREADS * NOPS * 0.5);
+
+    // Every value is taken exactly once
+    valatomicinit(&cell, 0);
+    tstassert(run(swap, job));
+    uint64_t sum = valtoint(valatomicload(&cell));
+    for (int t = 0; t < NTHREADS; t++) sum += job[t].got;
+    uint64_t n = (uint64_t)NTHREADS * NOPS;
+    tstcheck(sum == n * (n + 1) / 2, "sum: %" PRIu64, sum);
+
+    void *mem = malloc(64 * 8);
+    for (int i = 0; i < 64; i++) { valatomicinit(&slot[i], (valptr_0_t)((char *)mem + 8 * i)); owner[i] = 0; }
+    tstassert(run(mark, job));
+    for (int t = 0; t < NTHREADS; t++) ok &= job[t].ok;
+    for (int i = 0; i < 64; i++) ok &= (owner[i] == 1) && valtagptr(valatomicload(&slot[i])) == 1;
+    tstcheck(ok);
+    free(mem);
+  }
+}
@@ -0,0 +1,213 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <inttypes.h>
+
+typedef struct valptr_buf_s { char *buf; int len; } *buf_t;
+
+#include "valbatch.h"
+
+#define N 1000
+
+static uint64_t rnd_state = 0x123456789ABCDEF1;
+static uint64_t rnd(void) {
+  rnd_state ^= rnd_state >> 12;
+  rnd_state ^= rnd_state << 25;
+  rnd_state ^= rnd_state >> 27;
+  return rnd_state * (uint64_t)0x2545F4914F6CDD1D;
+}
+
+// Values of all the types, including those with unusual bit patterns
+static struct valptr_buf_s buf = {"buffer", 6};
+static struct valptr_buf_s nullbuf = {NULL, 0};
+
+static void fill(val_t *v, size_t n) {
+  static char *str = "hello";
+  for (size_t i = 0; i < n; i++) {
+    uint64_t r = rnd();
+    switch (r % 15) {
+      case 12: v[i] = val(&buf); break;
+      case 13: v[i] = (r & 0x100) ? val(&nullbuf) : val((char *)NULL); break;
+      case 14: v[i] = val(str + (r % 5)); break;
+      case 0:  v[i] = val((int)(r >> 40)); break;
+      case 1:  v[i] = val((double)(r >> 11) / 3.0); break;
+      case 2:  v[i] = val(str); break;
+      case 3:  v[i] = valconst("sym"); break;
+      case 4:  v[i] = (r & 0x100) ? valtrue : valfalse; break;
+      case 5:  v[i] = valnil; break;
+      case 6:  v[i] = valconst((uint32_t)(r >> 32)); break;
+      case 7:  v[i] = val(stderr); break;
+      case 8:  v[i].v = (r & ~VAL_PAYLOAD_MASK) | 0x7FF8000000000000 | (r >> 16); break; // Any NaN
+      case 9:  v[i].v = r; break;                                                        // Any bit pattern
+      case 10: v[i] = val(NAN); break;
+      default: v[i] = val(-INFINITY); break;
+    }
+    // Random char * or buffers would be dereferenced: make them void * or FILE *
+    if ((v[i].v & 0xFFFE000000000000) == VALPTR_CHAR && (r % 15) >= 8 && (r % 15) <= 9)
+      v[i].v &= ~((uint64_t)1 << 63);
+  }
+}
+
+// The original (branchy) val_isint(), used as reference for the branch-free one
+static int ref_isint(val_t v) {
+  int      exp_bits  = (int)((v.v >> 52) & 0x7FF);
+  uint64_t frac_bits = v.v & ((((uint64_t)1) << 52) - 1);
+  if (exp_bits == 0)     return (frac_bits == 0);
+  if (exp_bits == 0x7FF) return 0;
+  int e = exp_bits - 1023;
+  if (e < 0)   return 0;
+  if (e >= 52) return 1;
+  return ((frac_bits & ((((uint64_t)1) << (52 - e)) - 1)) == 0);
+}
+
+tstsuite("Batch operations") {
+  val_t    v[N];
+  uint8_t  types[N];
+  uint64_t bits[(N+63)/64];
+
+  fill(v, N);
+
+  tstcase("Classification matches the single value checks") {
+    int ok = 1;
+    for (size_t n = 0; n < 80 && ok; n++) {
+      memset(types, 0xAA, sizeof(types));
+      valclassify_n(v + 3, n, types);
+      for (size_t i = 0; i < n; i++) ok &= (types[i] == valclassify(v[i+3]));
+      ok &= (types[n] == 0xAA);
+    }
+    tstcheck(ok, "Wrong classification of a short array");
+
+    valclassify_n(v, N, types);
+    ok = 1;
+    for (size_t i = 0; i < N; i++) {
+      ok &= ((types[i] == VALCLASS_NUMBER) == !!val_isnumber(v[i]));
+      ok &= ((types[i] >= VALCLASS_VOIDPTR) == !!val_is_any_ptr(v[i]));
+      ok &= ((types[i] == VALCLASS_CONST) == !!val_is_any_const(v[i]));
+      if (types[i] >= VALCLASS_VOIDPTR)
+        ok &= (valptrtype(v[i]) == ((types[i] & 1) ? 0x7FFA000000000000 : 0xFFFA000000000000)
+                                   + ((uint64_t)((types[i] - VALCLASS_VOIDPTR) / 2) << 48));
+    }
+    tstcheck(ok, "Classification differs from the single value checks");
+
+    tstcheck(valclassify(3.2)     == VALCLASS_NUMBER);
+    tstcheck(valclassify(NAN)     == VALCLASS_NUMBER);
+    tstcheck(valclassify("x")     == VALCLASS_CHARPTR);
+    tstcheck(valclassify(valnil)  == VALCLASS_CONST);
+    tstcheck(valclassify(stdout)  == VALCLASS_FILEPTR);
+    tstcheck(valclassify(valnullptr) == VALCLASS_VOIDPTR);
+  }
+
+  tstcase("Bitmasks match the single value checks") {
+    int ok;
+    size_t cnt, exp;
+
+    for (size_t n = 0; n < 200; n += 13) {
+      memset(bits, 0xFF, sizeof(bits));
+      cnt = valmask_number_n(v, n, bits);
+      ok = 1; exp = 0;
+      for (size_t i = 0; i < n; i++) { ok &= (valmaskbit(bits, i) == (uint64_t)!!val_isnumber(v[i])); exp += !!val_isnumber(v[i]); }
+      if (n % 64) ok &= ((bits[n/64] >> (n%64)) == 0);
+      tstcheck(ok && cnt == exp, "Numbers mask (n=%zu)", n);
+    }
+
+    cnt = valmask_ptr_n(v, N, bits);
+    ok = 1; exp = 0;
+    for (size_t i = 0; i < N; i++) { ok &= (valmaskbit(bits, i) == (uint64_t)!!val_is_any_ptr(v[i])); exp += !!val_is_any_ptr(v[i]); }
+    tstcheck(ok && cnt == exp, "Pointers mask");
+
+    cnt = valmask_sym_n(v, N, bits);
+    ok = 1; exp = 0;
+    for (size_t i = 0; i < N; i++) { ok &= (valmaskbit(bits, i) == (uint64_t)!!val_issymconst_1(v[i])); exp += !!val_issymconst_1(v[i]); }
+    tstcheck(ok && cnt == exp, "Symbols mask");
+
+    cnt = valmask_bool_n(v, N, bits);
+    ok = 1; exp = 0;
+    for (size_t i = 0; i < N; i++) { ok &= (valmaskbit(bits, i) == (uint64_t)!!valisbool(v[i])); exp += !!valisbool(v[i]); }
+    tstcheck(ok && cnt == exp, "Booleans mask");
+
+    cnt = valmask_const_n(v, N, bits);
+    ok = 1; exp = 0;
+    for (size_t i = 0; i < N; i++) { ok &= (valmaskbit(bits, i) == (uint64_t)!!val_is_any_const(v[i])); exp += !!val_is_any_const(v[i]); }
+    tstcheck(ok && cnt == exp, "Constants mask");
+
+    cnt = valmask_charptr_n(v, N, bits);
+    ok = 1; exp = 0;
+    for (size_t i = 0; i < N; i++) { ok &= (valmaskbit(bits, i) == (uint64_t)!!valischarptr(v[i])); exp += !!valischarptr(v[i]); }
+    tstcheck(ok && cnt == exp, "char * mask");
+
+    cnt = valmask_nil_n(v, N, bits);
+    ok = 1; exp = 0;
+    for (size_t i = 0; i < N; i++) { ok &= (valmaskbit(bits, i) == (uint64_t)!!valisnil(v[i])); exp += !!valisnil(v[i]); }
+    tstcheck(ok && cnt == exp, "nil mask");
+  }
+
+  tstcase("Integer checks") {
+    static const uint64_t special[] = {
+      0x0000000000000000, 0x8000000000000000,  // ±0
+      0x0000000000000001, 0x800FFFFFFFFFFFFF,  // Subnormals
+      0x0010000000000000, 0x7FEFFFFFFFFFFFFF,  // Smallest and largest normals
+      0x7FF0000000000000, 0xFFF0000000000000,  // ±inf
+      0x7FF8000000000000, 0xFFF8000000000000,  // NaNs
+      0x3FE0000000000000, 0x3FF0000000000000,  // 0.5, 1.0
+      0x3FF8000000000000, 0xBFF0000000000000,  // 1.5, -1.0
+      0x432FFFFFFFFFFFFF, 0x4330000000000000,  // 2^52 - 0.5, 2^52
+      0x4330000000000001, 0x433FFFFFFFFFFFFF,  // 2^52 + 1, 2^53 - 1
+      0x4340000000000000, 0xC340000000000001,  // 2^53, -(2^53 + 2)
+      0x4320000000000001, 0x4320000000000002,  // 2^51 + 0.5, 2^51 + 1
+    };
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(special)/sizeof(special[0]); i++) {
+      val_t x = {.v = special[i]};
+      tstcheck(val_isint(x) == ref_isint(x), "Wrong integer check for %016" PRIX64, special[i]);
+    }
+
+    for (int k = 0; k < 100000; k++) {
+      val_t x = {.v = rnd()};
+      if (k & 1) x.v = (x.v & 0x800FFFFFFFFFFFFF) | ((uint64_t)(1000 + (k >> 1) % 100) << 52); // Near 2^52
+      ok &= (val_isint(x) == ref_isint(x));
+    }
+    tstcheck(ok, "Different from the reference implementation");
+
+    tstcheck(valisint(3.0) && valisint(-0.0) && !valisint(3.5) && !valisint(INFINITY) && !valisint(NAN));
+
+    val_t w[200];
+    for (size_t i = 0; i < 200; i++) w[i] = (i % 3) ? val((double)(int)(rnd() >> 44)) : val((double)(rnd() >> 11) / 7.0);
+    memcpy(w, v, 100 * sizeof(val_t));
+
+    for (size_t n = 0; n < 200; n += 7) {
+      size_t cnt, exp = 0;
+      memset(bits, 0xFF, sizeof(bits));
+      cnt = valisint_n(w, n, bits);
+      ok = 1;
+      for (size_t i = 0; i < n; i++) { ok &= (valmaskbit(bits, i) == (uint64_t)val_isint(w[i])); exp += val_isint(w[i]); }
+      if (n % 64) ok &= ((bits[n/64] >> (n%64)) == 0);
+      tstcheck(ok && cnt == exp, "Integers mask (n=%zu)", n);
+    }
+  }
+
+  tstcase("Batch hashing matches val_hash()") {
+    uint32_t hashes[N+1];
+    int ok = 1;
+
+    for (size_t n = 0; n < 150 && ok; n++) {
+      hashes[n] = 0xDEADBEEF;
+      valhash_n(v + 1, n, hashes);
+      for (size_t i = 0; i < n; i++) ok &= (hashes[i] == valhash(v[i+1]));
+      ok &= (hashes[n] == 0xDEADBEEF);
+    }
+    tstcheck(ok, "Wrong hash for short arrays");
+
+    valhash_n(v, N, hashes);
+    ok = 1;
+    for (size_t i = 0; i < N; i++) ok &= (hashes[i] == valhash(v[i]));
+    tstcheck(ok, "Different hash");
+
+    tstcheck(valhash(&buf) == valhash("buffer"));
+  }
+}
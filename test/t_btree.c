@@ -0,0 +1,266 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "valsort.h"
+#include "valbtree.h"
+
+#define N 20000
+
+static char heap[N][16];
+static char keep[4 * N][16];  // The strings that are keys in the tree
+
+// Keys: integers, doubles, constants and strings (many with the same first bytes)
+static val_t random_key(int i) {
+  char *s = heap[i];
+  int len = rand() % 10;
+  for (int k = 0; k < len; k++) s[k] = (k < 6 && rand() % 8) ? 'a' : 'a' + rand() % 3;
+  s[len] = '\0';
+
+  switch (rand() % 4) {
+    case 0:  return val(rand() % 5000);
+    case 1:  return val((double)(rand() % 5000) / 4);
+    case 2:  return valnumconst(rand() % 100);
+    default: return val(s);
+  }
+}
+
+// Checks the structure of the subtree: sorted keys, node sizes, separators and depth.
+// Returns the depth of the leaves (-1 if there's something wrong).
+static int check_node(valbtree_node_t *nd, int root, valbtree_node_t **leaf) {
+  for (int i = 1; i < nd->count; i++)
+    if (valbtree_cmp(nd->skey[i - 1], nd->key[i - 1], nd->skey[i], nd->key[i]) >= 0) return -1;
+  for (int i = 0; i < nd->count; i++) if (nd->skey[i] != valsortkey(nd->key[i])) return -1;
+  if (nd->count > VALBTREE_MAX || (!root && nd->count < valbtree_min(nd))) return -1;
+
+  if (nd->leaf) {
+    // Leaves are linked in order
+    if (nd->prev != *leaf) return -1;
+    *leaf = nd;
+    return 1;
+  }
+
+  int depth = -1;
+  for (int i = 0; i <= nd->count; i++) {
+    valbtree_node_t *c = nd->child[i];
+    // Keys of the child are between the separators (leaves hold all the keys)
+    if (i > 0 && c->leaf && valbtree_cmp(c->skey[0], c->key[0], nd->skey[i - 1], nd->key[i - 1]) < 0) return -1;
+    if (i < nd->count && c->count && valbtree_cmp(c->skey[c->count - 1], c->key[c->count - 1], nd->skey[i], nd->key[i]) >= 0) return -1;
+    int d = check_node(c, 0, leaf);
+    if (d < 0 || (depth >= 0 && d != depth)) return -1;
+    depth = d;
+  }
+  return depth + 1;
+}
+
+static int check_tree(valbtree_t t) {
+  valbtree_node_t *leaf = NULL;
+  int d = check_node(t->root, 1, &leaf);
+  return d == t->height && leaf->next == NULL;
+}
+
+// Reference: sorted array of keys (unique as for the tree) with their values
+static val_t ref_k[N], ref_v[N];
+static size_t ref_n;
+
+static size_t ref_find(val_t k) {
+  uint64_t sk = valsortkey(k);
+  size_t lo = 0, hi = ref_n;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (valbtree_cmp(valsortkey(ref_k[mid]), ref_k[mid], sk, k) < 0) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+static int ref_has(size_t i, val_t k) {
+  return i < ref_n && valbtree_cmp(valsortkey(ref_k[i]), ref_k[i], valsortkey(k), k) == 0;
+}
+
+tstsuite("B+trees") {
+  srand(18);
+
+  tstcase("Set, get and delete") {
+    valbtree_t t = valbtreenew();
+    tstassert(t != NULL);
+
+    tstcheck(valbtreecount(t) == 0);
+    tstcheck(valisnil(valbtreeget(t, 1)));
+    tstcheck(valbtreeget(t, 1, 99).v == val(99).v);
+    tstcheck(!valbtreedel(t, 1));
+
+    tstcheck(valbtreeset(t, 1, "one") == 0);
+    tstcheck(valbtreeset(t, valtrue, 2.5) == 0);
+    tstcheck(valbtreeset(t, "abc", valnil) == 0);
+    tstcheck(valbtreecount(t) == 3);
+    tstcheck(valbtreehas(t, "abc") && valbtreehas(t, valshortstr("abc")));
+    tstcheck(valeq(valbtreeget(t, valtrue), val(2.5)));
+
+    // Keys equal for valcmp() are the same key
+    tstcheck(valbtreeset(t, 1.0, "uno") == 0);
+    tstcheck(valbtreecount(t) == 3);
+    tstcheck(strcmp(valtoptr(valbtreeget(t, 1)), "uno") == 0);
+    tstcheck(valbtreeset(t, 0.0, 0) == 0 && valbtreehas(t, -0.0));
+
+    // NaN is a key (after +inf)
+    tstcheck(valbtreeset(t, NAN, 1) == 0 && valbtreehas(t, NAN) && !valbtreehas(t, INFINITY));
+
+    tstcheck(valbtreedel(t, "abc") && !valbtreehas(t, "abc"));
+    tstcheck(valbtreecount(t) == 4);
+    t = valbtreefree(t);
+    tstcheck(t == NULL);
+  }
+
+  tstcase("Keys released after their deletion") {
+    valbtree_t t = valbtreenew();
+    char *k[200];
+    for (int i = 0; i < 200; i++) {
+      k[i] = malloc(24);
+      snprintf(k[i], 24, "a long key %03d", i);
+      tstassert(valbtreeset(t, k[i], i) == 0);
+    }
+
+    // A removed key is no longer used: it can be changed and freed
+    int ok = 1;
+    for (int step = 16; step >= 1; step /= 2) {
+      for (int i = 0; i < 200; i += step) {
+        if (k[i] == NULL) continue;
+        ok &= valbtreedel(t, k[i]);
+        memset(k[i], 'z', 23);
+        free(k[i]);
+        k[i] = NULL;
+        for (int j = 0; j < 200; j++) if (k[j]) ok &= (valtoint(valbtreeget(t, k[j])) == j);
+      }
+    }
+    tstcheck(ok && valbtreecount(t) == 0);
+    valbtreefree(t);
+  }
+
+  tstcase("Same keys of a sorted array") {
+    valbtree_t t = valbtreenew();
+    ref_n = 0;
+
+    int ok = 1;
+    for (int op = 0; op < 4 * N; op++) {
+      val_t k = random_key(op % N);
+      size_t i = ref_find(k);
+      if (rand() % 3 && ref_n < N) {
+        // New string keys get their own copy (heap[] is reused)
+        if (valischarptr(k) && !ref_has(i, k)) k = val(strcpy(keep[op], valtoptr(k)));
+        val_t v = val(op);
+        ok &= (valbtree_set(t, k, v) == 0);
+        if (ref_has(i, k)) ref_v[i] = v;
+        else {
+          memmove(&ref_k[i + 1], &ref_k[i], (ref_n - i) * sizeof(val_t));
+          memmove(&ref_v[i + 1], &ref_v[i], (ref_n - i) * sizeof(val_t));
+          ref_k[i] = k; ref_v[i] = v; ref_n++;
+        }
+      }
+      else {
+        int had = ref_has(i, k);
+        ok &= (valbtree_del(t, k) == had);
+        if (had) {
+          memmove(&ref_k[i], &ref_k[i + 1], (ref_n - i - 1) * sizeof(val_t));
+          memmove(&ref_v[i], &ref_v[i + 1], (ref_n - i - 1) * sizeof(val_t));
+          ref_n--;
+        }
+      }
+      ok &= (valbtreecount(t) == ref_n);
+      if (op % 1000 == 0) ok &= check_tree(t);
+      if (!ok) { tstnote("op: %d", op); break; }
+    }
+    tstcheck(ok);
+    tstcheck(check_tree(t));
+    tstcheck(t->height > 2, "height: %d", t->height);
+
+    // Forward and backward
+    val_t k, v;
+    size_t i = 0;
+    ok = 1;
+    for (valbtree_iter_t it = valbtreefirst(t); valbtreenext(&it, &k, &v); i++)
+      ok &= (i < ref_n) && valeq(k, ref_k[i]) && valeq(v, ref_v[i]);
+    tstcheck(ok && i == ref_n);
+
+    ok = 1;
+    for (valbtree_iter_t it = valbtreelast(t); valbtreeprev(&it, &k, &v); )
+      ok &= (i > 0) && valeq(k, ref_k[--i]) && valeq(v, ref_v[i]);
+    tstcheck(ok && i == 0);
+
+    // Range scans
+    ok = 1;
+    for (int r = 0; r < 200; r++) {
+      val_t lo = random_key(0), hi = random_key(1);
+      if (valcmp(lo, hi) > 0) { val_t tmp = lo; lo = hi; hi = tmp; }
+      size_t a = ref_find(lo);
+      valbtree_iter_t it = valbtreeseek(t, lo);
+      while (valbtreenext(&it, &k, NULL) && valcmp(k, hi) < 0) ok &= (a < ref_n) && valeq(k, ref_k[a++]);
+
+      // And back from the same position
+      it = valbtreeseek(t, lo);
+      size_t b = ref_find(lo);
+      if (valbtreeprev(&it, &k, NULL)) ok &= (b > 0) && valeq(k, ref_k[b - 1]);
+      else ok &= (b == 0);
+    }
+    tstcheck(ok);
+
+    // Delete everything
+    ok = 1;
+    while (ref_n > 0) {
+      size_t j = (size_t)rand() % ref_n;
+      ok &= valbtree_del(t, ref_k[j]);
+      memmove(&ref_k[j], &ref_k[j + 1], (ref_n - j - 1) * sizeof(val_t));
+      ref_n--;
+    }
+    tstcheck(ok && valbtreecount(t) == 0 && t->height == 1 && check_tree(t));
+    tstcheck(!valbtreenext(&(valbtree_iter_t){t->root, 0}, &k, &v));
+
+    valbtreefree(t);
+  }
+
+  tstcase("Bulk load") {
+    static val_t keys[N], vals[N];
+    for (int n = 0; n <= N; n = n ? n * 3 : 1) {
+      for (int i = 0; i < n; i++) keys[i] = val(i / 2), vals[i] = val(i);  // Pairs of equal keys
+      valbtree_t t = valbtreenew();
+      tstcheck(valbtreeload(t, keys, vals, (size_t)n) == 0);
+      tstcheck(valbtreecount(t) == (size_t)(n + 1) / 2 && check_tree(t), "n: %d", n);
+
+      int ok = 1;
+      for (int i = 0; i < n; i += 2) ok &= valeq(valbtreeget(t, i / 2), val((i + 1 < n) ? i + 1 : i));
+      tstcheck(ok);
+
+      // Still a valid tree after more keys are added and removed
+      for (int i = 0; i < n; i++) ok &= (valbtreeset(t, n + i, i) == 0);
+      for (int i = 0; i < n; i += 3) ok &= valbtreedel(t, i / 2);
+      tstcheck(ok && check_tree(t));
+      valbtreefree(t);
+    }
+
+    // Mixed keys
+    for (int i = 0; i < N; i++) keys[i] = random_key(i);
+    valsort(keys, N);
+    valbtree_t t = valbtreenew();
+    tstcheck(valbtreeload(t, keys, NULL, N) == 0 && check_tree(t));
+    int ok = 1;
+    for (int i = 0; i < N; i++) ok &= valbtreehas(t, keys[i]);
+    tstcheck(ok);
+
+    // Not empty or not sorted
+    errno = 0;
+    tstcheck(valbtreeload(t, keys, NULL, N) < 0 && errno == EINVAL);
+    valbtreefree(t);
+
+    t = valbtreenew();
+    val_t x[] = {val(2), val(1)};
+    errno = 0;
+    tstcheck(valbtreeload(t, x, NULL, 2) < 0 && errno == EINVAL && valbtreecount(t) == 0);
+    valbtreefree(t);
+  }
+}
@@ -0,0 +1,189 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "valcmap.h"
+
+#define NTHREADS 8
+#define NKEYS    20000
+
+typedef struct {
+  valcmap_t m;
+  int id;
+  int ok;
+} job_t;
+
+// Each thread adds its own keys (and removes one every three)
+static void *add_keys(void *arg) {
+  job_t *j = arg;
+  j->ok = 1;
+  for (int i = 0; i < NKEYS; i++) {
+    int k = j->id * NKEYS + i;
+    j->ok &= (valcmapset(j->m, k, i) == 0);
+    if (i % 3 == 0) j->ok &= valcmapdel(j->m, k);
+  }
+  return NULL;
+}
+
+// All the threads increment the same counters
+static void *add_counts(void *arg) {
+  job_t *j = arg;
+  j->ok = 1;
+  for (int i = 0; i < NKEYS; i++) {
+    val_t k = val(i % 64);
+    val_t e = valcmapget(j->m, k, valcmapnone);
+    int r;
+    while ((r = valcmapcas(j->m, k, &e, (e.v == valcmapnone.v) ? 1 : valtoint(e) + 1)) == 0) ;
+    j->ok &= (r == 1);
+  }
+  return NULL;
+}
+
+// Readers look up the keys that are always there while writers resize the map
+static valcmap_t shared;
+static void *read_keys(void *arg) {
+  job_t *j = arg;
+  j->ok = 1;
+  for (int r = 0; r < 20; r++)
+    for (int i = 0; i < 1000; i++) j->ok &= (valtoint(valcmapget(shared, -i - 1, -1)) == i);
+  return NULL;
+}
+
+static int run(void *(*f)(void *), valcmap_t m, int nthreads) {
+  pthread_t th[NTHREADS];
+  job_t job[NTHREADS];
+  for (int t = 0; t < nthreads; t++) {
+    job[t] = (job_t){m, t, 0};
+    if (pthread_create(&th[t], NULL, f, &job[t]) != 0) return 0;
+  }
+  int ok = 1;
+  for (int t = 0; t < nthreads; t++) { pthread_join(th[t], NULL); ok &= job[t].ok; }
+  return ok;
+}
+
+tstsuite("Concurrent maps") {
+  tstcase("Set, get and delete") {
+    valcmap_t m = valcmapnew(VALMAP_IDENTITY);
+    tstassert(m != NULL);
+
+    tstcheck(valcmapcount(m) == 0);
+    tstcheck(valisnil(valcmapget(m, 1)));
+    tstcheck(valcmapget(m, 1, 99).v == val(99).v);
+    tstcheck(!valcmaphas(m, 1) && !valcmapdel(m, 1));
+
+    tstcheck(valcmapset(m, 1, "one") == 0);
+    tstcheck(valcmapset(m, valtrue, 2.5) == 0);
+    tstcheck(valcmapset(m, valnil, valnil) == 0);
+    tstcheck(valcmapcount(m) == 3);
+    tstcheck(valcmaphas(m, valnil) && valisnil(valcmapget(m, valnil, 0)));
+    tstcheck(valeq(valcmapget(m, valtrue), val(2.5)));
+
+    tstcheck(valcmapset(m, 1, "uno") == 0 && valcmapcount(m) == 3);
+    tstcheck(strcmp(valtoptr(valcmapget(m, 1)), "uno") == 0);
+
+    tstcheck(valcmapdel(m, valtrue) && !valcmaphas(m, valtrue) && valcmapcount(m) == 2);
+    tstcheck(valcmapset(m, valtrue, 3) == 0 && valcmapcount(m) == 3);
+
+    // Sentinels are not keys or values
+    errno = 0;
+    tstcheck(valcmapset(m, valcmapnone, 1) < 0 && errno == EINVAL);
+    errno = 0;
+    tstcheck(valcmapset(m, 1, valcmapnone) < 0 && errno == EINVAL);
+    m = valcmapfree(m);
+    tstcheck(m == NULL);
+  }
+
+  tstcase("Compare and swap") {
+    valcmap_t m = valcmapnew(VALMAP_SEMANTIC);
+    val_t e = valcmapnone;
+    tstcheck(valcmapcas(m, "a", &e, 1) == 1 && valcmapcount(m) == 1);
+
+    // Already there
+    e = valcmapnone;
+    tstcheck(valcmapcas(m, "a", &e, 2) == 0 && valeq(e, val(1)));
+    tstcheck(valcmapcas(m, valshortstr("a"), &e, 2) == 1);
+    tstcheck(valeq(valcmapget(m, "a"), val(2)));
+
+    // Not there
+    e = val(2);
+    tstcheck(valcmapcas(m, "b", &e, 3) == 0 && e.v == valcmapnone.v && !valcmaphas(m, "b"));
+
+    // Remove
+    e = val(1);
+    tstcheck(valcmapcas(m, "a", &e, valcmapnone) == 0 && valeq(e, val(2)));
+    tstcheck(valcmapcas(m, "a", &e, valcmapnone) == 1 && !valcmaphas(m, "a") && valcmapcount(m) == 0);
+
+    // Semantic mode: numbers on their value
+    tstcheck(valcmapset(m, 1, "x") == 0 && valcmaphas(m, 1.0) && valcmapcount(m) == 1);
+    valcmapfree(m);
+  }
+
+  tstcase("Resize and iterate") {
+    valcmap_t m = valcmapnew(VALMAP_IDENTITY);
+    int ok = 1;
+    for (int i = 0; i < NKEYS; i++) ok &= (valcmapset(m, i, -i) == 0);
+    for (int i = 0; i < NKEYS; i += 2) ok &= valcmapdel(m, i);
+    tstcheck(ok && valcmapcount(m) == NKEYS / 2);
+
+    for (int i = 0; i < NKEYS; i++) ok &= (valcmaphas(m, i) == (i % 2));
+    tstcheck(ok);
+
+    // Removed keys leave their slots: adding and removing doesn't grow the table forever
+    for (int r = 0; r < 20; r++)
+      for (int i = 0; i < NKEYS; i += 2) ok &= (valcmapset(m, NKEYS * (r + 1) + i, 0) == 0) && valcmapdel(m, NKEYS * (r + 1) + i);
+    tstcheck(ok && valcmapcount(m) == NKEYS / 2);
+    tstcheck(atomic_load(&m->tbl)->cap <= 4 * NKEYS, "cap: %zu", atomic_load(&m->tbl)->cap);
+
+    size_t n = 0;
+    val_t k, v;
+    for (size_t i = 0; (i = valcmapnext(m, i, &k, &v)); n++)
+      ok &= valisint(k) && (valtoint(k) % 2) && valtoint(v) == -valtoint(k);
+    tstcheck(ok && n == NKEYS / 2, "n: %zu", n);
+    valcmapfree(m);
+  }
+
+  tstcase("Threads adding keys") {
+    valcmap_t m = valcmapnew(VALMAP_IDENTITY);
+    tstcheck(run(add_keys, m, NTHREADS));
+    tstcheck(valcmapcount(m) == NTHREADS * (NKEYS - (NKEYS + 2) / 3), "count: %zu", valcmapcount(m));
+
+    int ok = 1;
+    for (int k = 0; k < NTHREADS * NKEYS; k++) {
+      int i = k % NKEYS;
+      if (i % 3 == 0) ok &= !valcmaphas(m, k);
+      else ok &= valtoint(valcmapget(m, k, -1)) == i;
+    }
+    tstcheck(ok);
+    valcmapfree(m);
+  }
+
+  tstcase("Threads updating the same keys") {
+    valcmap_t m = valcmapnew(VALMAP_IDENTITY);
+    tstcheck(run(add_counts, m, NTHREADS));
+    int sum = 0;
+    for (int i = 0; i < 64; i++) sum += valtoint(valcmapget(m, i, 0));
+    tstcheck(sum == NTHREADS * NKEYS, "sum: %d", sum);
+    valcmapfree(m);
+  }
+
+  tstcase("Lookups during resize") {
+    shared = valcmapnew(VALMAP_IDENTITY);
+    for (int i = 0; i < 1000; i++) valcmapset(shared, -i - 1, i);
+
+    pthread_t th;
+    job_t reader = {shared, 0, 0};
+    tstassert(pthread_create(&th, NULL, read_keys, &reader) == 0);
+    tstcheck(run(add_keys, shared, NTHREADS / 2));
+    pthread_join(th, NULL);
+    tstcheck(reader.ok);
+    tstcheck(valcmapcount(shared) == 1000 + NTHREADS / 2 * (NKEYS - (NKEYS + 2) / 3));
+    shared = valcmapfree(shared);
+  }
+}
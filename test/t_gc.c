@@ -0,0 +1,178 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "valgc.h"
+
+// Nodes of a graph. Released nodes are only flagged (and kept in `pool`) so that the
+// test can check that no reachable node has been released.
+typedef struct valptr_2_s { val_t link[2]; int dead; int seen; } *node_t;
+
+#define N 2000
+
+static struct valptr_2_s pool[N];
+static int nfreed;
+
+static void node_trace(valgc_t gc, void *p) {
+  node_t nd = p;
+  valgcmark(gc, nd->link[0]);
+  valgcmark(gc, nd->link[1]);
+}
+
+static void node_free(void *p) {
+  ((node_t)p)->dead++;
+  nfreed++;
+}
+
+static val_t node(int i) {
+  pool[i] = (struct valptr_2_s){{valnil, valnil}, 0, 0};
+  return val(&pool[i]);
+}
+
+// Counts the nodes reachable from `v` (not released twice, not dead)
+static int reach(val_t v, int epoch, int *ok) {
+  if (!valisptr(v, VALPTR_2)) return 0;
+  node_t nd = valtoptr(v);
+  if (nd->seen == epoch) return 0;
+  nd->seen = epoch;
+  *ok &= (nd->dead == 0);
+  return 1 + reach(nd->link[0], epoch, ok) + reach(nd->link[1], epoch, ok);
+}
+
+tstsuite("Garbage collection") {
+  tstcase("Reachable and unreachable") {
+    valgc_t gc = valgcnew();
+    tstassert(gc != NULL);
+    tstcheck(valgctype(gc, VALPTR_2, node_trace, node_free) == 0);
+    nfreed = 0;
+
+    // A list of 10 nodes, a cycle of 2 and a lone node
+    val_t head = valnil, prev = valnil;
+    for (int i = 0; i < 10; i++) {
+      val_t v = valgcadd(gc, node(i));
+      if (valisnil(prev)) head = v;
+      else ((node_t)valtoptr(prev))->link[0] = v;
+      prev = v;
+    }
+    val_t a = valgcadd(gc, node(10)), b = valgcadd(gc, node(11));
+    ((node_t)valtoptr(a))->link[0] = b;
+    ((node_t)valtoptr(b))->link[1] = a;
+    valgcadd(gc, node(12));
+    tstcheck(valgccount(gc) == 13);
+
+    tstcheck(valgcroot(gc, &head) == 0);
+    tstcheck(valgccollect(gc) == 3 && nfreed == 3 && valgccount(gc) == 10);
+    tstcheck(pool[10].dead && pool[11].dead && pool[12].dead);
+
+    // Nothing more to free
+    tstcheck(valgccollect(gc) == 0 && valgccount(gc) == 10);
+
+    // Cut the list in half
+    pool[4].link[0] = valnil;
+    tstcheck(valgccollect(gc) == 5 && valgccount(gc) == 5);
+
+    // Tags of the values in the slots are not marks
+    head = valtagptr(head, 5);
+    pool[1].link[0] = valtagptr(pool[1].link[0], 7);
+    tstcheck(valgccollect(gc) == 0 && valgccount(gc) == 5);
+    tstcheck(valtagptr(head) == 5 && valtagptr(pool[1].link[0]) == 7);
+
+    tstcheck(valgcunroot(gc, &head) && !valgcunroot(gc, &head));
+    tstcheck(valgccollect(gc) == 5 && valgccount(gc) == 0 && nfreed == 13);
+
+    int ok = 1;
+    for (int i = 0; i < 13; i++) ok &= (pool[i].dead == 1);
+    tstcheck(ok);
+    gc = valgcfree(gc);
+    tstcheck(gc == NULL);
+  }
+
+  tstcase("Default release and errors") {
+    valgc_t gc = valgcnew();
+    val_t f = valgcadd(gc, tmpfile());
+    tstcheck(valisfileptr(f));
+    val_t m = valgcadd(gc, (valptr_5_t)malloc(32));
+    tstcheck(valisptr(m, VALPTR_5));
+    tstcheck(valgcroot(gc, &m) == 0);
+    tstcheck(valgccollect(gc) == 1 && valgccount(gc) == 1);  // fclose()
+
+    errno = 0;
+    tstcheck(valisnil(valgcadd(gc, "abc")) && errno == EINVAL);
+    errno = 0;
+    tstcheck(valisnil(valgcadd(gc, 42)) && errno == EINVAL);
+    errno = 0;
+    tstcheck(valgctype(gc, VALPTR_CHAR, NULL, NULL) < 0 && errno == EINVAL);
+    errno = 0;
+    tstcheck(valgctype(gc, VALPTR_3 | 1, NULL, NULL) < 0 && errno == EINVAL);
+
+    // Values that are not managed are ignored
+    val_t other = val((valptr_5_t)&gc);
+    tstcheck(valgcroot(gc, &other) == 0);
+    tstcheck(valgccollect(gc) == 0 && valgccount(gc) == 1);
+    valgcfree(gc);  // Releases `m`
+  }
+
+  tstcase("Incremental collection") {
+    srand(21);
+    valgc_t gc = valgcnew();
+    valgctype(gc, VALPTR_2, node_trace, node_free);
+    nfreed = 0;
+
+    val_t root[4] = {valnil, valnil, valnil, valnil};
+    for (int r = 0; r < 4; r++) valgcroot(gc, &root[r]);
+
+    // Random graph changed between the steps of the collections
+    int next = 0, cycles = 0, epoch = 0, ok = 1;
+    node_t live[N];
+    while (next < N) {
+      int op = rand() % 4;
+      if (op == 0) {
+        // New node linked from a root (and linking the old value of the root)
+        val_t v = valgcadd(gc, node(next++));
+        int r = rand() % 4;
+        ((node_t)valtoptr(v))->link[0] = root[r];
+        root[r] = v;
+      }
+      else if (op == 1 || op == 2) {
+        // Move a link: pick two reachable nodes
+        int n = 0;
+        epoch++;
+        for (int r = 0; r < 4; r++) n += reach(root[r], epoch, &ok);
+        if (n < 2) continue;
+        int k = 0;
+        for (int i = 0; i < next; i++) if (pool[i].seen == epoch && k < N) live[k++] = &pool[i];
+        node_t x = live[rand() % k], y = live[rand() % k];
+        val_t v = (op == 1) ? val(y) : valnil;
+        x->link[rand() % 2] = v;
+        valgcbarrier(gc, v);
+      }
+      else if (valgcstep(gc, 5)) {
+        cycles++;
+        epoch++;
+        for (int r = 0; r < 4; r++) reach(root[r], epoch, &ok);
+        if (!ok) { tstnote("cycle %d", cycles); break; }
+      }
+      if (rand() % 20 == 0) root[rand() % 4] = valnil;
+    }
+    tstcheck(ok);
+    tstcheck(cycles > 10, "cycles: %d", cycles);
+
+    // A full collection leaves only the reachable nodes
+    valgccollect(gc);
+    epoch++;
+    int n = 0;
+    for (int r = 0; r < 4; r++) n += reach(root[r], epoch, &ok);
+    tstcheck(ok && valgccount(gc) == (size_t)n, "reachable: %d, managed: %zu", n, valgccount(gc));
+    tstcheck(nfreed + n == N);
+
+    ok = 1;
+    for (int i = 0; i < N; i++) ok &= (pool[i].dead <= 1);
+    tstcheck(ok);
+    valgcfree(gc);
+  }
+}
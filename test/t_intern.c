@@ -0,0 +1,130 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "valintern.h"
+
+tstsuite("Interned strings") {
+  valpool_t pool = valpoolnew();
+  tstassert(pool != NULL);
+
+  tstcase("Same text, same value") {
+    char buf[16];
+    strcpy(buf, "name");
+
+    val_t a = valintern(pool, "name");
+    val_t b = valintern(pool, buf);
+    val_t c = valintern(pool, "other");
+
+    tstcheck(valisinterned(a) && valisinterned(c));
+    tstcheck(!valisinterned("name"));
+    tstcheck(valeq(a, b));
+    tstcheck(!valeq(a, c));
+    tstcheck(valpoolcount(pool) == 2);
+    tstcheck(valinternlen(a) == 4 && valinternlen(c) == 5);
+    tstcheck(valinternlen("name") == 0);
+
+    tstcheck(strcmp(*(char **)valtoptr(a), "name") == 0);
+    tstcheck(((uintptr_t)valtoptr(a) & 7) == 0);
+
+    tstcheck(valeq(valintern(pool, ""), valintern(pool, "")));
+    tstcheck(valisnil(valintern(pool, NULL)));
+    tstcheck(valeq(valinternval(pool, "other"), c));
+    tstcheck(valeq(valinternval(pool, 42), 42));
+  }
+
+  tstcase("Comparison") {
+    val_t a = valintern(pool, "alpha");
+    val_t b = valintern(pool, "beta");
+
+    tstcheck(valcmp(a, a) == 0);
+    tstcheck(valcmp(a, b) < 0 && valcmp(b, a) > 0);
+    tstcheck(valcmp(a, "alpha") == 0 && valcmp("alpha", a) == 0);
+    tstcheck(valcmp(a, "alp") > 0 && valcmp("beta", a) > 0);
+    tstcheck(valcmp(valtagptr(a, 3), a) == 0);
+
+    // Same order of strcmp()
+    const char *s[] = {"", "a", "ab", "abc", "abcdefgh", "abcdefgh1", "abcdefgh2", "abcdefgi", "b", "\xC3\xA0", "z"};
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(s) / sizeof(s[0]); i++)
+      for (size_t j = 0; j < sizeof(s) / sizeof(s[0]); j++) {
+        int c = valcmp(valintern(pool, s[i]), valintern(pool, s[j]));
+        int e = strcmp(s[i], s[j]);
+        ok &= ((c > 0) == (e > 0)) && ((c < 0) == (e < 0));
+      }
+    tstcheck(ok, "Different order from strcmp()");
+
+    // Ordered as char * against other types
+    val_t others[] = {val(1.5), valnil, valtrue, val(stdout), valnullptr, val((valptr_5_t)NULL), val((valptr_0_t)NULL)};
+    ok = 1;
+    for (size_t i = 0; i < sizeof(others) / sizeof(others[0]); i++) {
+      ok &= (valcmp(a, others[i]) == valcmp("alpha", others[i]));
+      ok &= (valcmp(others[i], a) == valcmp(others[i], "alpha"));
+    }
+    tstcheck(ok, "Different order of interned strings and char *");
+  }
+
+  tstcase("Sort keys") {
+    const char *s[] = {"", "a", "abcdef", "abcdefg", "abcdefgh1", "abcdefgh2", "abcdeg", "\xC3\xA0"};
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(s) / sizeof(s[0]); i++) {
+      val_t v = valintern(pool, s[i]);
+      ok &= (valsortkey(v) == valsortkey((char *)s[i]));
+    }
+    tstcheck(ok);
+    tstcheck(valsortkeytie(valsortkey(valintern(pool, "abcdefg"))));
+    tstcheck(!valsortkeytie(valsortkey(valintern(pool, "abcdef"))));
+  }
+
+  tstcase("Hashing") {
+    char text[] = "a somewhat longer string";
+    val_t a = valintern(pool, text);
+
+    tstcheck(valhash(a) == valhash(text));
+    tstcheck(valhash(valtagptr(a, 1)) == valhash(text));
+
+    val_t v[9] = {a, val(1), val(text), a, valnil, a, val(2.5), a, a};
+    uint32_t h[9];
+    valhash_n(v, 9, h);
+    int ok = 1;
+    for (int i = 0; i < 9; i++) ok &= (h[i] == valhash(v[i]));
+    tstcheck(ok);
+  }
+
+  tstcase("Maps") {
+    valmap_t m = valmapnew(VALMAP_SEMANTIC);
+    val_t k = valintern(pool, "key");
+
+    valmapset(m, k, 1);
+    tstcheck(valmaphas(m, "key"));
+    valmapset(m, "key", 2);
+    tstcheck(valmapcount(m) == 1);
+    tstcheck(valtoint(valmapget(m, k)) == 2);
+    valmapfree(m);
+  }
+
+  tstcase("Many strings") {
+    char buf[32];
+    val_t v[5000];
+    int ok = 1;
+
+    for (int i = 0; i < 5000; i++) {
+      snprintf(buf, sizeof(buf), "string_%d", i);
+      v[i] = valintern(pool, buf);
+      ok &= valisinterned(v[i]);
+    }
+    for (int i = 0; i < 5000; i++) {
+      snprintf(buf, sizeof(buf), "string_%d", i);
+      ok &= valeq(valintern(pool, buf), v[i]) && (strcmp(*(char **)valtoptr(v[i]), buf) == 0);
+    }
+    tstcheck(ok);
+  }
+
+  pool = valpoolfree(pool);
+  tstcheck(pool == NULL);
+}
@@ -0,0 +1,150 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+typedef struct valptr_buf_s { char *buf; int len; } *buf_t;
+
+#include "valmap.h"
+
+#define N 20000
+
+tstsuite("Hash maps") {
+
+  tstcase("Set, get and delete") {
+    valmap_t m = valmapnew(VALMAP_IDENTITY);
+    tstassert(m != NULL);
+
+    tstcheck(valmapcount(m) == 0);
+    tstcheck(valisnil(valmapget(m, 1)));
+    tstcheck(valmapget(m, 1, 99).v == val(99).v);
+    tstcheck(!valmapdel(m, 1));
+
+    tstcheck(valmapset(m, 1, "one") == 0);
+    tstcheck(valmapset(m, valtrue, 2.5) == 0);
+    tstcheck(valmapset(m, valconst("sym"), valnil) == 0);
+    tstcheck(valmapcount(m) == 3);
+
+    tstcheck(strcmp(valtoptr(valmapget(m, 1)), "one") == 0);
+    tstcheck(valtodouble(valmapget(m, valtrue)) == 2.5);
+    tstcheck(valmaphas(m, valconst("sym")));
+    tstcheck(valisnil(valmapget(m, valconst("sym"), 0)));
+    tstcheck(!valmaphas(m, valfalse));
+
+    tstcheck(valmapset(m, 1, "uno") == 0);
+    tstcheck(valmapcount(m) == 3);
+    tstcheck(strcmp(valtoptr(valmapget(m, 1)), "uno") == 0);
+
+    val_t *r = valmapref(m, valtrue);
+    tstassert(r != NULL);
+    *r = val(3.5);
+    tstcheck(valtodouble(valmapget(m, valtrue)) == 3.5);
+    tstcheck(valmapref(m, 2) == NULL);
+
+    tstcheck(valmapdel(m, 1));
+    tstcheck(!valmaphas(m, 1));
+    tstcheck(valmapcount(m) == 2);
+
+    valmapclear(m);
+    tstcheck(valmapcount(m) == 0);
+    tstcheck(!valmaphas(m, valtrue));
+
+    m = valmapfree(m);
+    tstcheck(m == NULL);
+  }
+
+  tstcase("Identity and semantic keys") {
+    char s1[] = "key";
+    char s2[] = "key";
+    struct valptr_buf_s b = {s2, 3};
+    val_t v;
+
+    valmap_t id  = valmapnew(VALMAP_IDENTITY);
+    valmap_t sem = valmapnew(VALMAP_SEMANTIC);
+
+    valmapset(id, s1, 1);
+    valmapset(sem, s1, 1);
+    tstcheck(valmaphas(id, s1) && !valmaphas(id, s2) && !valmaphas(id, &b));
+    tstcheck(valmaphas(sem, s2) && valmaphas(sem, &b) && valmaphas(sem, "key"));
+    tstcheck(!valmaphas(sem, "ke"));
+
+    valmapset(sem, &b, 2);
+    tstcheck(valmapcount(sem) == 1);
+    tstcheck(valtoint(valmapget(sem, s1)) == 2);
+
+    valmapset(id, -0.0, 1);
+    valmapset(sem, -0.0, 1);
+    tstcheck(!valmaphas(id, 0.0) && valmaphas(id, -0.0));
+    tstcheck(valmaphas(sem, 0.0) && valmaphas(sem, 0));
+
+    valmapset(sem, 7, 1);
+    tstcheck(valmaphas(sem, 7.0));
+    tstcheck(!valmaphas(sem, 7.5));
+
+    v.v = 0x7FF8000000000001;  // A NaN different from NAN
+    valmapset(sem, NAN, 1);
+    tstcheck(valmaphas(sem, v));
+    tstcheck(!valmaphas(sem, 8));
+    valmapset(id, NAN, 1);
+    tstcheck(!valmaphas(id, v) && valmaphas(id, NAN));
+
+    // Strings are not equal to other types
+    tstcheck(!valmaphas(sem, valnil));
+    valmapset(sem, valnil, 1);
+    tstcheck(valmaphas(sem, valnil) && !valmaphas(sem, valfalse));
+
+    // NULL is the empty string
+    valmapset(sem, "", 5);
+    tstcheck(valtoint(valmapget(sem, (char *)NULL)) == 5);
+
+    valmapfree(id);
+    valmapfree(sem);
+  }
+
+  tstcase("Many keys, deletions and iteration") {
+    valmap_t m = valmapnew(VALMAP_IDENTITY);
+    int ok = 1;
+
+    for (int i = 0; i < N; i++) ok &= (valmapset(m, i, i * 2) == 0);
+    tstcheck(ok && valmapcount(m) == N);
+
+    ok = 1;
+    for (int i = 0; i < N; i++) ok &= (valtoint(valmapget(m, i)) == i * 2);
+    for (int i = N; i < 2 * N; i++) ok &= !valmaphas(m, i);
+    tstcheck(ok, "Lookup");
+
+    // Delete the odd keys and add them back a few times (exercising DELETED slots)
+    for (int round = 0; round < 3; round++) {
+      ok = 1;
+      for (int i = 1; i < N; i += 2) ok &= valmapdel(m, i);
+      ok &= (valmapcount(m) == N / 2);
+      for (int i = 0; i < N; i++) ok &= (valmaphas(m, i) == !(i & 1));
+      for (int i = 1; i < N; i += 2) ok &= (valmapset(m, i, -i) == 0);
+      ok &= (valmapcount(m) == N);
+      tstcheck(ok, "Round %d", round);
+    }
+    tstcheck(m->cap <= 4 * N, "Capacity: %zu", m->cap);
+
+    val_t k, v;
+    size_t n = 0;
+    int64_t sum = 0;
+    for (size_t i = 0; (i = valmapnext(m, i, &k, &v)); ) {
+      n++;
+      sum += valtoint(k);
+      ok &= (valtoint(v) == ((valtoint(k) & 1) ? -valtoint(k) : valtoint(k) * 2));
+    }
+    tstcheck(ok && n == N && sum == (int64_t)N * (N - 1) / 2);
+
+    tstcheck(valmapreserve(m, 4 * N) == 0);
+    ok = 1;
+    for (int i = 0; i < N; i++) ok &= valmaphas(m, i);
+    tstcheck(ok && valmapcount(m) == N);
+
+    valmapfree(m);
+  }
+}
@@ -0,0 +1,112 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#ifndef VALNATIVEINT
+#define VALNATIVEINT
+#endif
+#include "valbatch.h"
+
+#define N 300
+
+tstsuite("Native 32-bit integers") {
+
+  tstcase("Integers that fit in 32 bits are stored natively") {
+    val_t a = val(42);
+    val_t b = val(-1);
+    val_t c = val(INT32_MIN);
+    val_t d = val((uint32_t)INT32_MAX);
+
+    tstcheck(a.v == (VAL_INT32 | 42), "%016" PRIX64, a.v);
+    tstcheck(b.v == (VAL_INT32 | 0xFFFFFFFF), "%016" PRIX64, b.v);
+    tstcheck(val_is_int32(c) && val_is_int32(d));
+
+    tstcheck(!val_is_int32(val((int64_t)INT32_MAX + 1)));
+    tstcheck(!val_is_int32(val((int64_t)INT32_MIN - 1)));
+    tstcheck(!val_is_int32(val((uint32_t)INT32_MAX + 1)));
+    tstcheck(!val_is_int32(val(42.0)));
+    tstcheck(valtoint((int64_t)INT32_MAX + 1) == (int64_t)INT32_MAX + 1);
+  }
+
+  tstcase("Native integers are numbers") {
+    val_t a = val(-7);
+
+    tstcheck(valisnumber(a));
+    tstcheck(valisint(a));
+    tstcheck(!valisconst(a));
+    tstcheck(!valisptr(a));
+    tstcheck(valtoint(a) == -7);
+    tstcheck(valtodouble(a) == -7.0);
+    tstcheck(valtoint(INT32_MIN) == INT32_MIN);
+    tstcheck(valtobool(a) && !valtobool(0));
+    tstcheck(strcmp(valtostr(a).str, "-7") == 0, "str: %s", valtostr(a).str);
+
+    errno = 0;
+    valtodouble(a);
+    tstcheck(errno == 0);
+  }
+
+  tstcase("Comparisons and hashes across representations") {
+    tstcheck(valcmp(3, 3.0) == 0);
+    tstcheck(valcmp(3.0, 3) == 0);
+    tstcheck(valcmp(2, 2.5) < 0);
+    tstcheck(valcmp(-3, -3.5) > 0);
+    tstcheck(valcmp(-1, 1) < 0);
+    tstcheck(valcmp(INT32_MIN, INT32_MAX) < 0);
+    tstcheck(valcmp(INT32_MAX, (int64_t)INT32_MAX + 1) < 0);
+    tstcheck(valcmp(5, valnil) < 0);
+    tstcheck(valcmp(valnil, 5) > 0);
+    tstcheck(valcmp(5, "5") < 0);
+
+    tstcheck(!valeq(3, 3.0));  // Identity
+    tstcheck(valhash(3) == valhash(3.0));
+    tstcheck(valhash(-100) == valhash(-100.0));
+    tstcheck(valhash(0) == valhash(0.0));
+    tstcheck(valhash(1) != valhash(2));
+  }
+
+  tstcase("Batch functions") {
+    val_t    v[N];
+    uint8_t  types[N];
+    uint64_t bits[(N+63)/64];
+    uint32_t hashes[N];
+    size_t   cnt, exp;
+    int      ok;
+
+    for (int i = 0; i < N; i++) {
+      switch (i % 5) {
+        case 0:  v[i] = val(i * 7 - 500); break;
+        case 1:  v[i] = val(i / 4.0); break;
+        case 2:  v[i] = valconst(i); break;
+        case 3:  v[i] = val("x"); break;
+        default: v[i] = val(-i); break;
+      }
+    }
+
+    valclassify_n(v, N, types);
+    ok = 1;
+    for (int i = 0; i < N; i++) ok &= (types[i] == valclassify(v[i])) && ((types[i] == VALCLASS_NUMBER) == !!valisnumber(v[i]));
+    tstcheck(ok, "Classification");
+
+    cnt = valmask_number_n(v, N, bits);
+    ok = 1; exp = 0;
+    for (int i = 0; i < N; i++) { ok &= (valmaskbit(bits, i) == (uint64_t)!!valisnumber(v[i])); exp += !!valisnumber(v[i]); }
+    tstcheck(ok && cnt == exp, "Numbers mask");
+
+    cnt = valisint_n(v, N, bits);
+    ok = 1; exp = 0;
+    for (int i = 0; i < N; i++) { ok &= (valmaskbit(bits, i) == (uint64_t)!!valisint(v[i])); exp += !!valisint(v[i]); }
+    tstcheck(ok && cnt == exp, "Integers mask");
+
+    valhash_n(v, N, hashes);
+    ok = 1;
+    for (int i = 0; i < N; i++) ok &= (hashes[i] == valhash(v[i]));
+    tstcheck(ok, "Hashes");
+  }
+}
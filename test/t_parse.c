@@ -0,0 +1,160 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "valparse.h"
+
+static uint64_t rnd_state = 0x9E3779B97F4A7C15;
+static uint64_t rnd(void) {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 7;
+  rnd_state ^= rnd_state << 17;
+  return rnd_state;
+}
+
+// Same bits of `strtod()`
+static int same_strtod(const char *s) {
+  val_t x = valfromstr(s);
+  double d = strtod(s, NULL);
+#ifdef VALNATIVEINT
+  if (val_is_int32(x)) return valtodouble(x) == d;
+#endif
+  return memcmp(&x, &d, sizeof(d)) == 0;
+}
+
+tstsuite("Parsing") {
+  tstcase("Numbers") {
+    tstcheck(valeq(valfromstr("42"), 42));
+    tstcheck(valeq(valfromstr("-17"), -17));
+    tstcheck(valeq(valfromstr("+5"), 5));
+    tstcheck(valtodouble(valfromstr("2.5")) == 2.5);
+    tstcheck(valtodouble(valfromstr(".5")) == 0.5 && valtodouble(valfromstr("5.")) == 5.0);
+    tstcheck(valtodouble(valfromstr("1e3")) == 1000.0 && valtodouble(valfromstr("-1.5E-3")) == -0.0015);
+    tstcheck(valtodouble(valfromstr("  7.25\n")) == 7.25);
+    tstcheck(valtodouble(valfromstr("9223372036854775807")) == 9223372036854775807.0);
+#ifdef VALNATIVEINT
+    tstcheck(val_is_int32(valfromstr("123")) && !val_is_int32(valfromstr("123.0")));
+    tstcheck(!val_is_int32(valfromstr("3000000000")));
+#endif
+
+    double d = valtodouble(valfromstr("-0"));
+    tstcheck(d == 0.0 && signbit(d));
+    tstcheck(isinf(valtodouble(valfromstr("inf"))) && valtodouble(valfromstr("-Infinity")) < 0);
+    tstcheck(isnan(valtodouble(valfromstr("nan"))));
+
+    char *exact[] = {
+      "0.1", "0.3", "1.7976931348623157e308", "2.2250738585072014e-308", "2.2250738585072011e-308",
+      "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "1e-400", "1e309",
+      "9007199254740993", "9007199254740993.0", "9007199254740995.0", "123456789012345678",
+      "18446744073709551615", "0.1000000000000000055511151231257827", "3.14159265358979323846264338327950288",
+      "1e23", "8.5e22", "7.3177701707893310e+15", "0.000000000000000000000000000000000001e36",
+      "00000000000000000000000000000000001.5", "179769313486231580793728971405301e276",
+      "2.225073858507201136057409796709131975934819546351645e-308", "1.00000005960464477539062499",
+    };
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(exact) / sizeof(exact[0]); i++)
+      if (!same_strtod(exact[i])) { ok = 0; tstnote("%s", exact[i]); }
+    tstcheck(ok);
+  }
+
+  tstcase("Same of strtod()") {
+    char buf[64];
+    int ok = 1;
+    for (int i = 0; i < 200000 && ok; i++) {
+      uint64_t r = rnd();
+      double d;
+      switch (i % 4) {
+        case 0:  // Any double
+          r &= ~((uint64_t)0x7FF << 52) | ((r % 0x7FF) << 52);
+          memcpy(&d, &r, sizeof(d));
+          snprintf(buf, sizeof(buf), "%.17g", d);
+          break;
+        case 1:  // Shortest digits
+          memcpy(&d, &r, sizeof(d));
+          if (d != d || isinf(d)) d = 1.0 / (double)(r | 1);
+          snprintf(buf, sizeof(buf), "%.*g", 1 + (int)(r % 16), d);
+          break;
+        case 2:  // Random digits and exponent
+          snprintf(buf, sizeof(buf), "%" PRIu64 "e%d", r >> (r % 64), (int)(r % 700) - 350);
+          break;
+        default: // Fixed point
+          snprintf(buf, sizeof(buf), "%.*f", (int)(r % 10), (double)(int64_t)r / (double)(1 << (r % 30)));
+          break;
+      }
+      if (!same_strtod(buf)) { ok = 0; tstnote("%s", buf); }
+    }
+    tstcheck(ok);
+  }
+
+  tstcase("Constants and symbols") {
+    tstcheck(valisnil(valfromstr("nil")));
+    tstcheck(valeq(valfromstr("true"), valtrue) && valeq(valfromstr("false"), valfalse));
+    tstcheck(valeq(valfromstr("<2A>"), valconst(42)) && valeq(valfromstr("<ffffffff>"), valconst(0xFFFFFFFF)));
+    tstcheck(valeq(valfromstr("if"), valconst("if")));
+    tstcheck(valeq(valfromstr("abcdefgh"), valconst("abcdefgh")));
+    tstcheck(valeq(valfromstr("-"), valconst("-")) && valeq(valfromstr("1x"), valconst("1x")));
+    tstcheck(valeq(valfromstr("1e+"), valconst("1e+")) && valeq(valfromstr("<A"), valconst("<A")));
+
+    // What `valtostr()` writes is read back
+    val_t v[] = {valnil, valtrue, valfalse, valconst(0), valconst(0xC0FFEE), valconst("x"), valconst("<=>"),
+                 valconst("ABCDEF"), valconst("n_1"), val(0), val(-123456), val(2.5)};
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(v) / sizeof(v[0]); i++)
+      if (valfromstr(valtostr(v[i]).str).v != v[i].v) { ok = 0; tstnote("%s", valtostr(v[i]).str); }
+    tstcheck(ok);
+
+    char *bad[] = {"", "   ", "abcdefghi", "Hello", "a b", "<123456789>", "<2G>", "1.0e+100x", "\"s\""};
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+      errno = 0;
+      val_t x = valfromstr(bad[i]);
+      if (!valisnil(x) || errno != EINVAL) { ok = 0; tstnote("[%s]", bad[i]); }
+    }
+    tstcheck(ok);
+    errno = 0;
+    tstcheck(valisnil(valfromstr(NULL)) && errno == EINVAL);
+    tstcheck(valeq(valfromstrn("12345", 3), 123));
+  }
+
+  tstcase("Batches") {
+    const char *s = " 1 2.5\tnil\n\n<A> sym -3e2 ";
+    val_t v[8];
+    size_t pos;
+    tstcheck(valfromstr_n(s, strlen(s), 0, v, 8, &pos) == 6 && pos == strlen(s));
+    tstcheck(valeq(v[0], 1) && valtodouble(v[1]) == 2.5 && valisnil(v[2]));
+    tstcheck(valeq(v[3], valconst(10)) && valeq(v[4], valconst("sym")) && valtodouble(v[5]) == -300.0);
+
+    // At most n values
+    tstcheck(valfromstr_n(s, strlen(s), 0, v, 2, &pos) == 2 && strncmp(s + pos, "\tnil", 4) == 0);
+
+    // Stops at what is not a value
+    errno = 0;
+    s = "1 2 not_a_symbol 4";
+    tstcheck(valfromstr_n(s, strlen(s), 0, v, 8, &pos) == 2 && errno == EINVAL && pos == 4);
+
+    // Separators
+    s = "1, 2 ,,true,";
+    tstcheck(valfromstr_n(s, strlen(s), ',', v, 8, &pos) == 4 && pos == strlen(s));
+    tstcheck(valeq(v[0], 1) && valeq(v[1], 2) && valisnil(v[2]) && valeq(v[3], valtrue));
+    s = "1;x y;3";
+    tstcheck(valfromstr_n(s, strlen(s), ';', v, 8, &pos) == 1 && pos == 2);
+
+    // Long input
+    size_t n = 10000;
+    char *txt = malloc(n * 24);
+    size_t len = 0;
+    for (size_t i = 0; i < n; i++) len += (size_t)sprintf(txt + len, "%.17g\n", (double)i / 7);
+    val_t *a = malloc(n * sizeof(val_t));
+    tstcheck(valfromstr_n(txt, len, 0, a, n, NULL) == n);
+    int ok = 1;
+    for (size_t i = 0; i < n; i++) ok &= (valtodouble(a[i]) == (double)i / 7);
+    tstcheck(ok);
+    free(a);
+    free(txt);
+  }
+}
@@ -82,6 +82,16 @@ tstsuite("Val Library pointers", advanced) {
         point_val = valtagptr(point_val,0);
         tstcheck((valtagptr(point_val) == 0), "Expect 0 got %d",valtagptr(point_val));
 
+        // Types with a positive prefix (7FFB .. 7FFF) can be tagged as well
+        val_t file_val = val((FILE *)point);
+        file_val = valtagptr(file_val,5);
+        tstcheck((valtagptr(file_val) == 5), "Expect 5 got %d",valtagptr(file_val));
+        tstcheck(valtoptr(file_val) == (void *)point);
+        val_t p3_val = val((valptr_3_t)point);
+        p3_val = valtagptr(p3_val,3);
+        tstcheck((valtagptr(p3_val) == 3), "Expect 3 got %d",valtagptr(p3_val));
+        tstcheck(valtoptr(p3_val) == (void *)point);
+
         // Untaggable pointer (char *)
         val_t charptr_val = val("Hello");
         tstcheck((valtagptr(charptr_val) == 0), "Expect 0 got %d",valtagptr(charptr_val));
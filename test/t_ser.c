@@ -0,0 +1,122 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "valbuf.h"
+#include "valser.h"
+
+#define TMPFILE "t_ser.tmp"
+
+tstsuite("Serialization") {
+  tstcase("Values and strings") {
+    char text[] = "Hello, world";
+    valbuf_t b = valbuffrom("a\0b", 3);
+    val_t v[] = {
+      val(1), val(-2.5), val(3000000000), val(0.0 / 0.0), valtrue, valfalse, valnil,
+      valconst("sym"), valconst(42), valshortstr("short"), val(text), val("Hello, world"),
+      val((char *)NULL), val(""), val(b), val(text)
+    };
+    size_t n = sizeof(v) / sizeof(v[0]);
+
+    tstassert(valsersave(TMPFILE, v, n) == 0);
+    valbuffree(b);                 // The loaded values don't depend on the saved ones
+    memset(text, 'x', sizeof(text) - 1);
+
+    valser_t s = valserload(TMPFILE);
+    tstassert(s != NULL);
+    tstcheck(valsercount(s) == n);
+
+    int ok = 1;
+    for (size_t i = 0; i < 10; i++) ok &= (valserget(s, i).v == v[i].v);
+    tstcheck(ok);
+    tstcheck(valischarptr(valserget(s, 10)) && strcmp(valtoptr(valserget(s, 10)), "Hello, world") == 0);
+    tstcheck(valserget(s, 10).v == valserget(s, 11).v);   // Same text, stored once
+    tstcheck(valserget(s, 10).v == valserget(s, 15).v);
+    tstcheck(valischarptr(valserget(s, 12)) && valtoptr(valserget(s, 12)) == NULL);
+    tstcheck(strcmp(valtoptr(valserget(s, 13)), "") == 0);
+
+    val_t lb = valserget(s, 14);
+    tstcheck(valisbufptr(lb));
+    valbuf_t vb = valtoptr(lb);
+    tstcheck(vb->len == 3 && vb->cap == 0 && memcmp(vb->buf, "a\0b", 4) == 0);
+    tstcheck(valisnil(valserget(s, n)));
+
+    // All the values at once: the same of `valserget()`
+    val_t got[16];
+    for (size_t i = 0; i < n; i++) got[i] = valserget(s, i);
+    val_t *a = valservals(s);
+    for (size_t i = 0; i < n; i++) ok &= (a[i].v == got[i].v);
+    tstcheck(ok);
+    tstcheck(valserget(s, 10).v == a[10].v);
+    tstcheck(valcmp(a[11], "Hello, world") == 0 && valhash(a[11]) == valhash(val("Hello, world")));
+
+    s = valserfree(s);
+    tstcheck(s == NULL);
+    remove(TMPFILE);
+  }
+
+  tstcase("Large arrays") {
+    size_t n = 100000;
+    val_t *v = malloc(n * sizeof(val_t));
+    char (*strs)[16] = malloc(n * 16);
+    tstassert(v && strs);
+    for (size_t i = 0; i < n; i++) {
+      snprintf(strs[i], 16, "s%zu", i % 1000);
+      v[i] = (i % 3) ? val((double)i / 3) : val(strs[i]);
+    }
+    tstassert(valsersave(TMPFILE, v, n) == 0);
+
+    valser_t s = valserload(TMPFILE);
+    tstassert(s != NULL);
+    val_t *a = valservals(s);
+    int ok = (valsercount(s) == n);
+    for (size_t i = 0; i < n && ok; i++) ok &= (valcmp(a[i], v[i]) == 0);
+    tstcheck(ok);
+    valserfree(s);
+
+    // Numbers only
+    tstassert(valsersave(TMPFILE, v + 1, 1) == 0);
+    s = valserload(TMPFILE);
+    tstcheck(s && s->nrefs == 0 && valsercount(s) == 1 && valservals(s)[0].v == v[1].v);
+    valserfree(s);
+
+    // Empty
+    tstassert(valsersave(TMPFILE, v, 0) == 0);
+    s = valserload(TMPFILE);
+    tstcheck(s && valsercount(s) == 0);
+    valserfree(s);
+
+    remove(TMPFILE);
+    free(strs);
+    free(v);
+  }
+
+  tstcase("Errors") {
+    val_t v[] = {val(1), val((void *)&v)};
+    errno = 0;
+    tstcheck(valsersave(TMPFILE, v, 2) == -1 && errno == EINVAL);
+
+    FILE *f = fopen(TMPFILE, "wb");
+    tstassert(f != NULL);
+    fputs("Not a file of values, but long enough to have a header", f);
+    fclose(f);
+    errno = 0;
+    tstcheck(valserload(TMPFILE) == NULL && errno == EINVAL);
+
+    // Truncated
+    tstassert(valsersave(TMPFILE, v, 1) == 0);
+    f = fopen(TMPFILE, "ab");
+    fputc(0, f);
+    fclose(f);
+    errno = 0;
+    tstcheck(valserload(TMPFILE) == NULL && errno == EINVAL);
+
+    remove(TMPFILE);
+    tstcheck(valserload(TMPFILE) == NULL);
+  }
+}
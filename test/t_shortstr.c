@@ -0,0 +1,109 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+
+typedef struct valptr_buf_s { char *buf; int len; } *buf_t;
+
+#include "valmap.h"
+
+tstsuite("Short strings") {
+
+  tstcase("Creation") {
+    val_t s = valshortstr("USD");
+
+    tstcheck(valisshortstr(s), "%016" PRIX64, s.v);
+    tstcheck(strcmp(valtostr(s).str, "USD") == 0);
+    tstcheck(strcmp(valtostr(valshortstr("abcdef")).str, "abcdef") == 0);
+    tstcheck(strcmp(valtostr(valshortstr("\xC3\xA0")).str, "\xC3\xA0") == 0);
+    tstcheck(strcmp(valtostr(s, "[%s]").str, "[USD]") == 0);
+
+    errno = 0;
+    tstcheck(valisnil(valshortstr("abcdefg")) && errno == EINVAL);
+    errno = 0;
+    tstcheck(valisnil(valshortstr("")) && errno == EINVAL);
+    errno = 0;
+    tstcheck(valisnil(valshortstr(NULL)) && errno == EINVAL);
+
+    // Not other types
+    tstcheck(!valisnumber(s) && !valisint(s) && !valisptr(s) && !valisconst(s));
+    tstcheck(!valisshortstr("USD") && !valisshortstr(0) && !valisshortstr(valnil));
+    val_t ext = {VAL_INT32 | 42};  // A native integer (even if VALNATIVEINT is not defined)
+    tstcheck(!valisshortstr(ext));
+    tstcheck(valeq(valshortstr("USD"), s) && !valeq(valshortstr("EUR"), s));
+  }
+
+  tstcase("Comparison") {
+    char usd[] = "USD";
+    struct valptr_buf_s b = {usd, 3};
+
+    tstcheck(valcmp(valshortstr("USD"), usd) == 0 && valcmp(usd, valshortstr("USD")) == 0);
+    tstcheck(valcmp(valshortstr("USD"), &b) == 0);
+    tstcheck(valcmp(valshortstr("US"), usd) < 0 && valcmp(valshortstr("USDT"), usd) > 0);
+    tstcheck(valcmp(valshortstr("abcdef"), "abcdefg") < 0);
+    tstcheck(valcmp(valshortstr("a"), (char *)NULL) > 0);
+
+    // Same order of strcmp()
+    const char *s[] = {"a", "ab", "abc", "abcdef", "abd", "b", "Z", "~", "\xC3\xA0", "\x7F"};
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(s) / sizeof(s[0]); i++)
+      for (size_t j = 0; j < sizeof(s) / sizeof(s[0]); j++) {
+        int c = valcmp(valshortstr(s[i]), valshortstr(s[j]));
+        int m = valcmp(valshortstr(s[i]), (char *)s[j]);
+        int e = strcmp(s[i], s[j]);
+        ok &= ((c > 0) == (e > 0)) && ((c < 0) == (e < 0));
+        ok &= ((m > 0) == (e > 0)) && ((m < 0) == (e < 0));
+      }
+    tstcheck(ok, "Different order from strcmp()");
+
+    // Ordered as char * against other types
+    val_t others[] = {val(1.5), valnil, valtrue, valconst("sym"), val(stdout), valnullptr, val((valptr_0_t)NULL)};
+    ok = 1;
+    for (size_t i = 0; i < sizeof(others) / sizeof(others[0]); i++) {
+      ok &= (valcmp(valshortstr("USD"), others[i]) == valcmp("USD", others[i]));
+      ok &= (valcmp(others[i], valshortstr("USD")) == valcmp(others[i], "USD"));
+    }
+    tstcheck(ok, "Different order of short strings and char *");
+  }
+
+  tstcase("Hashing") {
+    const char *s[] = {"a", "USD", "abcdef", "\xC3\xA0\xC3\xA8", "~"};
+    int ok = 1;
+    for (size_t i = 0; i < sizeof(s) / sizeof(s[0]); i++)
+      ok &= (valhash(valshortstr(s[i])) == valhash((char *)s[i]));
+    tstcheck(ok);
+
+    val_t v[11] = {valshortstr("a"), val(1), val("text"), valshortstr("xyz"), valnil,
+                   valshortstr("\xC3\xA0"), val(2.5), valshortstr("abcdef"), valconst("x"), valshortstr("b"), val(-3)};
+    uint32_t h[11];
+    valhash_n(v, 11, h);
+    ok = 1;
+    for (int i = 0; i < 11; i++) ok &= (h[i] == valhash(v[i]));
+    tstcheck(ok);
+  }
+
+  tstcase("Maps") {
+    valmap_t sem = valmapnew(VALMAP_SEMANTIC);
+    valmap_t id  = valmapnew(VALMAP_IDENTITY);
+    char eur[] = "EUR";
+
+    valmapset(sem, valshortstr("USD"), 1);
+    valmapset(sem, eur, 2);
+    tstcheck(valmaphas(sem, "USD") && valmaphas(sem, valshortstr("EUR")));
+    valmapset(sem, "USD", 3);
+    tstcheck(valmapcount(sem) == 2);
+    tstcheck(valtoint(valmapget(sem, valshortstr("USD"))) == 3);
+
+    // Short strings with the same text are identical
+    valmapset(id, valshortstr("USD"), 1);
+    tstcheck(valmaphas(id, valshortstr("USD")) && !valmaphas(id, "USD"));
+
+    valmapfree(sem);
+    valmapfree(id);
+  }
+}
@@ -0,0 +1,120 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "valbatch.h"
+
+#define N 400
+
+static int sign(int64_t x) { return (x > 0) - (x < 0); }
+
+// The order of the keys is the order of `valcmp()` (unless there is a tie)
+static int keycmp(val_t a, val_t b) {
+  uint64_t ka = valsortkey(a), kb = valsortkey(b);
+  if (ka != kb) return (ka > kb) - (ka < kb);
+  return valsortkeytie(ka) ? valcmp(a, b) : 0;
+}
+
+static int cmp_key(const void *a, const void *b) { return keycmp(*(const val_t *)a, *(const val_t *)b); }
+
+static char strs[N][16];
+static int  vars[4];
+
+static val_t random_val(int i) {
+  char *s = strs[i];
+  int len = rand() % 10;
+  for (int k = 0; k < len; k++) s[k] = (rand() % 4) ? 'a' + rand() % 3 : (char)(1 + rand() % 255);
+  s[len] = '\0';
+
+  switch (rand() % 14) {
+    case 0:  return val(rand() % 100 - 50);
+    case 1:  return val((double)(rand() - RAND_MAX / 2) / (rand() % 1000 + 1));
+    case 2:  return val(ldexp((double)rand(), 40) * ((rand() & 1) ? 1 : -1));
+    case 3:  { double d[] = {0.0, -0.0, INFINITY, -INFINITY, 5e-324, -5e-324, 1e308, -1e308};
+               return val(d[rand() % 8]); }
+    case 4:
+    case 5:  return val(s);
+    case 6:  return (len > 0 && len <= 6) ? valshortstr(s) : val(s);
+    case 7:  return valsymconst(len ? s : "x");
+    case 8:  { val_t c[] = {valtrue, valfalse, valnil, valnumconst(rand() % 10)}; return c[rand() % 4]; }
+    case 9:  return val(&vars[rand() % 4]);
+    case 10: return val((FILE *)(&vars[rand() % 4]));
+    case 11: return val((char *)NULL);
+    case 12: return val((valptr_3_t)&vars[rand() % 4]);
+    default: { val_t ext = {VAL_SSTR | (uint64_t)(rand() % 4)}; return ext; }  // FFF9 but not a short string
+  }
+}
+
+tstsuite("Sort keys") {
+  srand(11);
+
+  tstcase("Numbers") {
+    tstcheck(valsortkey(0.0) == valsortkey(-0.0));
+    tstcheck(valsortkey(0) == valsortkey(0.0));
+    tstcheck(valsortkey(-1) < valsortkey(-0.5) && valsortkey(-0.5) < valsortkey(0));
+    tstcheck(valsortkey(0) < valsortkey(5e-324) && valsortkey(1) < valsortkey(1e300));
+    tstcheck(valsortkey(-INFINITY) < valsortkey(-1e308) && valsortkey(1e308) < valsortkey(INFINITY));
+
+    // NaNs are after +inf (and before any other value)
+    tstcheck(valsortkey(NAN) == VAL_SORTKEY_NAN && valsortkey(-NAN) == VAL_SORTKEY_NAN);
+    tstcheck(valsortkey(INFINITY) < valsortkey(NAN));
+    tstcheck(valsortkey(NAN) < valsortkey(valfalse) && valsortkey(NAN) < valsortkey("x"));
+  }
+
+  tstcase("Strings") {
+    tstcheck(valsortkey("abc") == valsortkey(valshortstr("abc")));
+    tstcheck(valsortkey("") == valsortkey((char *)NULL));
+    tstcheck(valsortkey("") < valsortkey("a") && valsortkey("a") < valsortkey("ab"));
+    tstcheck(valsortkey("abcdef") < valsortkey("abcdefg") && valsortkey("abcdefg") == valsortkey("abcdefz"));
+    tstcheck(valsortkey("abcdeg") > valsortkey("abcdefz"));
+    tstcheck(valsortkey("\xFF") > valsortkey("\x7F"));
+
+    tstcheck(!valsortkeytie(valsortkey("abcdef")) && valsortkeytie(valsortkey("abcdefg")));
+    tstcheck(!valsortkeytie(valsortkey(1.0)) && !valsortkeytie(valsortkey(1e-300)));
+    tstcheck(!valsortkeytie(valsortkey(valtrue)));
+
+    // Strings are after numbers and constants, and before other pointers (as in `valcmp()`)
+    tstcheck(valsortkey(valnil) < valsortkey("") && valsortkey(1e300) < valsortkey(""));
+    tstcheck(valsortkey((valptr_3_t)vars) < valsortkey("") && valsortkey("~") < valsortkey((valptr_2_t)vars));
+  }
+
+  tstcase("Same order of valcmp()") {
+    val_t v[N];
+    for (int i = 0; i < N; i++) v[i] = random_val(i);
+
+    int ok = 1;
+    for (int i = 0; i < N; i++)
+      for (int j = 0; j < N; j++)
+        if (sign(keycmp(v[i], v[j])) != sign(valcmp(v[i], v[j]))) {
+          ok = 0;
+          tstnote("%016" PRIX64 " %016" PRIX64 " %d %d", v[i].v, v[j].v, keycmp(v[i], v[j]), valcmp(v[i], v[j]));
+        }
+    tstcheck(ok);
+
+    qsort(v, N, sizeof(val_t), cmp_key);
+    ok = 1;
+    for (int i = 1; i < N; i++) ok &= (valcmp(v[i - 1], v[i]) <= 0);
+    tstcheck(ok);
+  }
+
+  tstcase("Batch") {
+    val_t v[N + 3];
+    for (int i = 0; i < N; i++) v[i] = random_val(i);
+    v[N] = val(NAN); v[N + 1] = val(-0.0); v[N + 2] = val(-NAN);
+
+    uint64_t k[N + 3];
+    for (int n = 0; n <= N + 3; n += (n < 20) ? 1 : 37) {
+      memset(k, 0, sizeof(k));
+      valsortkey_n(v + (N + 3 - n), n, k);
+      int ok = 1;
+      for (int i = 0; i < n; i++) ok &= (k[i] == valsortkey(v[N + 3 - n + i]));
+      tstcheck(ok, "n: %d", n);
+    }
+  }
+}
@@ -0,0 +1,172 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "valbuf.h"
+#include "valmap.h"
+#include "valsort.h"
+
+tstsuite("Standard buffers") {
+
+  tstcase("Creation and growth") {
+    valbuf_t b = valbufnew(0);
+    tstassert(b != NULL);
+    tstcheck(b->len == 0 && b->buf[0] == '\0' && b->cap > 0);
+
+    tstcheck(valbufcat(b, "Hello") == 0);
+    tstcheck(b->len == 5 && strcmp(b->buf, "Hello") == 0);
+
+    int ok = 1;
+    for (int i = 0; i < 1000; i++) ok &= (valbufappend(b, "0123456789", 10) == 0);
+    tstcheck(ok && b->len == 10005 && b->buf[b->len] == '\0' && b->cap > b->len);
+
+    valbufclear(b);
+    tstcheck(b->len == 0 && b->buf[0] == '\0');
+
+    tstcheck(valbufappend(b, "a\0b", 3) == 0);
+    tstcheck(b->len == 3 && b->buf[1] == '\0' && b->buf[2] == 'b');
+    b = valbuffree(b);
+    tstcheck(b == NULL);
+
+    // A buffer that doesn't own its memory is copied when it grows
+    char text[] = "view";
+    struct valptr_buf_s v = {text, 4, 0, 0};
+    tstcheck(valbufcat(&v, "ing") == 0);
+    tstcheck(strcmp(v.buf, "viewing") == 0 && strcmp(text, "view") == 0 && v.cap > 0);
+    free(v.buf);
+
+    // Clearing it doesn't write into memory it doesn't own
+    struct valptr_buf_s lit = {"hello", 5, 0, 0};
+    valbufclear(&lit);
+    tstcheck(lit.len == 0 && lit.buf[0] == '\0');
+    struct valptr_buf_s view = {text, 4, 0, 0};
+    valbufclear(&view);
+    tstcheck(view.len == 0 && strcmp(text, "view") == 0);
+    tstcheck(valbufcat(&view, "new") == 0 && strcmp(view.buf, "new") == 0 && view.cap > 0);
+    tstcheck(strcmp(text, "view") == 0);
+    free(view.buf);
+  }
+
+  tstcase("Comparison") {
+    valbuf_t a = valbuffrom("abc", 3);
+    valbuf_t b = valbuffrom("abc", 3);
+    valbuf_t c = valbuffrom("ab", 2);
+    valbuf_t z = valbuffrom("ab\0c", 4);
+
+    tstcheck(valcmp(a, b) == 0);
+    tstcheck(valcmp(a, c) > 0 && valcmp(c, a) < 0);
+    tstcheck(valcmp(a, "abc") == 0 && valcmp("abc", a) == 0);
+    tstcheck(valcmp(a, "abd") < 0 && valcmp(a, "ab") > 0);
+    tstcheck(valcmp(a, valshortstr("abc")) == 0);
+
+    // Embedded NULs are part of the content
+    tstcheck(valcmp(z, c) > 0 && valcmp(c, z) < 0);
+    tstcheck(valcmp(z, "ab") > 0);
+
+    // Empty and NULL are the same
+    struct valptr_buf_s e = {NULL, 0, 0, 0};
+    valbuf_t empty = valbufnew(4);
+    tstcheck(valcmp(&e, empty) == 0 && valcmp(empty, "") == 0 && valcmp(empty, (char *)NULL) == 0);
+
+    // Ordered as strings against other types
+    tstcheck(valcmp(a, 1) == valcmp("abc", 1) && valcmp(valnil, a) == valcmp(valnil, "abc"));
+
+    valbuffree(a); valbuffree(b); valbuffree(c); valbuffree(z); valbuffree(empty);
+  }
+
+  tstcase("Hashing") {
+    valbuf_t a = valbuffrom("some text", 9);
+
+    tstcheck(a->hash == 0);
+    uint32_t h = valhash(a);
+    tstcheck(h == valhash("some text") && a->hash == h);
+    tstcheck(valhash(valtagptr(val(a), 3)) == h);
+
+    valbufcat(a, "!");
+    tstcheck(a->hash == 0 && valhash(a) == valhash("some text!"));
+
+    a->buf[0] = 'S';
+    valbufchanged(a);
+    tstcheck(valhash(a) == valhash("Some text!"));
+
+    valbuf_t z = valbuffrom("ab\0c", 4);
+    tstcheck(valhash(z) != valhash("ab"));
+
+    val_t v[7] = {val(a), val(1), val(z), val("x"), val(a), valnil, val(z)};
+    uint32_t hs[7];
+    a->hash = z->hash = 0;
+    valhash_n(v, 7, hs);
+    int ok = 1;
+    for (int i = 0; i < 7; i++) ok &= (hs[i] == valhash(v[i]));
+    tstcheck(ok);
+
+    valbuffree(a); valbuffree(z);
+  }
+
+  tstcase("Sort keys") {
+    valbuf_t a = valbuffrom("abc", 3);
+    valbuf_t z = valbuffrom("ab\0c", 4);
+    valbuf_t y = valbuffrom("ab\0", 3);
+    valbuf_t l = valbuffrom("abcdefgh", 8);
+
+    tstcheck(valsortkey(a) == valsortkey("abc") && !valsortkeytie(valsortkey(a)));
+    tstcheck(valsortkey(l) == valsortkey("abcdefgz") && valsortkeytie(valsortkey(l)));
+
+    // A NUL in the first bytes is not the end of the buffer
+    tstcheck(valsortkey(z) > valsortkey("ab") && valsortkey(y) > valsortkey("ab"));
+    tstcheck(valsortkey(y) < valsortkey(z) && valsortkey(z) < valsortkey(a));
+    tstcheck(valsortkeytie(valsortkey(y)) && valsortkeytie(valsortkey(z)));
+
+    struct valptr_buf_s e = {NULL, 0, 0, 0};
+    tstcheck(valsortkey(&e) == valsortkey(""));
+
+    valbuffree(a); valbuffree(z); valbuffree(y); valbuffree(l);
+  }
+
+  tstcase("Sorting") {
+    // Long buffers with the same first bytes and with NULs
+    const char *text[] = {"abcdefgh", "abcdefg\0h", "abcdefg", "abcdefgh\0", "ab\0", "ab", "abcdefgi", "abcdefg\0"};
+    size_t      len[]  = {8, 9, 7, 9, 3, 2, 8, 8};
+    valbuf_t b[8];
+    val_t v[16];
+    for (int i = 0; i < 8; i++) {
+      b[i] = valbuffrom(text[i], len[i]);
+      v[i] = val(b[i]);
+      v[i + 8] = val(b[i]);
+    }
+    tstcheck(valsort(v, 16) == 0);
+    int ok = 1;
+    for (int i = 1; i < 16; i++) ok &= (valcmp(v[i - 1], v[i]) <= 0);
+    tstcheck(ok);
+    tstcheck(valtoptr(v[0]) == b[5] && valtoptr(v[15]) == b[6]);
+    for (int i = 0; i < 8; i++) valbuffree(b[i]);
+  }
+
+  tstcase("Maps") {
+    valmap_t m = valmapnew(VALMAP_SEMANTIC);
+    valbuf_t k1 = valbuffrom("key", 3);
+    valbuf_t k2 = valbuffrom("key", 3);
+    valbuf_t z  = valbuffrom("key\0", 4);
+
+    valmapset(m, k1, 1);
+    tstcheck(valmaphas(m, k2) && valmaphas(m, "key") && valmaphas(m, valshortstr("key")));
+    tstcheck(!valmaphas(m, z));
+    valmapset(m, z, 2);
+    valmapset(m, "key", 3);
+    tstcheck(valmapcount(m) == 2);
+    tstcheck(valtoint(valmapget(m, k2)) == 3 && valtoint(valmapget(m, z)) == 2);
+
+    // The hash of the keys is not stored (lookups in concurrent maps never write)
+    tstcheck(k1->hash == 0 && k2->hash == 0 && z->hash == 0);
+    valhash(k2);
+    tstcheck(k2->hash != 0 && valtoint(valmapget(m, k2)) == 3);
+
+    valmapfree(m);
+    valbuffree(k1); valbuffree(k2); valbuffree(z);
+  }
+}
@@ -7,7 +7,60 @@
 #include <string.h>
 #include <stdint.h>
 
-#include "val.h"
+#include "valbatch.h"
+
+// The original (one character at a time) implementation
+static val_t ref_symconst(char *sym_str) {
+  val_t sym_val = {0};
+  if (sym_str == NULL || *sym_str == '\0') { sym_val.v = VAL_SYM_NULL; return sym_val; }
+
+  int shift = 0;
+  uint8_t c = 0;
+  uint64_t sym_64 = 0;
+  for (int i = 0; i < 8; i++, shift += 6) {
+    if ((c = val_ascii_to_sym[*sym_str++ & 0x7F]) == 0x3F) break;
+    sym_64 |= (((uint64_t)c) << shift);
+  }
+  sym_64 |= (VAL_SYM_NULL << shift);
+  sym_val.v = VAL_SYM_0 | (sym_64 & VAL_PAYLOAD_MASK);
+  return sym_val;
+}
+
+static valstr_t ref_symtostr(val_t v) {
+  valstr_t sym_vstr;
+  char *s_ptr = sym_vstr.str;
+  if ((((v).v & VAL_TYPE_MASK) == VAL_SYM_0)) {
+    uint64_t sym_64 = ((v).v & VAL_PAYLOAD_MASK);
+    for (int i = 0; i < 8; i++, s_ptr++) {
+      if ((*s_ptr = val_sym_to_ascii[sym_64 & 0x3F]) == '\0') break;
+      sym_64 >>= 6;
+    }
+  }
+  *s_ptr = '\0';
+  return sym_vstr;
+}
+
+static uint64_t rnd_state = 0x9E3779B97F4A7C15;
+static uint64_t rnd(void) {
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 7;
+  rnd_state ^= rnd_state << 17;
+  return rnd_state;
+}
+
+#define NSYMS 10000
+
+// Symbols known at compile time
+static const val_t sym_if = {VALSYM('i','f')};
+
+static int keyword(val_t v) {
+  switch (v.v) {
+    case VALSYM('i','f'):                 return 1;
+    case VALSYM('w','h','i','l','e'):     return 2;
+    case VALSYM('r','e','t','u','r','n'): return 3;
+    default:                              return 0;
+  }
+}
 
 
 tstsuite("Val Library syms") {
@@ -95,4 +148,90 @@ tstsuite("Val Library syms") {
       tstnote("%016" PRIX64 " sym: '%s'",sym.v,valtostr(sym).str);
     }
 
+
+    tstcase("Same encoding of the original implementation") {
+      static char strs[NSYMS][12];
+      static char *ptrs[NSYMS];
+      static val_t syms[NSYMS];
+      static valstr_t vstrs[NSYMS];
+      const char *alphabet = "!#$*+-./0123456789:<=>?@ABCDEFXYZ[]_abcdefghijklmnopqrstuvwxyz~";
+      int ok = 1;
+
+      for (int i = 0; i < NSYMS; i++) {
+        int len = (int)(rnd() % 11);
+        for (int j = 0; j < len; j++) {
+          uint64_t r = rnd();
+          // Mostly valid characters, but also any other byte
+          strs[i][j] = (r & 0x300) ? alphabet[r % 63] : (char)(1 + (r >> 16) % 255);
+        }
+        strs[i][len] = '\0';
+        ptrs[i] = strs[i];
+      }
+      ptrs[7] = NULL;
+
+      for (int i = 0; i < NSYMS; i++) ok &= (valsymconst(ptrs[i]).v == ref_symconst(ptrs[i]).v);
+      tstcheck(ok, "valsymconst()");
+
+      valsymconst_n(ptrs, NSYMS, syms);
+      ok = 1;
+      for (int i = 0; i < NSYMS; i++) ok &= (syms[i].v == ref_symconst(ptrs[i]).v);
+      tstcheck(ok, "valsymconst_n()");
+
+      // Every byte in every position
+      ok = 1;
+      for (int c = 1; c < 256; c++)
+        for (int j = 0; j < 8; j++) {
+          char buf[10] = "abcdefgh";
+          buf[j] = (char)c;
+          ok &= (valsymconst(buf).v == ref_symconst(buf).v);
+        }
+      tstcheck(ok, "All bytes");
+
+      // Mixed with other values
+      syms[3] = val(3.5); syms[10] = valnil; syms[11] = valtrue; syms[12] = valconst(5); syms[13] = val("text");
+      ok = 1;
+      for (int i = 0; i < NSYMS; i++) ok &= (strcmp(valsymtostr(syms[i]).str, ref_symtostr(syms[i]).str) == 0);
+      tstcheck(ok, "valsymtostr()");
+
+      valsymtostr_n(syms, NSYMS, vstrs);
+      ok = 1;
+      for (int i = 0; i < NSYMS; i++) ok &= (strcmp(vstrs[i].str, ref_symtostr(syms[i]).str) == 0);
+      tstcheck(ok, "valsymtostr_n()");
+    }
+
+    tstcase("Strings at the end of a page") {
+      char *page = aligned_alloc(4096, 2 * 4096);
+      tstassert(page != NULL);
+      memset(page, 'x', 2 * 4096);
+      int ok = 1;
+      for (int len = 0; len < 10; len++) {
+        char *s = page + 4096 - len - 1;
+        memcpy(s, "abcdefghij", len);
+        s[len] = '\0';
+        ok &= (valsymconst(s).v == ref_symconst(s).v);
+        s[len] = 'x';
+      }
+      tstcheck(ok);
+      free(page);
+    }
+
+    tstcase("Constant expressions") {
+      int ok = 1;
+      for (int c = 0; c < 256; c++) ok &= (VAL_SYM_CODE((char)c) == val_ascii_to_sym[c & 0x7F]);
+      tstcheck(ok, "VAL_SYM_CODE()");
+
+      tstcheck(VALSYM('h','e','l','l','o') == valsymconst("hello").v);
+      tstcheck(VALSYM('H','e','L','L','o') == valsymconst("hello").v);
+      tstcheck(VALSYM('X','Y','Z','[',']','_','~','@') == valsymconst("XYZ[]_~@").v);
+      tstcheck(VALSYM('0','1','2','3','4','5','6','7') == valsymconst("01234567").v);
+      tstcheck(VALSYM('0','1','2','3','4','5','6','7','8') == valsymconst("012345678").v);
+      tstcheck(VALSYM('a',',','b') == valsymconst("a").v);
+      tstcheck(VALSYM('\0') == VAL_SYM_NULL && VALSYM(',','a') == VAL_SYM_NULL);
+      tstcheck(VALSYM('!','#','$','*','+','-','.','/') == valsymconst("!#$*+-./").v);
+      tstcheck(VALSYM(':','<','=','>','?','A','F','G') == valsymconst(":<=>?AFG").v);
+
+      tstcheck(valeq(sym_if, valconst("if")));
+      tstcheck(keyword(valconst("if")) == 1 && keyword(valconst("while")) == 2);
+      tstcheck(keyword(valconst("return")) == 3 && keyword(valconst("else")) == 0);
+    }
 }
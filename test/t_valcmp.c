@@ -0,0 +1,112 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "valbatch.h"
+
+#define N 300
+
+static int sign(int x) { return (x > 0) - (x < 0); }
+
+static char strs[N][16];
+static int  vars[4];
+
+static val_t random_num(void) {
+  switch (rand() % 4) {
+    case 0:  return val(rand() % 100 - 50);
+    case 1:  return val((double)(rand() - RAND_MAX / 2) / (rand() % 1000 + 1));
+    case 2:  { double d[] = {0.0, -0.0, INFINITY, -INFINITY, 5e-324, 1e308}; return val(d[rand() % 6]); }
+    default: return val((int64_t)rand() << 20);
+  }
+}
+
+static val_t random_str(int i) {
+  char *s = strs[i];
+  int len = rand() % 12;
+  for (int k = 0; k < len; k++) s[k] = (rand() % 4) ? 'a' + rand() % 3 : (char)(1 + rand() % 255);
+  s[len] = '\0';
+  switch (rand() % 3) {
+    case 0:  return (len > 0 && len <= 6) ? valshortstr(s) : val(s);
+    case 1:  return (len == 0 && rand() % 2) ? val((char *)NULL) : val(s);
+    default: return val(s);
+  }
+}
+
+static val_t random_sym(int i) {
+  switch (rand() % 3) {
+    case 0:  return valsymconst(strs[i][0] ? strs[i] : "x");
+    case 1:  { val_t c[] = {valtrue, valfalse, valnil}; return c[rand() % 3]; }
+    default: return valnumconst(rand() % 10);
+  }
+}
+
+tstsuite("Specialized comparisons") {
+  srand(16);
+  static val_t v[N];
+
+  tstcase("Same result of valcmp()") {
+    int ok = 1;
+    for (int i = 0; i < N; i++) v[i] = random_num();
+    for (int i = 0; i < N; i++)
+      for (int j = 0; j < N; j++) ok &= (sign(valcmp_num(v[i], v[j])) == sign(valcmp(v[i], v[j])));
+    tstcheck(ok, "numbers");
+
+    ok = 1;
+    for (int i = 0; i < N; i++) v[i] = random_str(i);
+    for (int i = 0; i < N; i++)
+      for (int j = 0; j < N; j++) ok &= (sign(valcmp_str(v[i], v[j])) == sign(valcmp(v[i], v[j])));
+    tstcheck(ok, "strings");
+
+    ok = 1;
+    for (int i = 0; i < N; i++) { random_str(i); strs[i][8] = '\0'; v[i] = random_sym(i); }
+    for (int i = 0; i < N; i++)
+      for (int j = 0; j < N; j++) ok &= (sign(valcmp_sym(v[i], v[j])) == sign(valcmp(v[i], v[j])));
+    tstcheck(ok, "symbols");
+  }
+
+  tstcase("Edge cases") {
+    tstcheck(valcmp_num(0.0, -0.0) == 0 && valcmp_num(-1, 0.5) < 0 && valcmp_num(NAN, 1) == 0);
+    tstcheck(valcmp_str("", (char *)NULL) == 0 && valcmp_str("ab", valshortstr("abc")) < 0);
+    tstcheck(valcmp_str("\xFF", "\x7F") > 0);
+    tstcheck(valcmp_sym(valfalse, valfalse) == 0 && valcmp_sym(valfalse, valtrue) < 0);
+  }
+
+  tstcase("Homogeneous arrays") {
+    val_t a[N];
+    tstcheck(valcmpkind_n(a, 0) == VALCMP_ANY);
+
+    // Every length and every position of the odd one out
+    int ok = 1;
+    for (int n = 1; n <= 140; n++) {
+      for (int i = 0; i < n; i++) a[i] = random_num();
+      ok &= (valcmpkind_n(a, n) == VALCMP_NUM);
+      for (int i = 0; i < n; i++) a[i] = random_str(i);
+      ok &= (valcmpkind_n(a, n) == VALCMP_STR);
+      for (int i = 0; i < n; i++) a[i] = random_sym(i);
+      ok &= (valcmpkind_n(a, n) == VALCMP_SYM);
+
+      int k = rand() % n;
+      val_t odd[]  = {val(1.5), val((char *)"x"), valtrue, val(&vars[0]), val((FILE *)vars)};
+      int   kind[] = {VALCMP_NUM, VALCMP_STR, VALCMP_SYM, VALCMP_ANY, VALCMP_ANY};
+      for (int j = 0; j < 5; j++) {
+        for (int i = 0; i < n; i++) a[i] = random_num();
+        a[k] = odd[j];
+        ok &= (valcmpkind_n(a, n) == ((n == 1 || j == 0) ? kind[j] : VALCMP_ANY));
+      }
+    }
+    tstcheck(ok);
+
+    a[0] = val(NAN); a[1] = val(-0.0);
+    tstcheck(valcmpkind_n(a, 2) == VALCMP_NUM);
+    a[0] = valshortstr("abc"); a[1] = val((char *)NULL);
+    tstcheck(valcmpkind_n(a, 2) == VALCMP_STR);
+    a[0] = valnil; a[1] = val((valptr_3_t)vars);
+    tstcheck(valcmpkind_n(a, 2) == VALCMP_ANY);
+  }
+}
@@ -0,0 +1,124 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "valsort.h"
+#include "validx.h"
+
+#define N 5000
+
+static char heap[N + 1][16];
+static int  vars[4];
+
+// Strings share long prefixes so that many of them are tied on their sort key
+static val_t random_val(int i) {
+  char *s = heap[i];
+  int len = rand() % 12;
+  for (int k = 0; k < len; k++) s[k] = (k < 6 && rand() % 8) ? 'a' : 'a' + rand() % 3;
+  s[len] = '\0';
+
+  switch (rand() % 7) {
+    case 0:  return val(rand() % 100 - 50);
+    case 1:  return val((double)(rand() % 2000 - 1000) / 8);
+    case 2:  { val_t c[] = {valtrue, valfalse, valnil, valnumconst(rand() % 10)}; return c[rand() % 4]; }
+    case 3:  return val(&vars[rand() % 4]);
+    case 4:  return (len > 0 && len <= 6) ? valshortstr(s) : val(s);
+    default: return val(s);
+  }
+}
+
+static size_t lower(val_t *a, size_t n, val_t x) {
+  size_t lo = 0, hi = n;
+  while (lo < hi) { size_t mid = lo + (hi - lo) / 2; if (valcmp(a[mid], x) < 0) lo = mid + 1; else hi = mid; }
+  return lo;
+}
+
+static size_t upper(val_t *a, size_t n, val_t x) {
+  size_t lo = 0, hi = n;
+  while (lo < hi) { size_t mid = lo + (hi - lo) / 2; if (valcmp(a[mid], x) <= 0) lo = mid + 1; else hi = mid; }
+  return lo;
+}
+
+tstsuite("Search index") {
+  srand(17);
+  static val_t v[N], q[2 * N];
+  static size_t pos[2 * N];
+
+  tstcase("Empty and small") {
+    validx_t ix = validxnew(v, 0);
+    tstassert(ix != NULL);
+    tstcheck(validxcount(ix) == 0 && validxlower(ix, 1) == 0 && validxupper(ix, "a") == 0);
+    ix = validxfree(ix);
+
+    int ok = 1;
+    for (size_t n = 1; n <= 40; n++) {
+      for (size_t i = 0; i < n; i++) v[i] = val((int)(i / 2));  // Pairs of equal values
+      ix = validxnew(v, n);
+      for (int x = -1; x <= (int)n / 2 + 1; x++) {
+        size_t end, first = validxrange(ix, x, &end);
+        ok &= (first == lower(v, n, val(x))) && (end == upper(v, n, val(x)));
+      }
+      ix = validxfree(ix);
+    }
+    tstcheck(ok);
+  }
+
+  tstcase("Same result of a binary search") {
+    for (int i = 0; i < N; i++) v[i] = random_val(i);
+    valsort(v, N);
+    validx_t ix = validxnew(v, N);
+    tstassert(ix != NULL);
+    tstcheck(validxcount(ix) == N);
+
+    // Values in the array and random ones
+    for (int i = 0; i < N; i++) q[i] = v[rand() % N];
+    for (int i = N; i < 2 * N; i++) q[i] = random_val(N);
+
+    int ok = 1;
+    for (int i = 0; i < 2 * N; i++) {
+      ok &= (validxlower(ix, q[i]) == lower(v, N, q[i]));
+      ok &= (validxupper(ix, q[i]) == upper(v, N, q[i]));
+      if (!ok) { tstnote("%016" PRIX64 " at %d", q[i].v, i); break; }
+    }
+    tstcheck(ok);
+
+    // Numbers and strings not in the array
+    tstcheck(validxlower(ix, -1e300) == 0 && validxupper(ix, (valptr_2_t)vars) == N);
+    tstcheck(validxlower(ix, 0.5) == lower(v, N, val(0.5)));
+    tstcheck(validxlower(ix, (char *)"aaaaaab") == lower(v, N, val((char *)"aaaaaab")));
+
+    validxlower_n(ix, q, 2 * N, pos);
+    ok = 1;
+    for (int i = 0; i < 2 * N; i++) ok &= (pos[i] == lower(v, N, q[i]));
+    tstcheck(ok);
+
+    ix = validxfree(ix);
+  }
+
+  tstcase("Numbers only") {
+    for (int i = 0; i < N; i++) v[i] = val((double)(rand() % 1000) / 4);
+    valsort(v, N);
+    validx_t ix = validxnew(v, N);
+    int ok = 1;
+    for (int i = 0; i < N; i++) {
+      val_t x = val((double)(rand() % 1100 - 50) / 4);
+      size_t end, first = validxrange(ix, x, &end);
+      ok &= (first == lower(v, N, x)) && (end == upper(v, N, x));
+    }
+    tstcheck(ok);
+    tstcheck(validxlower(ix, -0.0) == validxlower(ix, 0));
+    ix = validxfree(ix);
+  }
+
+  tstcase("Unsorted") {
+    val_t x[] = {val(2), val(1)};
+    errno = 0;
+    tstcheck(validxnew(x, 2) == NULL && errno == EINVAL);
+  }
+}
@@ -0,0 +1,247 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "valbuf.h"
+#include "valsort.h"
+
+#define N 100000
+
+static int cmp_val(const void *a, const void *b) {
+  return valcmp(*(const val_t *)a, *(const val_t *)b);
+}
+
+static int cmp_bits(const void *a, const void *b) {
+  uint64_t x = ((const val_t *)a)->v, y = ((const val_t *)b)->v;
+  return (x > y) - (x < y);
+}
+
+static char heap[N][24];
+static int  vars[4];
+
+// Strings share long prefixes so that many of them are tied on their sort key
+static val_t random_val(int i, int kinds) {
+  char *s = heap[i];
+  int len = rand() % 20;
+  for (int k = 0; k < len; k++) s[k] = (k < 6 && rand() % 8) ? 'a' : 'a' + rand() % 3;
+  if (len > 3 && rand() % 16 == 0) s[rand() % len] = (char)(128 + rand() % 128);
+  s[len] = '\0';
+
+  switch (rand() % kinds) {
+    case 0:  return val(rand() % 100 - 50);
+    case 1:  return val((double)(rand() - RAND_MAX / 2) / (rand() % 1000 + 1));
+    case 2:  { double d[] = {0.0, -0.0, INFINITY, -INFINITY, 1e308, -1e308}; return val(d[rand() % 6]); }
+    case 3:  { val_t c[] = {valtrue, valfalse, valnil, valnumconst(rand() % 10)}; return c[rand() % 4]; }
+    case 4:  return valsymconst(len ? s : "x");
+    case 5:  return val(&vars[rand() % 4]);
+    case 6:  return (len > 0 && len <= 6) ? valshortstr(s) : val(s);
+    default: return val(s);
+  }
+}
+
+// Same values (as a multiset) and in the order of valcmp()
+static int check_sorted(val_t *v, val_t *orig, size_t n) {
+  int ok = 1;
+  for (size_t i = 1; i < n; i++) ok &= (valcmp(v[i - 1], v[i]) <= 0);
+
+  val_t *a = malloc(n * sizeof(val_t) + 1);
+  val_t *b = malloc(n * sizeof(val_t) + 1);
+  memcpy(a, v, n * sizeof(val_t));
+  memcpy(b, orig, n * sizeof(val_t));
+  qsort(a, n, sizeof(val_t), cmp_bits);
+  qsort(b, n, sizeof(val_t), cmp_bits);
+  ok &= (memcmp(a, b, n * sizeof(val_t)) == 0);
+  free(a); free(b);
+  return ok;
+}
+
+tstsuite("Radix sort") {
+  srand(14);
+  static val_t v[N], orig[N];
+
+  tstcase("Small arrays") {
+    tstcheck(valsort(v, 0) == 0);
+    v[0] = val(1);
+    tstcheck(valsort(v, 1) == 0 && valeq(v[0], val(1)));
+
+    int ok = 1;
+    for (size_t n = 2; n <= 70; n++) {
+      for (size_t i = 0; i < n; i++) orig[i] = v[i] = random_val((int)i, 8);
+      ok &= (valsort(v, n) == 0) && check_sorted(v, orig, n);
+    }
+    tstcheck(ok);
+  }
+
+  tstcase("Same order of valcmp()") {
+    for (size_t i = 0; i < N; i++) orig[i] = v[i] = random_val((int)i, 8);
+    tstcheck(valsort(v, N) == 0);
+    tstcheck(check_sorted(v, orig, N));
+
+    // Equal values are adjacent (and in the same positions of qsort's result)
+    memcpy(orig, v, sizeof(v));
+    qsort(orig, N, sizeof(val_t), cmp_val);
+    int ok = 1;
+    for (size_t i = 0; i < N; i++) ok &= (valcmp(v[i], orig[i]) == 0);
+    tstcheck(ok);
+  }
+
+  tstcase("Numbers only") {
+    for (size_t i = 0; i < N; i++) orig[i] = v[i] = random_val((int)i, 3);
+    tstcheck(valsort(v, N) == 0);
+    tstcheck(check_sorted(v, orig, N));
+
+    for (size_t i = 0; i < N; i++) orig[i] = v[i] = val(i % 7);
+    tstcheck(valsort(v, N) == 0);
+    tstcheck(check_sorted(v, orig, N) && valeq(v[0], val(0)) && valeq(v[N - 1], val(6)));
+  }
+
+  tstcase("Strings only") {
+    for (size_t i = 0; i < N; i++) {
+      random_val((int)i, 1);  // Only for the string in heap[i]
+      orig[i] = v[i] = val(heap[i]);
+    }
+    tstcheck(valsort(v, N) == 0);
+    tstcheck(check_sorted(v, orig, N));
+
+    // All the same long string
+    for (size_t i = 0; i < 1000; i++) orig[i] = v[i] = val("the same long string");
+    tstcheck(valsort(v, 1000) == 0);
+    tstcheck(check_sorted(v, orig, 1000));
+  }
+
+  tstcase("Parallel") {
+    static val_t w[N];
+    for (size_t i = 0; i < N; i++) orig[i] = v[i] = random_val((int)i, 8);
+    memcpy(w, v, sizeof(v));
+    tstcheck(valsort(w, N) == 0);
+
+    // The same order of valsort() with any number of threads
+    int threads[] = {1, 2, 3, 4, 8, 0};
+    for (int k = 0; k < 6; k++) {
+      memcpy(v, orig, sizeof(v));
+      tstcheck(valsort_mt(v, N, threads[k]) == 0);
+      tstcheck(memcmp(v, w, sizeof(v)) == 0, "threads: %d", threads[k]);
+    }
+
+    // Few different keys (most buckets are empty)
+    for (size_t i = 0; i < N; i++) orig[i] = v[i] = val(i % 3);
+    tstcheck(valsort_mt(v, N, 4) == 0);
+    tstcheck(check_sorted(v, orig, N));
+  }
+
+  tstcase("Buffers with NULs") {
+    // Short buffers with the same key, that differ only in their length
+    const char *text[] = {"a", "a\0", "a\0\0"};
+    valbuf_t b[3];
+    for (int k = 0; k < 3; k++) b[k] = valbuffrom(text[k], (size_t)k + 1);
+    for (size_t i = 0; i < 100; i++) orig[i] = v[i] = val(b[i % 3]);
+    tstcheck(valsort(v, 100) == 0);
+    tstcheck(check_sorted(v, orig, 100));
+
+    for (size_t i = 0; i < N; i++) orig[i] = v[i] = val(b[i % 3]);
+    tstcheck(valsort_mt(v, N, 4) == 0);
+    tstcheck(check_sorted(v, orig, N));
+    for (int k = 0; k < 3; k++) valbuffree(b[k]);
+  }
+
+  tstcase("Numbers and symbols on their keys") {
+    // Only numbers (with and without the values that can't be recovered from their keys)
+    for (size_t i = 0; i < N; i++) orig[i] = v[i] = val((double)(rand() - RAND_MAX / 2) / (rand() % 1000 + 1));
+    tstcheck(valsort(v, N) == 0);
+    tstcheck(check_sorted(v, orig, N));
+
+    val_t odd[] = {val(-0.0), val(NAN), val(-NAN), val(7)};
+    for (int k = 0; k < 4; k++) {
+      for (size_t i = 0; i < 1000; i++) orig[i] = v[i] = val((double)(rand() % 200 - 100));
+      orig[rand() % 1000] = odd[k];
+      memcpy(v, orig, 1000 * sizeof(val_t));
+      tstcheck(valsort(v, 1000) == 0);
+      tstcheck(check_sorted(v, orig, 1000), "k: %d", k);
+    }
+
+    // Only symbols
+    for (size_t i = 0; i < N; i++) {
+      random_val((int)i, 1);
+      heap[i][8] = '\0';
+      orig[i] = v[i] = (i % 3) ? valsymconst(heap[i][0] ? heap[i] : "x") : valnumconst(rand() % 1000);
+    }
+    tstcheck(valsort(v, N) == 0);
+    tstcheck(check_sorted(v, orig, N));
+  }
+
+  tstcase("Searching") {
+    for (size_t i = 0; i < N; i++) v[i] = random_val((int)i, 8);
+    valsort(v, N);
+
+    int ok = 1;
+    for (int k = 0; k < 2000; k++) {
+      val_t x = (k % 2) ? v[rand() % N] : random_val(N - 1, 8);
+      size_t p = valbsearch(v, N, x);
+      ok &= (p == N || valcmp(v[p], x) >= 0) && (p == 0 || valcmp(v[p - 1], x) < 0);
+    }
+    tstcheck(ok, "mixed");
+
+    // Numbers only and strings only
+    for (size_t i = 0; i < N; i++) v[i] = val((double)(rand() % 5000) / 4);
+    valsort(v, N);
+    ok = 1;
+    for (int k = 0; k < 2000; k++) {
+      val_t x = val((double)(rand() % 6000 - 500) / 4);
+      size_t p = valbsearch(v, N, x);
+      ok &= (p == N || valcmp(v[p], x) >= 0) && (p == 0 || valcmp(v[p - 1], x) < 0);
+    }
+    tstcheck(ok, "numbers");
+    tstcheck(valbsearch(v, N, -1e300) == 0 && valbsearch(v, N, 1e300) == N && valbsearch(v, N, "a") == N);
+
+    for (size_t i = 0; i < N; i++) { random_val((int)i, 1); v[i] = val(heap[i]); }
+    valsort(v, N);
+    ok = 1;
+    for (int k = 0; k < 2000; k++) {
+      val_t x = (k % 2) ? v[rand() % N] : val((char *)"ab");
+      size_t p = valbsearch(v, N, x);
+      ok &= (p == N || valcmp(v[p], x) >= 0) && (p == 0 || valcmp(v[p - 1], x) < 0);
+    }
+    tstcheck(ok, "strings");
+    tstcheck(valbsearch(v, N, 1) == 0 && valbsearch(v, N, valnil) == 0);
+
+    tstcheck(valbsearch(v, 0, 1) == 0);
+  }
+
+  tstcase("Minimum and maximum") {
+    tstcheck(valmin_n(v, 0) == 0 && valmax_n(v, 0) == 0);
+
+    int kinds[] = {8, 3, 1};
+    for (int k = 0; k < 3; k++) {
+      size_t n = 1 + (size_t)rand() % 1000;
+      for (size_t i = 0; i < n; i++) v[i] = random_val((int)i, kinds[k]);
+
+      size_t mn = 0, mx = 0;
+      for (size_t i = 1; i < n; i++) {
+        if (valcmp(v[i], v[mn]) < 0) mn = i;
+        if (valcmp(v[i], v[mx]) > 0) mx = i;
+      }
+      tstcheck(valmin_n(v, n) == mn && valmax_n(v, n) == mx, "kinds: %d", kinds[k]);
+    }
+
+    // The first of equal values
+    val_t x[] = {val(3), val(1), val(3), val(1.0)};
+    tstcheck(valmin_n(x, 4) == 1 && valmax_n(x, 4) == 0);
+
+    // NaNs are after +inf (as in valsort())
+    val_t y[] = {val(1), val(NAN), val(INFINITY), val(-2)};
+    tstcheck(valmin_n(y, 4) == 3 && valmax_n(y, 4) == 1);
+  }
+
+  tstcase("NaN") {
+    val_t x[] = {val(NAN), val(1), val(INFINITY), valnil, val(-1), val("a")};
+    tstcheck(valsort(x, 6) == 0);
+    tstcheck(valeq(x[0], val(-1)) && valeq(x[1], val(1)) && valeq(x[2], val(INFINITY)));
+    tstcheck(isnan(valtodouble(x[3])) && valisnil(x[4]));
+  }
+}
@@ -0,0 +1,153 @@
+//  SPDX-FileCopyrightText: © 2025 Remo Dentato (rdentato@gmail.com)
+//  SPDX-License-Identifier: MIT
+
+#include "tst.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "valvec.h"
+
+tstsuite("Vectors") {
+  tstcase("Push, pop, get and set") {
+    valvec_t vec = valvecnew(0);
+    tstassert(vec != NULL);
+    tstcheck(valveclen(vec) == 0 && valveckind(vec) == VALCMP_ANY);
+    tstcheck(valisnil(valvecpop(vec)));
+
+    int ok = 1;
+    for (int i = 0; i < 1000; i++) ok &= (valvecpush(vec, i) == 0);
+    tstcheck(ok && valveclen(vec) == 1000 && vec->cap >= 1000);
+    for (int i = 0; i < 1000; i++) ok &= valeq(valvecget(vec, i), i);
+    tstcheck(ok);
+    tstcheck(valisnil(valvecget(vec, 1000)));
+
+    tstcheck(valvecset(vec, 10, -1) == 0 && valeq(valvecget(vec, 10), -1));
+    errno = 0;
+    tstcheck(valvecset(vec, 1000, 1) == -1 && errno == EINVAL);
+
+    tstcheck(valeq(valvecpop(vec), 999) && valveclen(vec) == 999);
+
+    tstcheck(valvecshrink(vec) == 0 && vec->cap == 999);
+    tstcheck(valvecreserve(vec, 5000) == 0 && vec->cap == 5000 && valveclen(vec) == 999);
+    tstcheck(valeq(valvecget(vec, 998), 998));
+
+    valvecclear(vec);
+    tstcheck(valveclen(vec) == 0 && vec->cap == 5000);
+    tstcheck(valvecshrink(vec) == 0 && vec->cap == 0);
+
+    vec = valvecfree(vec);
+    tstcheck(vec == NULL);
+  }
+
+  tstcase("Bulk append") {
+    int    ints[100];
+    double dbls[100];
+    char  *strs[100];
+    char   text[100][8];
+    for (int i = 0; i < 100; i++) {
+      ints[i] = i - 50;
+      dbls[i] = i * 0.5;
+      snprintf(text[i], sizeof(text[i]), "s%02d", i);
+      strs[i] = text[i];
+    }
+
+    valvec_t vec = valvecnew(10);
+    tstcheck(valvecappendint(vec, ints, 100) == 0);
+    int ok = 1;
+    for (int i = 0; i < 100; i++) ok &= valeq(vec->v[i], i - 50) && valtoint(vec->v[i]) == i - 50;
+    tstcheck(ok);
+#ifdef VALNATIVEINT
+    tstcheck(val_is_int32(vec->v[0]));
+#endif
+
+    tstcheck(valvecappenddouble(vec, dbls, 100) == 0);
+    for (int i = 0; i < 100; i++) ok &= (valtodouble(vec->v[100 + i]) == i * 0.5);
+    tstcheck(ok && valveclen(vec) == 200);
+    tstcheck(valveckind(vec) == VALCMP_NUM);
+
+    valvecclear(vec);
+    tstcheck(valvecappendstr(vec, strs, 100) == 0);
+    for (int i = 0; i < 100; i++) ok &= valischarptr(vec->v[i]) && valtoptr(vec->v[i]) == strs[i];
+    tstcheck(ok);
+    tstcheck(valveckind(vec) == VALCMP_STR);
+
+    // Appending a copy of itself (growing the vector first)
+    valvec_t cp = valvecnew(0);
+    tstcheck(valvecappend(cp, vec->v, valveclen(vec)) == 0 && valveclen(cp) == 100);
+    tstcheck(valveckind(cp) == VALCMP_STR);
+    tstcheck(valvecappend(cp, NULL, 0) == 0 && valveclen(cp) == 100);
+
+    valvecfree(cp);
+    valvecfree(vec);
+  }
+
+  tstcase("Kind of the values") {
+    valvec_t vec = valvecnew(0);
+    valvecpush(vec, 1);
+    valvecpush(vec, 2.5);
+    tstcheck(valveckind(vec) == VALCMP_NUM);
+    valvecpush(vec, "x");
+    tstcheck(valveckind(vec) == VALCMP_ANY);
+
+    // The kind is kept after the value is removed until the vector is rescanned
+    valvecpop(vec);
+    tstcheck(valveckind(vec) == VALCMP_ANY);
+    valvecrescan(vec);
+    tstcheck(valveckind(vec) == VALCMP_NUM);
+
+    valvecclear(vec);
+    valvecpush(vec, valtrue);
+    valvecpush(vec, valnil);
+    tstcheck(valveckind(vec) == VALCMP_SYM);
+    valvecpush(vec, (void *)vec);
+    tstcheck(valveckind(vec) == VALCMP_ANY);
+    valvecset(vec, 2, valfalse);
+    valvecrescan(vec);
+    tstcheck(valveckind(vec) == VALCMP_SYM);
+
+    // Same kind of `valcmpkind_n()`
+    val_t mixed[] = {val(1), val("a"), valnil, val(vec)};
+    int same = 1;
+    for (int i = 0; i < 4; i++) {
+      valvecclear(vec);
+      valvecpush(vec, mixed[i]);
+      same &= (valveckind(vec) == valcmpkind_n(&mixed[i], 1));
+    }
+    tstcheck(same);
+
+    valvecfree(vec);
+  }
+
+  tstcase("Sum and sort") {
+    int ints[1000];
+    for (int i = 0; i < 1000; i++) ints[i] = (i * 7919) % 1000 - 500;
+
+    valvec_t vec = valvecnew(0);
+    valvecappendint(vec, ints, 1000);
+    tstcheck(valvecsum(vec) == -500.0, "sum: %f", valvecsum(vec));
+    valvecpush(vec, 0.5);
+    tstcheck(valvecsum(vec) == -499.5);
+    valvecpush(vec, "100");   // Not a number: skipped
+    tstcheck(valvecsum(vec) == -499.5);
+
+    valvecpop(vec);
+    tstcheck(valvecsort(vec) == 0);
+    tstcheck(valveckind(vec) == VALCMP_NUM);   // Found scanning the values
+    int ok = 1;
+    for (size_t i = 1; i < valveclen(vec); i++) ok &= (valcmp(vec->v[i - 1], vec->v[i]) <= 0);
+    tstcheck(ok);
+    tstcheck(valeq(vec->v[0], -500) && valeq(vec->v[1000], 499));
+
+    char *strs[] = {"pear", "apple", "fig", "banana"};
+    valvecclear(vec);
+    for (int i = 0; i < 20; i++) valvecappendstr(vec, strs, 4);
+    valvecpush(vec, 3);
+    tstcheck(valvecsort(vec) == 0);
+    tstcheck(valeq(vec->v[0], 3) && strcmp(valtoptr(vec->v[1]), "apple") == 0);
+    tstcheck(strcmp(valtoptr(vec->v[80]), "pear") == 0);
+
+    valvecfree(vec);
+  }
+}